@@ -519,6 +519,12 @@ static int asrc_trigger(struct processing_module *mod, int cmd)
 		}
 
 		cd->ts_count = 0;
+#if CONFIG_COMP_ASRC_DRIFT_PI
+		cd->skew_integ = 0;
+		cd->block_ts = 0;
+		cd->block_samples = 0;
+		cd->block_count = 0;
+#endif
 		ret = asrc_dai_configure_timestamp(cd);
 		if (ret) {
 			comp_err(dev, "No timestamp capability in DAI");
@@ -718,7 +724,9 @@ static int asrc_control_loop(struct comp_dev *dev, struct comp_data *cd)
 #else
 	struct timestamp_data tsd;
 #endif
+#if !CONFIG_COMP_ASRC_DRIFT_PI
 	int64_t tmp;
+#endif
 	int32_t delta_sample;
 	int32_t delta_ts;
 	int32_t sample;
@@ -757,6 +765,20 @@ static int asrc_control_loop(struct comp_dev *dev, struct comp_data *cd)
 		return 0;
 	}
 
+#if CONFIG_COMP_ASRC_DRIFT_PI
+	/* Measure over a block of periods, update once per block */
+	cd->block_ts += delta_ts;
+	cd->block_samples += delta_sample;
+	if (++cd->block_count < ASRC_DRIFT_BLOCK_PERIODS)
+		return 0;
+
+	delta_ts = cd->block_ts;
+	delta_sample = cd->block_samples;
+	cd->block_ts = 0;
+	cd->block_samples = 0;
+	cd->block_count = 0;
+#endif
+
 	/* Prevent divide by zero */
 	if (delta_sample == 0 || tsd.walclk_rate == 0) {
 		comp_err(dev, "asrc_control_loop(), DAI timestamp failed");
@@ -767,13 +789,17 @@ static int asrc_control_loop(struct comp_dev *dev, struct comp_data *cd)
 	 * fraction f_cd_fs is Q1.31
 	 * drift needs to be Q2.30
 	 */
-	f_ds_dt = (delta_ts << 12) / delta_sample;
+	f_ds_dt = ((int64_t)delta_ts << 12) / delta_sample;
 	f_ck_fs = ((int64_t)cd->asrc_obj->fs_sec << 31) / tsd.walclk_rate;
 	skew = q_multsr_sat_32x32(f_ds_dt, f_ck_fs, 13);
 
+#if CONFIG_COMP_ASRC_DRIFT_PI
+	cd->skew = asrc_drift_pi(cd, skew);
+#else
 	/* tmp is Q4.60, shift and round to Q2.30 */
 	tmp = ((int64_t)COEF_C1) * skew + ((int64_t)COEF_C2) * cd->skew;
 	cd->skew = sat_int32(Q_SHIFT_RND(tmp, 60, 30));
+#endif
 	asrc_update_drift(dev, cd->asrc_obj, cd->skew);
 
 	/* Track skew variation, it helps to analyze possible problems
@@ -8,6 +8,7 @@
 
 #include <sof/audio/module_adapter/module/generic.h>
 #include <sof/audio/audio_stream.h>
+#include <sof/audio/format.h>
 #include <sof/audio/component.h>
 #include "asrc_farrow.h"
 
@@ -81,6 +82,17 @@ int asrc_dai_get_timestamp(struct comp_data *cd, struct timestamp_data *tsd);
 #define COEF_C1		Q_CONVERT_FLOAT(0.01, 30)
 #define COEF_C2		Q_CONVERT_FLOAT(0.99, 30)
 
+/* Block based drift tracker: number of periods measured per update,
+ * proportional and integral gains, and the integral term limit. The
+ * gains place both poles of the loop near 0.93. A drift step settles
+ * within 2 % in some 85 blocks, after the integral part has overshot
+ * it once by some 14 %.
+ */
+#define ASRC_DRIFT_BLOCK_PERIODS	8
+#define ASRC_DRIFT_KP		Q_CONVERT_FLOAT(0.125, 30)
+#define ASRC_DRIFT_KI		Q_CONVERT_FLOAT(0.00390625, 30)
+#define ASRC_DRIFT_INTEG_MAX	Q_CONVERT_FLOAT(0.0001, 30)
+
 typedef void (*asrc_proc_func)(struct processing_module *mod,
 			       const struct audio_stream *source,
 			       struct audio_stream *sink,
@@ -104,6 +116,12 @@ struct comp_data {
 	int32_t skew_min;
 	int32_t skew_max;
 	int ts_count;
+#if CONFIG_COMP_ASRC_DRIFT_PI
+	int32_t skew_integ;	/* Integral term of drift tracker in Q2.30 */
+	int32_t block_ts;	/* Wall clock ticks in current block */
+	int32_t block_samples;	/* DAI samples in current block */
+	int block_count;	/* Periods in current block */
+#endif
 	int asrc_size;		/* ASRC object size */
 	int buf_size;		/* Samples buffer size */
 	int frames;		/* IO buffer length */
@@ -119,6 +137,23 @@ struct comp_data {
 	asrc_proc_func asrc_func;		/* ASRC processing function */
 };
 
+#if CONFIG_COMP_ASRC_DRIFT_PI
+/* Proportional part smooths the measurement noise, integral part follows
+ * a drift rate that changes over time. Returns the new skew in Q2.30.
+ */
+static inline int32_t asrc_drift_pi(struct comp_data *cd, int32_t skew)
+{
+	int64_t err = (int64_t)skew - cd->skew;
+	int64_t integ;
+
+	integ = cd->skew_integ + Q_MULTSR_32X32(err, ASRC_DRIFT_KI, 30, 30, 30);
+	cd->skew_integ = MIN(MAX(integ, -ASRC_DRIFT_INTEG_MAX), ASRC_DRIFT_INTEG_MAX);
+
+	return sat_int32(cd->skew + Q_MULTSR_32X32(err, ASRC_DRIFT_KP, 30, 30, 30) +
+			 cd->skew_integ);
+}
+#endif
+
 int asrc_dai_configure_timestamp(struct comp_data *cd);
 int asrc_dai_start_timestamp(struct comp_data *cd);
 int asrc_dai_stop_timestamp(struct comp_data *cd);
@@ -14,11 +14,12 @@ LOG_MODULE_DECLARE(asrc, CONFIG_SOF_LOG_LEVEL);
 void asrc_fir_filter16(struct asrc_farrow *src_obj, int16_t **output_buffers,
 		       int index_output_frame)
 {
-	int64_t prod;
+	int64_t prod, prod2;
 	int32_t prod32;
 	int16_t prod16;
 	int32_t *filter_p;
-	int16_t *buffer_p;
+	int16_t *buffer_p, *buffer2_p;
+	int32_t coef;
 	int ch;
 	int n;
 	int i;
@@ -28,8 +29,30 @@ void asrc_fir_filter16(struct asrc_farrow *src_obj, int16_t **output_buffers,
 	else
 		i = index_output_frame;
 
-	/* Iterate over each channel */
-	for (ch = 0; ch < src_obj->num_channels; ch++) {
+	/* Filter channel pairs, each coefficient is loaded once for both
+	 * channels and the two accumulators map to SIMD lanes. Data is
+	 * Q1.15, coefficients are Q1.30, products are Qx.45.
+	 */
+	for (ch = 0; ch + 1 < src_obj->num_channels; ch += 2) {
+		filter_p = &src_obj->impulse_response[0];
+		buffer_p = &src_obj->ring_buffers16[ch][src_obj->buffer_write_position];
+		buffer2_p = &src_obj->ring_buffers16[ch + 1][src_obj->buffer_write_position];
+		prod = 0;
+		prod2 = 0;
+		for (n = 0; n < src_obj->filter_length; n++) {
+			coef = *filter_p++;
+			prod += (int64_t)(*buffer_p++) * coef;
+			prod2 += (int64_t)(*buffer2_p++) * coef;
+		}
+
+		prod32 = sat_int32(Q_SHIFT(prod, 45, 31));
+		output_buffers[ch][i] = sat_int16(Q_SHIFT_RND(prod32, 31, 15));
+		prod32 = sat_int32(Q_SHIFT(prod2, 45, 31));
+		output_buffers[ch + 1][i] = sat_int16(Q_SHIFT_RND(prod32, 31, 15));
+	}
+
+	/* Remaining odd channel */
+	for (; ch < src_obj->num_channels; ch++) {
 		/* Pointer to the beginning of the impulse response */
 		filter_p = &src_obj->impulse_response[0];
 
@@ -63,10 +86,11 @@ void asrc_fir_filter16(struct asrc_farrow *src_obj, int16_t **output_buffers,
 void asrc_fir_filter32(struct asrc_farrow *src_obj, int32_t **output_buffers,
 		       int index_output_frame)
 {
-	int64_t prod;
+	int64_t prod, prod2;
 	int32_t prod32;
 	const int32_t *filter_p;
-	int32_t *buffer_p;
+	int32_t *buffer_p, *buffer2_p;
+	int32_t coef;
 	int ch;
 	int n;
 	int i;
@@ -76,8 +100,28 @@ void asrc_fir_filter32(struct asrc_farrow *src_obj, int32_t **output_buffers,
 	else
 		i = index_output_frame;
 
-	/* Iterate over each channel */
-	for (ch = 0; ch < src_obj->num_channels; ch++) {
+	/* Filter channel pairs, each coefficient is loaded and scaled once
+	 * for both channels and the two accumulators map to SIMD lanes. The
+	 * arithmetic is the same as in the single channel loop below.
+	 */
+	for (ch = 0; ch + 1 < src_obj->num_channels; ch += 2) {
+		filter_p = &src_obj->impulse_response[0];
+		buffer_p = &src_obj->ring_buffers32[ch][src_obj->buffer_write_position];
+		buffer2_p = &src_obj->ring_buffers32[ch + 1][src_obj->buffer_write_position];
+		prod = 0;
+		prod2 = 0;
+		for (n = 0; n < src_obj->filter_length; n++) {
+			coef = *filter_p++ >> 8;
+			prod += (int64_t)(*buffer_p++) * coef;
+			prod2 += (int64_t)(*buffer2_p++) * coef;
+		}
+
+		output_buffers[ch][i] = sat_int32(Q_SHIFT(prod, 53, 31));
+		output_buffers[ch + 1][i] = sat_int32(Q_SHIFT(prod2, 53, 31));
+	}
+
+	/* Remaining odd channel */
+	for (; ch < src_obj->num_channels; ch++) {
 		/* Pointer to the beginning of the impulse response */
 		filter_p = &src_obj->impulse_response[0];
 
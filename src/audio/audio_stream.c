@@ -54,3 +54,36 @@ void audio_stream_init(struct audio_stream *audio_stream, void *buff_addr, uint3
 	audio_stream_set_align(1, 1, audio_stream);
 	audio_stream_reset(audio_stream);
 }
+
+#if CONFIG_COMP_BUFFER_IN_PLACE
+void audio_stream_alias_sync(struct audio_stream *stream)
+{
+	struct audio_stream *first = stream;
+	struct audio_stream *next;
+	struct audio_stream *s;
+	uint32_t used = 0;
+	int32_t ahead;
+
+	while (first->alias_prev)
+		first = first->alias_prev;
+
+	for (s = first; s; s = s->alias_next)
+		used += s->avail;
+
+	/* the first stream may only be written where no stream holds data */
+	first->free = first->size - MIN(used, first->size);
+
+	/*
+	 * a following stream is written over the data of its predecessor: all
+	 * the available data and the data already read but not yet written over
+	 */
+	for (s = first; s->alias_next; s = next) {
+		next = s->alias_next;
+		ahead = (char *)s->r_ptr - (char *)next->w_ptr;
+		if (ahead < 0)
+			ahead += s->size;
+
+		next->free = MIN(s->avail + ahead, next->size - next->avail);
+	}
+}
+#endif
@@ -136,6 +136,38 @@ static void comp_buffer_reset(struct sof_audio_buffer *audio_buffer)
 	buffer_zero(buffer);
 }
 
+#if CONFIG_COMP_BUFFER_IN_PLACE
+/*
+ * Remove a buffer from its alias chain. Returns true if the stream memory is
+ * still used by other buffers of the chain, which then take over its ownership.
+ */
+static bool buffer_alias_detach(struct comp_buffer *buffer)
+{
+	struct audio_stream *stream = &buffer->stream;
+	struct audio_stream *prev = stream->alias_prev;
+	struct audio_stream *next = stream->alias_next;
+
+	if (!prev && !next)
+		return false;
+
+	if (prev)
+		prev->alias_next = next;
+	if (next)
+		next->alias_prev = prev;
+
+	stream->alias_prev = NULL;
+	stream->alias_next = NULL;
+
+	/* the rest of the chain takes over the space of the detached stream */
+	if (prev)
+		audio_stream_alias_sync(prev);
+	if (next)
+		audio_stream_alias_sync(next);
+
+	return true;
+}
+#endif
+
 /* free component in the pipeline */
 static void comp_buffer_free(struct sof_audio_buffer *audio_buffer)
 {
@@ -158,6 +190,13 @@ static void comp_buffer_free(struct sof_audio_buffer *audio_buffer)
 	/* In case some listeners didn't unregister from buffer's callbacks */
 	notifier_unregister_all(NULL, buffer);
 
+#if CONFIG_COMP_BUFFER_IN_PLACE
+	/* memory of an aliased buffer is owned by the first buffer of its chain */
+	if (buffer_alias_detach(buffer)) {
+		rfree(buffer);
+		return;
+	}
+#endif
 	rfree(buffer->stream.addr);
 	rfree(buffer);
 }
@@ -312,6 +351,153 @@ void buffer_zero(struct comp_buffer *buffer)
 					   audio_stream_get_size(&buffer->stream));
 }
 
+uint32_t buffer_placement_flags(uint32_t flags, uint32_t source_core, uint32_t sink_core,
+				uint32_t period_us, enum buffer_placement *placement)
+{
+	/* DMA buffers must stay where the hardware can reach them */
+	if (flags & SOF_MEM_FLAG_DMA) {
+		*placement = BUFFER_PLACEMENT_REQUESTED;
+		return flags;
+	}
+
+	/* cross core buffers are kept coherent by buffer_alloc_struct() */
+	if (source_core != sink_core) {
+		*placement = BUFFER_PLACEMENT_SHARED;
+		return flags;
+	}
+
+	/*
+	 * Same core and a short period: the buffer is written and read every
+	 * few milliseconds, keep it in cached near memory.
+	 */
+	if (period_us && period_us <= CONFIG_COMP_BUFFER_HOT_PERIOD_US) {
+		*placement = BUFFER_PLACEMENT_LOCAL;
+		return flags & ~(SOF_MEM_FLAG_L3 | SOF_MEM_FLAG_LOW_POWER);
+	}
+
+	*placement = BUFFER_PLACEMENT_REQUESTED;
+	return flags;
+}
+
+int buffer_place(struct comp_buffer *buffer, uint32_t source_core, uint32_t sink_core,
+		 uint32_t period_us)
+{
+	enum buffer_placement placement;
+	void *new_ptr;
+	uint32_t flags;
+	size_t size = audio_stream_get_size(&buffer->stream);
+
+	CORE_CHECK_STRUCT(&buffer->audio_buffer);
+
+	flags = buffer_placement_flags(buffer->flags, source_core, sink_core, period_us,
+				       &placement);
+	if (flags != buffer->flags) {
+		new_ptr = rballoc_align(flags, size, PLATFORM_DCACHE_ALIGN);
+		if (!new_ptr) {
+			/* not fatal, the buffer works from its current memory */
+			buf_warn(buffer, "no memory for placement %u, keeping flags 0x%x",
+				 placement, buffer->flags);
+			buffer->placement = BUFFER_PLACEMENT_REQUESTED;
+			return 0;
+		}
+
+		rfree(audio_stream_get_addr(&buffer->stream));
+		audio_stream_set_addr(&buffer->stream, new_ptr);
+		buffer_init_stream(buffer, size);
+		buffer->flags = flags;
+	}
+
+	buffer->placement = placement;
+	buf_dbg(buffer, "placement %u flags 0x%x cores %u -> %u period %u us",
+		placement, buffer->flags, source_core, sink_core, period_us);
+
+	return 0;
+}
+
+#if CONFIG_COMP_BUFFER_IN_PLACE
+/* move a stream and all streams aliased behind it to new memory */
+static void buffer_alias_rebase(struct audio_stream *stream, void *addr, uint32_t size)
+{
+	for (; stream; stream = stream->alias_next) {
+		stream->addr = addr;
+		stream->end_addr = (char *)addr + size;
+		stream->size = size;
+		audio_stream_reset(stream);
+	}
+}
+
+static bool buffer_can_alias(struct comp_buffer *buffer)
+{
+	return !audio_buffer_is_shared(&buffer->audio_buffer) &&
+	       !(buffer->flags & SOF_MEM_FLAG_DMA) &&
+	       !audio_stream_get_underrun(&buffer->stream) &&
+	       !audio_stream_get_overrun(&buffer->stream);
+}
+
+int buffer_alias(struct comp_buffer *source, struct comp_buffer *sink)
+{
+	struct audio_stream *in = &source->stream;
+	struct audio_stream *out = &sink->stream;
+
+	CORE_CHECK_STRUCT(&source->audio_buffer);
+	CORE_CHECK_STRUCT(&sink->audio_buffer);
+
+	if (out->alias_prev == in)
+		return 0;
+
+	if (out->alias_prev || (in->alias_next && in->alias_next != out))
+		return -EBUSY;
+
+	if (!buffer_can_alias(source) || !buffer_can_alias(sink) ||
+	    audio_stream_get_size(out) > audio_stream_get_size(in))
+		return -EINVAL;
+
+	/* samples must be written exactly where they are read */
+	if (audio_stream_get_frm_fmt(in) != audio_stream_get_frm_fmt(out) ||
+	    audio_stream_get_valid_fmt(in) != audio_stream_get_valid_fmt(out) ||
+	    audio_stream_get_channels(in) != audio_stream_get_channels(out) ||
+	    audio_stream_get_rate(in) != audio_stream_get_rate(out))
+		return -EINVAL;
+
+	rfree(audio_stream_get_addr(out));
+
+	out->alias_prev = in;
+	in->alias_next = out;
+	buffer_alias_rebase(in, audio_stream_get_addr(in), audio_stream_get_size(in));
+
+	buf_info(sink, "aliased in place onto buffer %#x, %u bytes saved", buf_get_id(source),
+		 audio_stream_get_size(out));
+
+	return 0;
+}
+
+int buffer_unalias(struct comp_buffer *buffer)
+{
+	struct audio_stream *stream = &buffer->stream;
+	struct audio_stream *prev = stream->alias_prev;
+	size_t size = audio_stream_get_size(stream);
+	void *new_ptr;
+
+	CORE_CHECK_STRUCT(&buffer->audio_buffer);
+
+	if (!prev)
+		return 0;
+
+	new_ptr = rballoc_align(buffer->flags, size, PLATFORM_DCACHE_ALIGN);
+	if (!new_ptr) {
+		buf_err(buffer, "can't alloc %zu bytes to end in-place aliasing", size);
+		return -ENOMEM;
+	}
+
+	prev->alias_next = NULL;
+	stream->alias_prev = NULL;
+	buffer_alias_rebase(stream, new_ptr, size);
+	audio_stream_alias_sync(prev);
+
+	return 0;
+}
+#endif
+
 int buffer_set_size(struct comp_buffer *buffer, uint32_t size, uint32_t alignment)
 {
 	void *new_ptr = NULL;
@@ -327,6 +513,13 @@ int buffer_set_size(struct comp_buffer *buffer, uint32_t size, uint32_t alignmen
 	if (size == audio_stream_get_size(&buffer->stream))
 		return 0;
 
+#if CONFIG_COMP_BUFFER_IN_PLACE
+	if (buffer->stream.alias_prev || buffer->stream.alias_next) {
+		buf_err(buffer, "can't resize a buffer aliased for in-place processing");
+		return -EBUSY;
+	}
+#endif
+
 	if (!alignment)
 		new_ptr = rbrealloc(audio_stream_get_addr(&buffer->stream),
 				    buffer->flags | SOF_MEM_FLAG_NO_COPY,
@@ -375,6 +568,13 @@ int buffer_set_size_range(struct comp_buffer *buffer, size_t preferred_size, siz
 	if (preferred_size == actual_size)
 		return 0;
 
+#if CONFIG_COMP_BUFFER_IN_PLACE
+	if (buffer->stream.alias_prev || buffer->stream.alias_next) {
+		buf_err(buffer, "can't resize a buffer aliased for in-place processing");
+		return -EBUSY;
+	}
+#endif
+
 	if (!alignment) {
 		for (new_size = preferred_size; new_size >= minimum_size;
 		     new_size -= minimum_size) {
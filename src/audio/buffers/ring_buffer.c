@@ -9,6 +9,7 @@
 
 #include <sof/audio/ring_buffer.h>
 #include <sof/audio/component.h>
+#include <sof/audio/module_adapter/module/generic.h>
 
 #include <rtos/alloc.h>
 #include <ipc/topology.h>
@@ -243,7 +244,7 @@ static int ring_buffer_release_data(struct sof_source *source, size_t free_size)
 	return 0;
 }
 
-int ring_buffer_module_unbind(struct sof_sink *sink)
+static int ring_buffer_module_unbind(struct sof_sink *sink)
 {
 	struct ring_buffer *ring_buffer = ring_buffer_from_sink(sink);
 
@@ -357,6 +358,16 @@ struct ring_buffer *ring_buffer_create(struct comp_dev *dev, size_t min_availabl
 	 */
 	ring_buffer->data_buffer_size = 3 * max_ibs_obs;
 
+#if CONFIG_ZEPHYR_DP_SCHEDULER
+	/* A batch-processing DP module waits for a whole batch to be queued, while the LL side
+	 * keeps producing and consuming single periods. Keep the above margin on top of it.
+	 */
+	struct processing_module *mod = comp_mod(dev);
+
+	if (mod->dp_batch_periods > 1)
+		ring_buffer->data_buffer_size = (mod->dp_batch_periods + 2) * max_ibs_obs;
+#endif
+
 	/* allocate data buffer - always in cached memory alias */
 	ring_buffer->data_buffer_size =
 			ALIGN_UP(ring_buffer->data_buffer_size, PLATFORM_DCACHE_ALIGN);
@@ -0,0 +1,428 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2026 Intel Corporation. All rights reserved.
+
+#include <rtos/string.h>
+#include <rtos/symbol.h>
+#include <sof/audio/audio_stream.h>
+#include <sof/audio/channel_remix.h>
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Rounds a Q10 weighted sum to the sample format */
+#define REMIX_ROUND(acc) (((acc) + (1 << (CHANNEL_REMIX_Q_SHIFT - 1))) >> CHANNEL_REMIX_Q_SHIFT)
+
+static void remix_set_pick_shape(struct channel_remix *remix)
+{
+	int ch;
+
+	remix->shape = CHANNEL_REMIX_PICK;
+	if (remix->sink_channels != remix->source_channels)
+		return;
+
+	for (ch = 0; ch < remix->sink_channels; ch++)
+		if (remix->pick[ch] != ch)
+			return;
+
+	remix->shape = CHANNEL_REMIX_COPY;
+}
+
+int channel_remix_build(struct channel_remix *remix, const int16_t *coeffs, int stride,
+			int sink_channels, int source_channels)
+{
+	const int16_t *row;
+	bool pick = true;
+	int taps = 0;
+	int ch, j, n;
+
+	if (sink_channels < 1 || sink_channels > CHANNEL_REMIX_SINK_MAX ||
+	    source_channels < 1 || source_channels > CHANNEL_REMIX_SOURCE_MAX)
+		return -EINVAL;
+
+	remix->source_channels = source_channels;
+	remix->sink_channels = sink_channels;
+	remix->coeffs = coeffs;
+	remix->coeffs_stride = stride;
+
+	for (ch = 0; ch < sink_channels; ch++) {
+		row = coeffs + ch * stride;
+		remix->pick[ch] = CHANNEL_REMIX_SILENT;
+		n = 0;
+		for (j = 0; j < source_channels; j++) {
+			if (!row[j])
+				continue;
+
+			if (row[j] == CHANNEL_REMIX_UNITY)
+				remix->pick[ch] = j;
+
+			if (taps + n < CHANNEL_REMIX_TAPS_MAX) {
+				remix->taps[taps + n].channel = j;
+				remix->taps[taps + n].coeff = row[j];
+			}
+			n++;
+		}
+
+		/* a pick row has at most one coefficient and it is unity */
+		if (n > 1 || (n == 1 && remix->pick[ch] == CHANNEL_REMIX_SILENT))
+			pick = false;
+
+		remix->num_taps[ch] = n;
+		taps += n;
+	}
+
+	if (pick)
+		remix_set_pick_shape(remix);
+	else if (sink_channels == 1 && taps == 2)
+		remix->shape = CHANNEL_REMIX_DOWNMIX2;
+	else if (taps <= CHANNEL_REMIX_TAPS_MAX)
+		remix->shape = CHANNEL_REMIX_SPARSE;
+	else
+		remix->shape = CHANNEL_REMIX_DENSE;
+
+	return 0;
+}
+EXPORT_SYMBOL(channel_remix_build);
+
+int channel_remix_build_chmap(struct channel_remix *remix, uint32_t chmap,
+			      int sink_channels, int source_channels)
+{
+	int ch, j;
+
+	if (sink_channels < 1 || sink_channels > CHANNEL_REMIX_SINK_MAX ||
+	    source_channels < 1 || source_channels > CHANNEL_REMIX_SOURCE_MAX)
+		return -EINVAL;
+
+	remix->source_channels = source_channels;
+	remix->sink_channels = sink_channels;
+	remix->coeffs = NULL;
+	remix->coeffs_stride = 0;
+
+	for (ch = 0; ch < sink_channels; ch++) {
+		j = chmap & 0xf;
+		chmap >>= 4;
+
+		if (j == 0xf) {
+			remix->pick[ch] = CHANNEL_REMIX_SILENT;
+			remix->num_taps[ch] = 0;
+			continue;
+		}
+
+		if (j >= source_channels)
+			return -EINVAL;
+
+		remix->pick[ch] = j;
+		remix->num_taps[ch] = 1;
+		remix->taps[ch].channel = j;
+		remix->taps[ch].coeff = CHANNEL_REMIX_UNITY;
+	}
+
+	remix_set_pick_shape(remix);
+
+	return 0;
+}
+EXPORT_SYMBOL(channel_remix_build_chmap);
+
+/*
+ * The kernels below process frames that do not cross the buffer wrap. Sink
+ * channels above the remix channel count are left untouched.
+ */
+static void remix_pick_s16(const struct channel_remix *remix, const int16_t *x, int16_t *y,
+			   int x_nch, int y_nch, int frames)
+{
+	int nch = MIN(remix->sink_channels, y_nch);
+	const int16_t *src;
+	int16_t *dst;
+	int ch, i;
+
+	/* one sink channel at a time, a strided copy or a strided clear */
+	for (ch = 0; ch < nch; ch++) {
+		dst = y + ch;
+		if (remix->pick[ch] == CHANNEL_REMIX_SILENT) {
+			for (i = 0; i < frames; i++) {
+				*dst = 0;
+				dst += y_nch;
+			}
+			continue;
+		}
+
+		src = x + remix->pick[ch];
+		for (i = 0; i < frames; i++) {
+			*dst = *src;
+			src += x_nch;
+			dst += y_nch;
+		}
+	}
+}
+
+static void remix_pick_s32(const struct channel_remix *remix, const int32_t *x, int32_t *y,
+			   int x_nch, int y_nch, int frames)
+{
+	int nch = MIN(remix->sink_channels, y_nch);
+	const int32_t *src;
+	int32_t *dst;
+	int ch, i;
+
+	for (ch = 0; ch < nch; ch++) {
+		dst = y + ch;
+		if (remix->pick[ch] == CHANNEL_REMIX_SILENT) {
+			for (i = 0; i < frames; i++) {
+				*dst = 0;
+				dst += y_nch;
+			}
+			continue;
+		}
+
+		src = x + remix->pick[ch];
+		for (i = 0; i < frames; i++) {
+			*dst = *src;
+			src += x_nch;
+			dst += y_nch;
+		}
+	}
+}
+
+static void remix_mix_s16(const struct channel_remix *remix, const int16_t *x, int16_t *y,
+			  int x_nch, int y_nch, int frames)
+{
+	int nch = MIN(remix->sink_channels, y_nch);
+	const struct channel_remix_tap *tap;
+	const int16_t *row;
+	int32_t acc;
+	int ch, i, j;
+
+	switch (remix->shape) {
+	case CHANNEL_REMIX_DOWNMIX2:
+		tap = remix->taps;
+		for (i = 0; i < frames; i++) {
+			acc = (int32_t)x[tap[0].channel] * tap[0].coeff +
+			      (int32_t)x[tap[1].channel] * tap[1].coeff;
+			*y = sat_int16(REMIX_ROUND(acc));
+			x += x_nch;
+			y += y_nch;
+		}
+		break;
+	case CHANNEL_REMIX_SPARSE:
+		for (i = 0; i < frames; i++) {
+			tap = remix->taps;
+			for (ch = 0; ch < nch; ch++) {
+				acc = 0;
+				for (j = 0; j < remix->num_taps[ch]; j++, tap++)
+					acc += (int32_t)x[tap->channel] * tap->coeff;
+
+				y[ch] = sat_int16(REMIX_ROUND(acc));
+			}
+			x += x_nch;
+			y += y_nch;
+		}
+		break;
+	default:
+		for (i = 0; i < frames; i++) {
+			for (ch = 0; ch < nch; ch++) {
+				row = remix->coeffs + ch * remix->coeffs_stride;
+				acc = 0;
+				for (j = 0; j < remix->source_channels; j++)
+					acc += (int32_t)x[j] * row[j];
+
+				y[ch] = sat_int16(REMIX_ROUND(acc));
+			}
+			x += x_nch;
+			y += y_nch;
+		}
+		break;
+	}
+}
+
+static inline int32_t remix_sat_s32(int64_t acc, const bool s24)
+{
+	acc = REMIX_ROUND(acc);
+	return s24 ? sat_int24(sat_int32(acc)) : sat_int32(acc);
+}
+
+/* Inlined with a constant s24 for the 24 and 32 bit versions */
+static inline void remix_mix_s32(const struct channel_remix *remix, const int32_t *x, int32_t *y,
+				 int x_nch, int y_nch, int frames, const bool s24)
+{
+	int nch = MIN(remix->sink_channels, y_nch);
+	const struct channel_remix_tap *tap;
+	const int16_t *row;
+	int64_t acc;
+	int ch, i, j;
+
+	switch (remix->shape) {
+	case CHANNEL_REMIX_DOWNMIX2:
+		tap = remix->taps;
+		for (i = 0; i < frames; i++) {
+			acc = (int64_t)x[tap[0].channel] * tap[0].coeff +
+			      (int64_t)x[tap[1].channel] * tap[1].coeff;
+			*y = remix_sat_s32(acc, s24);
+			x += x_nch;
+			y += y_nch;
+		}
+		break;
+	case CHANNEL_REMIX_SPARSE:
+		for (i = 0; i < frames; i++) {
+			tap = remix->taps;
+			for (ch = 0; ch < nch; ch++) {
+				acc = 0;
+				for (j = 0; j < remix->num_taps[ch]; j++, tap++)
+					acc += (int64_t)x[tap->channel] * tap->coeff;
+
+				y[ch] = remix_sat_s32(acc, s24);
+			}
+			x += x_nch;
+			y += y_nch;
+		}
+		break;
+	default:
+		for (i = 0; i < frames; i++) {
+			for (ch = 0; ch < nch; ch++) {
+				row = remix->coeffs + ch * remix->coeffs_stride;
+				acc = 0;
+				for (j = 0; j < remix->source_channels; j++)
+					acc += (int64_t)x[j] * row[j];
+
+				y[ch] = remix_sat_s32(acc, s24);
+			}
+			x += x_nch;
+			y += y_nch;
+		}
+		break;
+	}
+}
+
+static void remix_frames_s16(const struct channel_remix *remix, const int16_t *x, int16_t *y,
+			     int x_nch, int y_nch, int frames)
+{
+	switch (remix->shape) {
+	case CHANNEL_REMIX_COPY:
+		if (x_nch == y_nch) {
+			memcpy_s(y, frames * y_nch * sizeof(*y), x, frames * x_nch * sizeof(*x));
+			break;
+		}
+		remix_pick_s16(remix, x, y, x_nch, y_nch, frames);
+		break;
+	case CHANNEL_REMIX_PICK:
+		remix_pick_s16(remix, x, y, x_nch, y_nch, frames);
+		break;
+	default:
+		remix_mix_s16(remix, x, y, x_nch, y_nch, frames);
+		break;
+	}
+}
+
+static inline void remix_frames_s32(const struct channel_remix *remix, const int32_t *x,
+				    int32_t *y, int x_nch, int y_nch, int frames, const bool s24)
+{
+	switch (remix->shape) {
+	case CHANNEL_REMIX_COPY:
+		if (x_nch == y_nch) {
+			memcpy_s(y, frames * y_nch * sizeof(*y), x, frames * x_nch * sizeof(*x));
+			break;
+		}
+		remix_pick_s32(remix, x, y, x_nch, y_nch, frames);
+		break;
+	case CHANNEL_REMIX_PICK:
+		remix_pick_s32(remix, x, y, x_nch, y_nch, frames);
+		break;
+	default:
+		remix_mix_s32(remix, x, y, x_nch, y_nch, frames, s24);
+		break;
+	}
+}
+
+void channel_remix_s16(const struct channel_remix *remix, const struct audio_stream *source,
+		       struct audio_stream *sink, uint32_t frames)
+{
+	int16_t in[CHANNEL_REMIX_SOURCE_MAX];
+	int16_t out[CHANNEL_REMIX_SINK_MAX];
+	int16_t *x = audio_stream_get_rptr(source);
+	int16_t *y = audio_stream_get_wptr(sink);
+	int16_t *ptr;
+	int x_nch = audio_stream_get_channels(source);
+	int y_nch = audio_stream_get_channels(sink);
+	int nin = MIN(x_nch, CHANNEL_REMIX_SOURCE_MAX);
+	int nout = MIN(y_nch, CHANNEL_REMIX_SINK_MAX);
+	uint32_t n;
+	int ch;
+
+	while (frames) {
+		n = MIN(frames, audio_stream_frames_without_wrap(source, x));
+		n = MIN(n, audio_stream_frames_without_wrap(sink, y));
+		if (n) {
+			remix_frames_s16(remix, x, y, x_nch, y_nch, n);
+		} else {
+			/* a frame split by the buffer wrap goes through local copies */
+			for (ch = 0; ch < nin; ch++) {
+				ptr = audio_stream_wrap(source, x + ch);
+				in[ch] = *ptr;
+			}
+			remix_frames_s16(remix, in, out, nin, nout, 1);
+			for (ch = 0; ch < MIN(nout, remix->sink_channels); ch++) {
+				ptr = audio_stream_wrap(sink, y + ch);
+				*ptr = out[ch];
+			}
+			n = 1;
+		}
+
+		x = audio_stream_wrap(source, x + n * x_nch);
+		y = audio_stream_wrap(sink, y + n * y_nch);
+		frames -= n;
+	}
+}
+EXPORT_SYMBOL(channel_remix_s16);
+
+static inline void remix_s32(const struct channel_remix *remix, const struct audio_stream *source,
+			     struct audio_stream *sink, uint32_t frames, const bool s24)
+{
+	int32_t in[CHANNEL_REMIX_SOURCE_MAX];
+	int32_t out[CHANNEL_REMIX_SINK_MAX];
+	int32_t *x = audio_stream_get_rptr(source);
+	int32_t *y = audio_stream_get_wptr(sink);
+	int32_t *ptr;
+	int x_nch = audio_stream_get_channels(source);
+	int y_nch = audio_stream_get_channels(sink);
+	int nin = MIN(x_nch, CHANNEL_REMIX_SOURCE_MAX);
+	int nout = MIN(y_nch, CHANNEL_REMIX_SINK_MAX);
+	uint32_t n;
+	int ch;
+
+	while (frames) {
+		n = MIN(frames, audio_stream_frames_without_wrap(source, x));
+		n = MIN(n, audio_stream_frames_without_wrap(sink, y));
+		if (n) {
+			remix_frames_s32(remix, x, y, x_nch, y_nch, n, s24);
+		} else {
+			for (ch = 0; ch < nin; ch++) {
+				ptr = audio_stream_wrap(source, x + ch);
+				in[ch] = *ptr;
+			}
+			remix_frames_s32(remix, in, out, nin, nout, 1, s24);
+			for (ch = 0; ch < MIN(nout, remix->sink_channels); ch++) {
+				ptr = audio_stream_wrap(sink, y + ch);
+				*ptr = out[ch];
+			}
+			n = 1;
+		}
+
+		x = audio_stream_wrap(source, x + n * x_nch);
+		y = audio_stream_wrap(sink, y + n * y_nch);
+		frames -= n;
+	}
+}
+
+void channel_remix_s24(const struct channel_remix *remix, const struct audio_stream *source,
+		       struct audio_stream *sink, uint32_t frames)
+{
+	remix_s32(remix, source, sink, frames, true);
+}
+EXPORT_SYMBOL(channel_remix_s24);
+
+void channel_remix_s32(const struct channel_remix *remix, const struct audio_stream *source,
+		       struct audio_stream *sink, uint32_t frames)
+{
+	remix_s32(remix, source, sink, frames, false);
+}
+EXPORT_SYMBOL(channel_remix_s32);
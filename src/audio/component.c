@@ -414,6 +414,10 @@ int audio_stream_copy(const struct audio_stream *source, uint32_t ioffset,
 	size_t bytes_snk;
 	size_t bytes_copied;
 
+	/* streams aliased for in-place processing, nothing to move */
+	if (src == snk)
+		return samples;
+
 	while (bytes) {
 		bytes_src = audio_stream_bytes_without_wrap(source, src);
 		bytes_snk = audio_stream_bytes_without_wrap(sink, snk);
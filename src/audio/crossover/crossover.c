@@ -585,7 +585,7 @@ static int crossover_prepare(struct processing_module *mod,
 			return -EINVAL;
 		}
 
-		cd->crossover_split = crossover_find_split_func(cd->config->num_sinks);
+		cd->crossover_split = crossover_find_split_block_func(cd->config->num_sinks);
 		if (!cd->crossover_split) {
 			comp_err(dev, "crossover_prepare(), No split function matching num_sinks %i",
 				 cd->config->num_sinks);
@@ -52,6 +52,13 @@ struct comp_dev;
 
 struct comp_data;
 
+/* Frames of one channel split at a time, the band buffers live on stack */
+#define CROSSOVER_BLOCK_FRAMES 32
+
+/* Splits a block of one channel's samples into the band buffers */
+typedef void (*crossover_split_block)(const int32_t in[], int32_t *out[], int frames,
+				      struct crossover_state *state);
+
 typedef void (*crossover_process)(struct comp_data *cd,
 				  struct input_stream_buffer *bsource,
 				  struct output_stream_buffer *bsinks[],
@@ -70,7 +77,7 @@ struct comp_data {
 	struct sof_crossover_config *config;      /**< pointer to setup blob */
 	enum sof_ipc_frame source_format;         /**< source frame format */
 	crossover_process crossover_process;      /**< processing function */
-	crossover_split crossover_split;          /**< split function */
+	crossover_split_block crossover_split;    /**< block split function */
 };
 
 struct crossover_proc_fnmap {
@@ -116,6 +123,18 @@ static inline crossover_process
 
 extern const crossover_split crossover_split_fnmap[];
 extern const size_t crossover_split_fncount;
+extern const crossover_split_block crossover_split_block_fnmap[];
+
+/**
+ * \brief Returns Crossover block split function.
+ */
+static inline crossover_split_block crossover_find_split_block_func(int32_t num_sinks)
+{
+	if (num_sinks < CROSSOVER_2WAY_NUM_SINKS ||
+	    num_sinks > CROSSOVER_4WAY_NUM_SINKS)
+		return NULL;
+	return crossover_split_block_fnmap[num_sinks - CROSSOVER_2WAY_NUM_SINKS];
+}
 
 /*
  * \brief Runs input in through the LR4 filter and returns it's output.
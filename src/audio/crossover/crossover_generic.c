@@ -104,6 +104,63 @@ static void crossover_default_pass(struct comp_data *cd,
 	}
 }
 
+/*
+ * Block versions of the split functions above. Each LR4 runs over the whole
+ * block before the next one, so its state stays in registers. The band
+ * buffers double as scratch for the intermediate signals, every filter sees
+ * the same sample sequence as in the per-sample versions.
+ */
+static void crossover_generic_lr4_block(struct iir_state_df1 *lr4, const int32_t in[],
+					int32_t out[], int frames)
+{
+	int i;
+
+	for (i = 0; i < frames; i++)
+		out[i] = crossover_generic_process_lr4(in[i], lr4);
+}
+
+static void crossover_generic_split_block_2way(const int32_t in[], int32_t *out[],
+					       int frames, struct crossover_state *state)
+{
+	crossover_generic_lr4_block(&state->lowpass[0], in, out[0], frames);
+	crossover_generic_lr4_block(&state->highpass[0], in, out[1], frames);
+}
+
+static void crossover_generic_split_block_3way(const int32_t in[], int32_t *out[],
+					       int frames, struct crossover_state *state)
+{
+	int32_t z;
+	int i;
+
+	/* z1 in out[0], z2 in out[2] */
+	crossover_generic_lr4_block(&state->lowpass[0], in, out[0], frames);
+	crossover_generic_lr4_block(&state->highpass[0], in, out[2], frames);
+
+	/* Realign the phase of z1 */
+	for (i = 0; i < frames; i++) {
+		z = crossover_generic_process_lr4(out[0][i], &state->lowpass[1]);
+		out[0][i] = sat_int32((int64_t)z +
+				      crossover_generic_process_lr4(out[0][i],
+								    &state->highpass[1]));
+	}
+
+	crossover_generic_lr4_block(&state->lowpass[2], out[2], out[1], frames);
+	crossover_generic_lr4_block(&state->highpass[2], out[2], out[2], frames);
+}
+
+static void crossover_generic_split_block_4way(const int32_t in[], int32_t *out[],
+					       int frames, struct crossover_state *state)
+{
+	/* z1 in out[0], z2 in out[2] */
+	crossover_generic_lr4_block(&state->lowpass[1], in, out[0], frames);
+	crossover_generic_lr4_block(&state->highpass[1], in, out[2], frames);
+
+	crossover_generic_lr4_block(&state->highpass[0], out[0], out[1], frames);
+	crossover_generic_lr4_block(&state->lowpass[0], out[0], out[0], frames);
+	crossover_generic_lr4_block(&state->highpass[2], out[2], out[3], frames);
+	crossover_generic_lr4_block(&state->lowpass[2], out[2], out[2], frames);
+}
+
 #if CONFIG_FORMAT_S16LE
 static void crossover_s16_default(struct comp_data *cd,
 				  struct input_stream_buffer *bsource,
@@ -111,141 +168,140 @@ static void crossover_s16_default(struct comp_data *cd,
 				  int32_t num_sinks,
 				  uint32_t frames)
 {
-	struct crossover_state *state;
 	const struct audio_stream *source_stream = bsource->data;
 	struct audio_stream *sink_stream;
-	int16_t *x, *y;
-	int ch, i, j;
-	int idx;
+	int32_t in[CROSSOVER_BLOCK_FRAMES];
+	int32_t out_buf[SOF_CROSSOVER_MAX_STREAMS][CROSSOVER_BLOCK_FRAMES];
+	int32_t *out[SOF_CROSSOVER_MAX_STREAMS];
+	int16_t *y[SOF_CROSSOVER_MAX_STREAMS];
+	int16_t *x;
+	int ch, i, j, k, n;
 	int nch = audio_stream_get_channels(source_stream);
-	int32_t out[num_sinks];
+
+	for (j = 0; j < num_sinks; j++)
+		out[j] = out_buf[j];
 
 	for (ch = 0; ch < nch; ch++) {
-		idx = ch;
-		state = &cd->state[ch];
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s16(source_stream, idx);
-			cd->crossover_split(*x << 16, out, state);
+		x = (int16_t *)audio_stream_get_rptr(source_stream) + ch;
+		x = audio_stream_wrap(source_stream, x);
+		for (j = 0; j < num_sinks; j++) {
+			if (!bsinks[j])
+				continue;
+			sink_stream = bsinks[j]->data;
+			y[j] = (int16_t *)audio_stream_get_wptr(sink_stream) + ch;
+			y[j] = audio_stream_wrap(sink_stream, y[j]);
+		}
+
+		for (i = 0; i < frames; i += n) {
+			n = MIN(frames - i, CROSSOVER_BLOCK_FRAMES);
+			for (k = 0; k < n; k++) {
+				in[k] = *x << 16;
+				x = audio_stream_wrap(source_stream, x + nch);
+			}
+
+			cd->crossover_split(in, out, n, &cd->state[ch]);
 
 			for (j = 0; j < num_sinks; j++) {
 				if (!bsinks[j])
 					continue;
 				sink_stream = bsinks[j]->data;
-				y = audio_stream_write_frag_s16(sink_stream,
-								idx);
-				*y = sat_int16(Q_SHIFT_RND(out[j], 31, 15));
+				for (k = 0; k < n; k++) {
+					*y[j] = sat_int16(Q_SHIFT_RND(out[j][k], 31, 15));
+					y[j] = audio_stream_wrap(sink_stream, y[j] + nch);
+				}
 			}
-
-			idx += nch;
 		}
 	}
 }
 #endif /* CONFIG_FORMAT_S16LE */
 
-#if CONFIG_FORMAT_S24LE
-static void crossover_s24_default(struct comp_data *cd,
-				  struct input_stream_buffer *bsource,
-				  struct output_stream_buffer **bsinks,
-				  int32_t num_sinks,
-				  uint32_t frames)
+#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
+/*
+ * \brief Processes audio frames with a crossover filter for 32 bit containers.
+ *
+ * Each channel is split in blocks of CROSSOVER_BLOCK_FRAMES into the local
+ * band buffers, which are then written to the active sinks.
+ *
+ * \param cd Pointer to the component data structure which holds the crossover state.
+ * \param bsource Pointer to the input stream buffer structure.
+ * \param bsinks Array of pointers to output stream buffer structures.
+ * \param num_sinks Number of output stream buffers in the bsinks array.
+ * \param frames Number of audio frames to process.
+ * \param shift Left shift of input samples to Q1.31, 8 for S24_4LE, 0 for S32_LE.
+ */
+static void crossover_s32_block(struct comp_data *cd,
+				struct input_stream_buffer *bsource,
+				struct output_stream_buffer **bsinks,
+				int32_t num_sinks,
+				uint32_t frames, int shift)
 {
-	struct crossover_state *state;
 	const struct audio_stream *source_stream = bsource->data;
 	struct audio_stream *sink_stream;
-	int32_t *x, *y;
-	int ch, i, j;
-	int idx;
+	int32_t in[CROSSOVER_BLOCK_FRAMES];
+	int32_t out_buf[SOF_CROSSOVER_MAX_STREAMS][CROSSOVER_BLOCK_FRAMES];
+	int32_t *out[SOF_CROSSOVER_MAX_STREAMS];
+	int32_t *y[SOF_CROSSOVER_MAX_STREAMS];
+	int32_t *x;
+	int ch, i, j, k, n;
 	int nch = audio_stream_get_channels(source_stream);
-	int32_t out[num_sinks];
+
+	for (j = 0; j < num_sinks; j++)
+		out[j] = out_buf[j];
 
 	for (ch = 0; ch < nch; ch++) {
-		idx = ch;
-		state = &cd->state[ch];
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source_stream, idx);
-			cd->crossover_split(*x << 8, out, state);
+		x = (int32_t *)audio_stream_get_rptr(source_stream) + ch;
+		x = audio_stream_wrap(source_stream, x);
+		for (j = 0; j < num_sinks; j++) {
+			if (!bsinks[j])
+				continue;
+			sink_stream = bsinks[j]->data;
+			y[j] = (int32_t *)audio_stream_get_wptr(sink_stream) + ch;
+			y[j] = audio_stream_wrap(sink_stream, y[j]);
+		}
+
+		for (i = 0; i < frames; i += n) {
+			n = MIN(frames - i, CROSSOVER_BLOCK_FRAMES);
+			for (k = 0; k < n; k++) {
+				in[k] = *x << shift;
+				x = audio_stream_wrap(source_stream, x + nch);
+			}
+
+			cd->crossover_split(in, out, n, &cd->state[ch]);
 
 			for (j = 0; j < num_sinks; j++) {
 				if (!bsinks[j])
 					continue;
 				sink_stream = bsinks[j]->data;
-				y = audio_stream_write_frag_s32(sink_stream,
-								idx);
-				*y = sat_int24(Q_SHIFT_RND(out[j], 31, 23));
+				for (k = 0; k < n; k++) {
+					*y[j] = shift ? sat_int24(Q_SHIFT_RND(out[j][k], 31, 23)) :
+						out[j][k];
+					y[j] = audio_stream_wrap(sink_stream, y[j] + nch);
+				}
 			}
-
-			idx += nch;
 		}
 	}
 }
+#endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
+
+#if CONFIG_FORMAT_S24LE
+static void crossover_s24_default(struct comp_data *cd,
+				  struct input_stream_buffer *bsource,
+				  struct output_stream_buffer **bsinks,
+				  int32_t num_sinks,
+				  uint32_t frames)
+{
+	crossover_s32_block(cd, bsource, bsinks, num_sinks, frames, 8);
+}
 #endif /* CONFIG_FORMAT_S24LE */
 
 #if CONFIG_FORMAT_S32LE
-/**
- * \brief Processes audio frames with a crossover filter for s32 format.
- *
- * This function divides audio data from an input stream into multiple output
- * streams based on a crossover filter. It reads the input audio data, applies
- * the crossover filter, and writes the processed audio data to active output
- * streams.
- *
- * \param cd Pointer to the component data structure which holds the crossover state.
- * \param bsource Pointer to the input stream buffer structure.
- * \param bsinks Array of pointers to output stream buffer structures.
- * \param num_sinks Number of output stream buffers in the bsinks array.
- * \param frames Number of audio frames to process.
- */
 static void crossover_s32_default(struct comp_data *cd,
 				  struct input_stream_buffer *bsource,
 				  struct output_stream_buffer **bsinks,
 				  int32_t num_sinks,
 				  uint32_t frames)
 {
-	/* Array to hold active sink streams; initialized to null */
-	struct audio_stream *sink_stream[SOF_CROSSOVER_MAX_STREAMS] = { NULL };
-	struct crossover_state *state;
-	/* Source stream to read audio data from */
-	const struct audio_stream *source_stream = bsource->data;
-	int32_t *x, *y;
-	int ch, i, j;
-	int idx;
-	/* Counter for active sink streams */
-	int active_sinks = 0;
-	/* Number of channels in the source stream */
-	int nch = audio_stream_get_channels(source_stream);
-	/* Output buffer for processed data */
-	int32_t out[num_sinks];
-
-	/* Identify active sinks, avoid processing null sinks later */
-	for (j = 0; j < num_sinks; j++) {
-		if (bsinks[j])
-			sink_stream[active_sinks++] = bsinks[j]->data;
-	}
-
-	/* Process for each channel */
-	/* Loop through each channel in the source stream */
-	for (ch = 0; ch < nch; ch++) {
-		/* Set current crossover state for this channel */
-		state = &cd->state[ch];
-		/* Iterate over frames */
-		/* Loop through each frame */
-		for (i = 0, idx = ch; i < frames; i++, idx += nch) {
-			/* Read source */
-			/* Read the current audio frame for the channel */
-			x = audio_stream_read_frag_s32(source_stream, idx);
-			/* Apply the crossover split logic to the audio data */
-			cd->crossover_split(*x, out, state);
-
-			/* Write output to active sinks */
-			/* Write processed output to active sinks */
-			for (j = 0; j < active_sinks; j++) {
-				/* Write processed data to sink */
-				y = audio_stream_write_frag_s32(sink_stream[j], idx);
-				*y = out[j];
-			}
-
-		}
-	}
+	crossover_s32_block(cd, bsource, bsinks, num_sinks, frames, 0);
 }
 #endif /* CONFIG_FORMAT_S32LE */
 
@@ -288,3 +344,9 @@ const crossover_split crossover_split_fnmap[] = {
 };
 
 const size_t crossover_split_fncount = ARRAY_SIZE(crossover_split_fnmap);
+
+const crossover_split_block crossover_split_block_fnmap[] = {
+	crossover_generic_split_block_2way,
+	crossover_generic_split_block_3way,
+	crossover_generic_split_block_4way,
+};
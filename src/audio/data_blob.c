@@ -7,6 +7,7 @@
 #include <sof/audio/module_adapter/module/generic.h>
 #include <rtos/sof.h>
 #include <rtos/alloc.h>
+#include <rtos/spinlock.h>
 #include <rtos/symbol.h>
 #include <ipc/topology.h>
 #include <ipc/control.h>
@@ -15,7 +16,13 @@
 
 LOG_MODULE_REGISTER(data_blob, CONFIG_SOF_LOG_LEVEL);
 
-/** \brief Struct handler for large component configs */
+/** \brief Struct handler for large component configs
+ *
+ * Data blobs and their prepared state are received in IPC context and applied
+ * in the audio thread, which can preempt IPC. data_new and state_new belong to
+ * IPC while data_ready is clear and to the audio thread once it is set.
+ * data_ready, data_old, state_old and old_in_use are only accessed under lock.
+ */
 struct comp_data_blob_handler {
 	struct comp_dev *dev;	/**< audio component device */
 	uint32_t data_size;	/**< size of component's data blob */
@@ -34,12 +41,109 @@ struct comp_data_blob_handler {
 
 	/** validator for new data, maybe null */
 	int (*validator)(struct comp_dev *dev, void *new_data, uint32_t new_data_size);
+
+	/** builds processing state for new data outside of audio thread, maybe null */
+	const struct comp_data_blob_prepare_ops *prepare_ops;
+	void *state;		/**< state applied with current data blob */
+	void *state_new;	/**< state prepared for new data blob */
+	void *data_old;		/**< data blob retired by comp_data_blob_swap() */
+	void *state_old;	/**< state retired by comp_data_blob_swap() */
+	bool old_in_use;	/**< retired state may still be used by audio thread */
+	struct k_spinlock lock;	/**< hands blobs over between IPC and audio thread */
+
+	/** consumes fragments of new data in place of staging, maybe null */
+	int (*stream)(struct comp_dev *dev, enum module_cfg_fragment_position pos,
+		      uint32_t data_size, uint32_t offset,
+		      const uint8_t *fragment, size_t fragment_size);
+	bool streaming;		/**< a streamed data blob transfer is in progress */
 };
 
+/* Frees data and state retired by comp_data_blob_swap() once the audio
+ * thread has moved past the period in which they were swapped out.
+ */
+static void comp_data_blob_reclaim(struct comp_data_blob_handler *blob_handler)
+{
+	k_spinlock_key_t key;
+	void *data_old;
+	void *state_old;
+
+	key = k_spin_lock(&blob_handler->lock);
+	if (blob_handler->old_in_use) {
+		k_spin_unlock(&blob_handler->lock, key);
+		return;
+	}
+
+	data_old = blob_handler->data_old;
+	state_old = blob_handler->state_old;
+	blob_handler->data_old = NULL;
+	blob_handler->state_old = NULL;
+	k_spin_unlock(&blob_handler->lock, key);
+
+	if (state_old)
+		blob_handler->prepare_ops->release(blob_handler->dev, state_old);
+	blob_handler->free(data_old);
+}
+
+static void comp_data_blob_release_state(struct comp_data_blob_handler *blob_handler,
+					 void **state)
+{
+	if (*state)
+		blob_handler->prepare_ops->release(blob_handler->dev, *state);
+	*state = NULL;
+}
+
+/* Drops the new data blob together with the state prepared for it. */
+static void comp_data_blob_discard_new(struct comp_data_blob_handler *blob_handler)
+{
+	blob_handler->free(blob_handler->data_new);
+	blob_handler->data_new = NULL;
+	comp_data_blob_release_state(blob_handler, &blob_handler->state_new);
+}
+
+/* Makes the new data blob current, the state prepared for it replaces the
+ * state of the current one. Returns the replaced state, which the caller has
+ * to release, the replaced data blob must have been taken care of already.
+ */
+static void *comp_data_blob_promote_new(struct comp_data_blob_handler *blob_handler)
+{
+	void *state = blob_handler->state;
+
+	blob_handler->data = blob_handler->data_new;
+	blob_handler->data_size = blob_handler->new_data_size;
+	blob_handler->state = blob_handler->state_new;
+
+	blob_handler->data_new = NULL;
+	blob_handler->state_new = NULL;
+	blob_handler->data_ready = false;
+	blob_handler->new_data_size = 0;
+	blob_handler->data_pos = 0;
+
+	return state;
+}
+
+/* Takes a new data blob, which may be pending in the audio thread, back to
+ * receive another one in its place. The state prepared for it is dropped.
+ */
+static void comp_data_blob_restart(struct comp_data_blob_handler *blob_handler)
+{
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&blob_handler->lock);
+	blob_handler->data_ready = false;
+	k_spin_unlock(&blob_handler->lock, key);
+
+	comp_data_blob_release_state(blob_handler, &blob_handler->state_new);
+}
+
 static void comp_free_data_blob(struct comp_data_blob_handler *blob_handler)
 {
 	assert(blob_handler);
 
+	blob_handler->old_in_use = false;
+	comp_data_blob_reclaim(blob_handler);
+	comp_data_blob_release_state(blob_handler, &blob_handler->state);
+	comp_data_blob_release_state(blob_handler, &blob_handler->state_new);
+
 	if (!blob_handler->data)
 		return;
 
@@ -50,6 +154,107 @@ static void comp_free_data_blob(struct comp_data_blob_handler *blob_handler)
 	blob_handler->data_size = 0;
 }
 
+/* Completes reception of a new data blob. The blob is applied at once if
+ * the component is not streaming, otherwise it is staged for the audio
+ * thread, together with the state prepared for it if the component has
+ * prepare ops.
+ */
+static int comp_data_blob_commit(struct comp_data_blob_handler *blob_handler)
+{
+	k_spinlock_key_t key;
+	void *state;
+	int ret;
+
+	comp_data_blob_reclaim(blob_handler);
+
+	/* If component state is READY we can omit old
+	 * configuration immediately. When in playback/capture
+	 * the new configuration presence is checked in copy().
+	 */
+	if (blob_handler->dev->state ==  COMP_STATE_READY) {
+		blob_handler->free(blob_handler->data);
+		blob_handler->data = NULL;
+	}
+
+	/* If there is no existing configuration the received
+	 * can be set to current immediately. It will be
+	 * applied in prepare() when streaming starts.
+	 */
+	if (!blob_handler->data) {
+		/* State of the old configuration no longer applies, the new
+		 * one has no state prepared yet.
+		 */
+		comp_data_blob_release_state(blob_handler, &blob_handler->state_new);
+		state = comp_data_blob_promote_new(blob_handler);
+		comp_data_blob_release_state(blob_handler, &state);
+		return 0;
+	}
+
+	if (blob_handler->prepare_ops) {
+		/* nothing may be left over from a replaced pending blob */
+		comp_data_blob_release_state(blob_handler, &blob_handler->state_new);
+		ret = blob_handler->prepare_ops->prepare(blob_handler->dev,
+							 blob_handler->data_new,
+							 blob_handler->new_data_size,
+							 &blob_handler->state_new);
+		if (ret < 0) {
+			comp_err(blob_handler->dev, "new data blob preparation failed, discarding");
+			comp_data_blob_discard_new(blob_handler);
+			return ret;
+		}
+	}
+
+	/* The new configuration is ready to be applied, hand it over */
+	key = k_spin_lock(&blob_handler->lock);
+	blob_handler->data_ready = true;
+	k_spin_unlock(&blob_handler->lock, key);
+
+	return 0;
+}
+
+/* Passes a fragment of a new data blob straight to the stream callback,
+ * tracking its position the same way as staged transfers do.
+ */
+static int comp_data_blob_stream(struct comp_data_blob_handler *blob_handler,
+				 enum module_cfg_fragment_position pos, uint32_t data_offset_size,
+				 const uint8_t *fragment, size_t fragment_size)
+{
+	int ret;
+
+	if (pos == MODULE_CFG_FRAGMENT_FIRST || pos == MODULE_CFG_FRAGMENT_SINGLE) {
+		if (!fragment_size)
+			return 0;
+
+		/* a new transfer aborts an unfinished one, the callback sees FIRST again */
+		blob_handler->new_data_size = data_offset_size;
+		blob_handler->data_pos = 0;
+		blob_handler->streaming = true;
+	} else if (!blob_handler->streaming) {
+		comp_err(blob_handler->dev, "no data blob transfer in progress");
+		return -EINVAL;
+	}
+
+	if (fragment_size > blob_handler->new_data_size - blob_handler->data_pos) {
+		comp_err(blob_handler->dev, "fragment of %zu bytes overflows data blob",
+			 fragment_size);
+		ret = -EINVAL;
+	} else {
+		ret = blob_handler->stream(blob_handler->dev, pos, blob_handler->new_data_size,
+					   blob_handler->data_pos, fragment, fragment_size);
+	}
+
+	if (ret < 0 || pos == MODULE_CFG_FRAGMENT_SINGLE || pos == MODULE_CFG_FRAGMENT_LAST) {
+		blob_handler->streaming = false;
+		blob_handler->new_data_size = 0;
+		blob_handler->data_pos = 0;
+		return ret;
+	}
+
+	blob_handler->data_pos += fragment_size;
+
+	return 0;
+}
+
 void comp_data_blob_set_validator(struct comp_data_blob_handler *blob_handler,
 				  int (*validator)(struct comp_dev *dev, void *new_data,
 						   uint32_t new_data_size))
@@ -63,6 +268,11 @@ EXPORT_SYMBOL(comp_data_blob_set_validator);
 void *comp_get_data_blob(struct comp_data_blob_handler *blob_handler,
 			 size_t *size, uint32_t *crc)
 {
+	k_spinlock_key_t key;
+	void *data_old = NULL;
+	void *state_old = NULL;
+	bool applied = false;
+
 	assert(blob_handler);
 
 	comp_dbg(blob_handler->dev, "comp_get_data_blob()");
@@ -71,18 +281,20 @@ void *comp_get_data_blob(struct comp_data_blob_handler *blob_handler,
 		*size = 0;
 
 	/* Function returns new data blob if available */
-	if (comp_is_new_data_blob_available(blob_handler)) {
-		comp_dbg(blob_handler->dev, "new data available");
+	key = k_spin_lock(&blob_handler->lock);
+	if (blob_handler->data_new && blob_handler->data_ready) {
+		data_old = blob_handler->data;
+		state_old = comp_data_blob_promote_new(blob_handler);
+		applied = true;
+	}
+	k_spin_unlock(&blob_handler->lock, key);
 
-		/* Free "old" data blob and set data to data_new pointer */
-		blob_handler->free(blob_handler->data);
-		blob_handler->data = blob_handler->data_new;
-		blob_handler->data_size = blob_handler->new_data_size;
+	if (applied) {
+		comp_dbg(blob_handler->dev, "new data available");
 
-		blob_handler->data_new = NULL;
-		blob_handler->data_ready = false;
-		blob_handler->new_data_size = 0;
-		blob_handler->data_pos = 0;
+		/* Free "old" data blob and its state */
+		blob_handler->free(data_old);
+		comp_data_blob_release_state(blob_handler, &state_old);
 	}
 
 	/* If data is available we calculate crc32 when crc pointer is given */
@@ -123,6 +335,80 @@ bool comp_is_new_data_blob_available(struct comp_data_blob_handler
 }
 EXPORT_SYMBOL(comp_is_new_data_blob_available);
 
+bool comp_data_blob_swap(struct comp_data_blob_handler *blob_handler, void **old_state)
+{
+	k_spinlock_key_t key;
+	void *data_old;
+	void *state_old;
+
+	assert(blob_handler);
+
+	if (old_state)
+		*old_state = NULL;
+
+	key = k_spin_lock(&blob_handler->lock);
+
+	/* A new period has started, retired state is not used anymore */
+	blob_handler->old_in_use = false;
+
+	if (!blob_handler->data_new || !blob_handler->data_ready) {
+		k_spin_unlock(&blob_handler->lock, key);
+		return false;
+	}
+
+	/* IPC may not have reclaimed the previous retired blob yet */
+	data_old = blob_handler->data_old;
+	state_old = blob_handler->state_old;
+
+	blob_handler->data_old = blob_handler->data;
+	blob_handler->state_old = comp_data_blob_promote_new(blob_handler);
+	blob_handler->old_in_use = true;
+
+	if (old_state)
+		*old_state = blob_handler->state_old;
+
+	k_spin_unlock(&blob_handler->lock, key);
+
+	if (data_old) {
+		comp_warn(blob_handler->dev, "releasing retired data blob in audio thread");
+		comp_data_blob_release_state(blob_handler, &state_old);
+		blob_handler->free(data_old);
+	}
+
+	return true;
+}
+EXPORT_SYMBOL(comp_data_blob_swap);
+
+void *comp_data_blob_get_state(struct comp_data_blob_handler *blob_handler)
+{
+	assert(blob_handler);
+
+	return blob_handler->state;
+}
+EXPORT_SYMBOL(comp_data_blob_get_state);
+
+void comp_data_blob_set_prepare_ops(struct comp_data_blob_handler *blob_handler,
+				    const struct comp_data_blob_prepare_ops *ops)
+{
+	assert(blob_handler);
+
+	blob_handler->prepare_ops = ops;
+}
+EXPORT_SYMBOL(comp_data_blob_set_prepare_ops);
+
+void comp_data_blob_set_stream(struct comp_data_blob_handler *blob_handler,
+			       int (*stream)(struct comp_dev *dev,
+					     enum module_cfg_fragment_position pos,
+					     uint32_t data_size, uint32_t offset,
+					     const uint8_t *fragment, size_t fragment_size))
+{
+	assert(blob_handler);
+
+	blob_handler->stream = stream;
+	blob_handler->streaming = false;
+}
+EXPORT_SYMBOL(comp_data_blob_set_stream);
+
 bool comp_is_current_data_blob_valid(struct comp_data_blob_handler
 				     *blob_handler)
 {
@@ -193,6 +479,10 @@ int comp_data_blob_set(struct comp_data_blob_handler *blob_handler,
 	comp_dbg(blob_handler->dev, "comp_data_blob_set_cmd() pos = %d, fragment size = %zu",
 		 pos, fragment_size);
 
+	if (blob_handler->stream)
+		return comp_data_blob_stream(blob_handler, pos, data_offset_size,
+					     fragment, fragment_size);
+
 	/* Check that there is no work-in-progress previous request */
 	if (blob_handler->data_new &&
 	    (pos == MODULE_CFG_FRAGMENT_FIRST || pos == MODULE_CFG_FRAGMENT_SINGLE)) {
@@ -231,6 +521,8 @@ int comp_data_blob_set(struct comp_data_blob_handler *blob_handler,
 			return 0;
 
 		if (blob_handler->single_blob) {
+			/* State of the current data blob goes away with it */
+			comp_data_blob_release_state(blob_handler, &blob_handler->state);
 			if (data_offset_size != blob_handler->data_size) {
 				blob_handler->free(blob_handler->data);
 				blob_handler->data = NULL;
@@ -277,39 +569,12 @@ int comp_data_blob_set(struct comp_data_blob_handler *blob_handler,
 						      blob_handler->new_data_size);
 			if (ret < 0) {
 				comp_err(blob_handler->dev, "new data is invalid! discarding it...");
-				blob_handler->free(blob_handler->data_new);
-				blob_handler->data_new = NULL;
+				comp_data_blob_discard_new(blob_handler);
 				return ret;
 			}
 		}
 
-		/* If component state is READY we can omit old
-		 * configuration immediately. When in playback/capture
-		 * the new configuration presence is checked in copy().
-		 */
-		if (blob_handler->dev->state ==  COMP_STATE_READY) {
-			blob_handler->free(blob_handler->data);
-			blob_handler->data = NULL;
-		}
-
-		/* If there is no existing configuration the received
-		 * can be set to current immediately. It will be
-		 * applied in prepare() when streaming starts.
-		 */
-		if (!blob_handler->data) {
-			blob_handler->data = blob_handler->data_new;
-			blob_handler->data_size = blob_handler->new_data_size;
-
-			blob_handler->data_new = NULL;
-
-			/* The new configuration has been applied */
-			blob_handler->data_ready = false;
-			blob_handler->new_data_size = 0;
-			blob_handler->data_pos = 0;
-		} else {
-			/* The new configuration is ready to be applied */
-			blob_handler->data_ready = true;
-		}
+		return comp_data_blob_commit(blob_handler);
 	}
 
 	return 0;
@@ -330,6 +595,24 @@ int ipc4_comp_data_blob_set(struct comp_data_blob_handler *blob_handler,
 		 "data_offset = %d",
 		 data_offset);
 
+	if (blob_handler->stream) {
+		if (first_block)
+			valid_data_size = last_block ? data_offset : MAILBOX_DSPBOX_SIZE;
+		else if (last_block)
+			valid_data_size = blob_handler->new_data_size - data_offset;
+		else
+			valid_data_size = MAILBOX_DSPBOX_SIZE;
+
+		if (!first_block && blob_handler->data_pos != data_offset) {
+			comp_err(blob_handler->dev, "Wrong data offset received!");
+			return -EINVAL;
+		}
+
+		return comp_data_blob_stream(blob_handler,
+					     first_last_block_to_frag_pos(first_block, last_block),
+					     data_offset, (const uint8_t *)data, valid_data_size);
+	}
+
 	/* in case when the current package is the first, we should allocate
 	 * memory for whole model data
 	 */
@@ -337,7 +620,12 @@ int ipc4_comp_data_blob_set(struct comp_data_blob_handler *blob_handler,
 		if (!data_offset)
 			return 0;
 
+		/* A pending blob not applied yet is overwritten by this one */
+		comp_data_blob_restart(blob_handler);
+
 		if (blob_handler->single_blob) {
+			/* State of the current data blob goes away with it */
+			comp_data_blob_release_state(blob_handler, &blob_handler->state);
 			if (data_offset != blob_handler->data_size) {
 				blob_handler->free(blob_handler->data);
 				blob_handler->data = NULL;
@@ -359,7 +647,6 @@ int ipc4_comp_data_blob_set(struct comp_data_blob_handler *blob_handler,
 		}
 
 		blob_handler->new_data_size = data_offset;
-		blob_handler->data_ready = false;
 		blob_handler->data_pos = 0;
 
 		valid_data_size = last_block ? data_offset : MAILBOX_DSPBOX_SIZE;
@@ -401,33 +688,7 @@ int ipc4_comp_data_blob_set(struct comp_data_blob_handler *blob_handler,
 		comp_dbg(blob_handler->dev,
 			 "final package received");
 
-		/* If component state is READY we can omit old
-		 * configuration immediately. When in playback/capture
-		 * the new configuration presence is checked in copy().
-		 */
-		if (blob_handler->dev->state ==  COMP_STATE_READY) {
-			blob_handler->free(blob_handler->data);
-			blob_handler->data = NULL;
-		}
-
-		/* If there is no existing configuration the received
-		 * can be set to current immediately. It will be
-		 * applied in prepare() when streaming starts.
-		 */
-		if (!blob_handler->data) {
-			blob_handler->data = blob_handler->data_new;
-			blob_handler->data_size = blob_handler->new_data_size;
-
-			blob_handler->data_new = NULL;
-
-			/* The new configuration has been applied */
-			blob_handler->data_ready = false;
-			blob_handler->new_data_size = 0;
-			blob_handler->data_pos = 0;
-		} else {
-			/* The new configuration is ready to be applied */
-			blob_handler->data_ready = true;
-		}
+		return comp_data_blob_commit(blob_handler);
 	}
 
 	return 0;
@@ -445,6 +706,13 @@ int comp_data_blob_set_cmd(struct comp_data_blob_handler *blob_handler,
 		 cdata->msg_index, cdata->num_elems,
 		 cdata->elems_remaining);
 
+	if (blob_handler->stream)
+		return comp_data_blob_stream(blob_handler,
+					     first_last_block_to_frag_pos(!cdata->msg_index,
+									  !cdata->elems_remaining),
+					     cdata->data->size, (const uint8_t *)cdata->data->data,
+					     cdata->num_elems);
+
 	/* Check that there is no work-in-progress previous request */
 	if (blob_handler->data_new && cdata->msg_index == 0) {
 		comp_err(blob_handler->dev, "comp_data_blob_set_cmd(), busy with previous request");
@@ -484,6 +752,8 @@ int comp_data_blob_set_cmd(struct comp_data_blob_handler *blob_handler,
 			return 0;
 
 		if (blob_handler->single_blob) {
+			/* State of the current data blob goes away with it */
+			comp_data_blob_release_state(blob_handler, &blob_handler->state);
 			if (cdata->data->size != blob_handler->data_size) {
 				blob_handler->free(blob_handler->data);
 				blob_handler->data = NULL;
@@ -531,39 +801,12 @@ int comp_data_blob_set_cmd(struct comp_data_blob_handler *blob_handler,
 						      blob_handler->new_data_size);
 			if (ret < 0) {
 				comp_err(blob_handler->dev, "new data blob invalid, discarding");
-				blob_handler->free(blob_handler->data_new);
-				blob_handler->data_new = NULL;
+				comp_data_blob_discard_new(blob_handler);
 				return ret;
 			}
 		}
 
-		/* If component state is READY we can omit old
-		 * configuration immediately. When in playback/capture
-		 * the new configuration presence is checked in copy().
-		 */
-		if (blob_handler->dev->state ==  COMP_STATE_READY) {
-			blob_handler->free(blob_handler->data);
-			blob_handler->data = NULL;
-		}
-
-		/* If there is no existing configuration the received
-		 * can be set to current immediately. It will be
-		 * applied in prepare() when streaming starts.
-		 */
-		if (!blob_handler->data) {
-			blob_handler->data = blob_handler->data_new;
-			blob_handler->data_size = blob_handler->new_data_size;
-
-			blob_handler->data_new = NULL;
-
-			/* The new configuration has been applied */
-			blob_handler->data_ready = false;
-			blob_handler->new_data_size = 0;
-			blob_handler->data_pos = 0;
-		} else {
-			/* The new configuration is ready to be applied */
-			blob_handler->data_ready = true;
-		}
+		return comp_data_blob_commit(blob_handler);
 	}
 
 	return 0;
@@ -649,6 +892,7 @@ comp_data_blob_handler_new_ext(struct comp_dev *dev, bool single_blob,
 		handler->single_blob = single_blob;
 		handler->alloc = alloc ? alloc : default_alloc;
 		handler->free = free ? free : default_free;
+		k_spinlock_init(&handler->lock);
 	}
 
 	return handler;
@@ -65,6 +65,7 @@ static int eq_iir_init(struct processing_module *mod)
 		return -ENOMEM;
 
 	md->private = cd;
+	mod->process_in_place = true;
 
 	/* component model data handler */
 	cd->model_handler = comp_data_blob_handler_new(dev);
@@ -84,6 +85,9 @@ static int eq_iir_init(struct processing_module *mod)
 		goto err;
 	}
 
+	/* Coefficients for run-time updates are prepared in IPC context */
+	comp_data_blob_set_prepare_ops(cd->model_handler, &eq_iir_prepare_ops);
+
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
 		iir_reset_df1(&cd->iir[i]);
 
@@ -141,12 +145,15 @@ static int eq_iir_process(struct processing_module *mod,
 	uint32_t frame_count = input_buffers[0].size;
 	int ret;
 
-	/* Check for changed configuration */
-	if (comp_is_new_data_blob_available(cd->model_handler)) {
+	/* Check for changed configuration, the filters for it have been
+	 * prepared in IPC context.
+	 */
+	if (comp_data_blob_swap(cd->model_handler, NULL)) {
 		cd->config = comp_get_data_blob(cd->model_handler, NULL, NULL);
 		ret = eq_iir_new_blob(mod, cd, audio_stream_get_frm_fmt(source),
 				      audio_stream_get_frm_fmt(sink),
-				      audio_stream_get_channels(source));
+				      audio_stream_get_channels(source),
+				      comp_data_blob_get_state(cd->model_handler));
 		if (ret)
 			return ret;
 	}
@@ -207,6 +214,7 @@ static int eq_iir_prepare(struct processing_module *mod,
 	sink_format = audio_stream_get_frm_fmt(&sinkb->stream);
 
 	cd->config = comp_get_data_blob(cd->model_handler, NULL, NULL);
+	cd->channels = channels;
 
 	/* Initialize EQ */
 	comp_info(dev, "eq_iir_prepare(), source_format=%d, sink_format=%d",
@@ -216,7 +224,7 @@ static int eq_iir_prepare(struct processing_module *mod,
 
 	/* Initialize EQ */
 	if (cd->config) {
-		ret = eq_iir_new_blob(mod, cd, source_format, sink_format, channels);
+		ret = eq_iir_new_blob(mod, cd, source_format, sink_format, channels, NULL);
 		if (ret)
 			return ret;
 	}
@@ -33,6 +33,13 @@ struct eq_iir_func_map {
 	eq_iir_func func;			/**< processing function */
 };
 
+/* Filters prepared in IPC context for a blob received while streaming */
+struct eq_iir_update {
+	struct iir_state_df1 iir[PLATFORM_MAX_CHANNELS];
+	int32_t *iir_delay;
+	size_t iir_delay_size;
+};
+
 /* IIR component private data */
 struct comp_data {
 	struct iir_state_df1 iir[PLATFORM_MAX_CHANNELS]; /**< filters state */
@@ -41,8 +48,11 @@ struct comp_data {
 	int32_t *iir_delay;			/**< pointer to allocated RAM */
 	size_t iir_delay_size;			/**< allocated size */
 	eq_iir_func eq_iir_func;		/**< processing function */
+	int channels;				/**< stream channels count */
 };
 
+extern const struct comp_data_blob_prepare_ops eq_iir_prepare_ops;
+
 #ifdef UNIT_TEST
 void sys_comp_module_eq_iir_interface_init(void);
 #endif
@@ -58,7 +68,7 @@ void eq_iir_s32_default(struct processing_module *mod, struct input_stream_buffe
 
 int eq_iir_new_blob(struct processing_module *mod, struct comp_data *cd,
 		    enum sof_ipc_frame source_format, enum sof_ipc_frame sink_format,
-		    int channels);
+		    int channels, struct eq_iir_update *update);
 
 void eq_iir_set_passthrough_func(struct comp_data *cd,
 				 enum sof_ipc_frame source_format,
@@ -69,7 +79,7 @@ int eq_iir_prepare_sub(struct processing_module *mod);
 void eq_iir_pass(struct processing_module *mod, struct input_stream_buffer *bsource,
 		 struct output_stream_buffer *bsink, uint32_t frames);
 
-int eq_iir_setup(struct processing_module *mod, int nch);
+int eq_iir_setup(struct processing_module *mod, int nch, struct eq_iir_update *update);
 
 void eq_iir_free_delaylines(struct comp_data *cd);
 #endif /* __SOF_AUDIO_EQ_IIR_EQ_IIR_H__ */
@@ -180,11 +180,9 @@ void eq_iir_s32_default(struct processing_module *mod, struct input_stream_buffe
 }
 #endif /* CONFIG_FORMAT_S32LE */
 
-static int eq_iir_init_coef(struct processing_module *mod, int nch)
+static int eq_iir_init_coef(struct processing_module *mod, struct sof_eq_iir_config *config,
+			    struct iir_state_df1 *iir, int nch)
 {
-	struct comp_data *cd = module_get_private_data(mod);
-	struct sof_eq_iir_config *config = cd->config;
-	struct iir_state_df1 *iir = cd->iir;
 	struct sof_eq_iir_header *lookup[SOF_EQ_IIR_MAX_RESPONSES];
 	struct sof_eq_iir_header *eq;
 	int32_t *assign_response;
@@ -309,16 +307,14 @@ void eq_iir_pass(struct processing_module *mod, struct input_stream_buffer *bsou
 	audio_stream_copy(source, 0, sink, 0, frames * audio_stream_get_channels(source));
 }
 
-int eq_iir_setup(struct processing_module *mod, int nch)
+static int eq_iir_build(struct processing_module *mod, struct sof_eq_iir_config *config,
+			struct iir_state_df1 *iir, int32_t **iir_delay,
+			size_t *iir_delay_size, int nch)
 {
-	struct comp_data *cd = module_get_private_data(mod);
 	int delay_size;
 
-	/* Free existing IIR channels data if it was allocated */
-	eq_iir_free_delaylines(cd);
-
 	/* Set coefficients for each channel EQ from coefficient blob */
-	delay_size = eq_iir_init_coef(mod, nch);
+	delay_size = eq_iir_init_coef(mod, config, iir, nch);
 	if (delay_size < 0)
 		return delay_size; /* Contains error code */
 
@@ -329,17 +325,78 @@ int eq_iir_setup(struct processing_module *mod, int nch)
 		return 0;
 
 	/* Allocate all IIR channels data in a big chunk and clear it */
-	cd->iir_delay = rzalloc(SOF_MEM_FLAG_USER,
-				delay_size);
-	if (!cd->iir_delay) {
+	*iir_delay = rzalloc(SOF_MEM_FLAG_USER, delay_size);
+	if (!*iir_delay) {
 		comp_err(mod->dev, "eq_iir_setup(), delay allocation fail");
 		return -ENOMEM;
 	}
 
-	cd->iir_delay_size = delay_size;
+	*iir_delay_size = delay_size;
 
 	/* Assign delay line to each channel EQ */
-	eq_iir_init_delay(cd->iir, cd->iir_delay, nch);
+	eq_iir_init_delay(iir, *iir_delay, nch);
 	return 0;
 }
 
+int eq_iir_setup(struct processing_module *mod, int nch, struct eq_iir_update *update)
+{
+	struct comp_data *cd = module_get_private_data(mod);
+	int32_t *iir_delay = cd->iir_delay;
+	size_t iir_delay_size = cd->iir_delay_size;
+
+	if (!update) {
+		/* Free existing IIR channels data if it was allocated */
+		eq_iir_free_delaylines(cd);
+
+		return eq_iir_build(mod, cd->config, cd->iir, &cd->iir_delay,
+				    &cd->iir_delay_size, nch);
+	}
+
+	/* Take over the filters prepared in IPC context. The update gets
+	 * the old delay lines so that they are freed with it, outside of
+	 * the audio thread.
+	 */
+	memcpy_s(cd->iir, sizeof(cd->iir), update->iir, sizeof(update->iir));
+	cd->iir_delay = update->iir_delay;
+	cd->iir_delay_size = update->iir_delay_size;
+	update->iir_delay = iir_delay;
+	update->iir_delay_size = iir_delay_size;
+	return 0;
+}
+
+static void eq_iir_release_update(struct comp_dev *dev, void *state)
+{
+	struct eq_iir_update *update = state;
+
+	rfree(update->iir_delay);
+	rfree(update);
+}
+
+static int eq_iir_prepare_update(struct comp_dev *dev, const void *data,
+				 uint32_t data_size, void **state)
+{
+	struct processing_module *mod = comp_mod(dev);
+	struct comp_data *cd = module_get_private_data(mod);
+	struct eq_iir_update *update;
+	int ret;
+
+	update = rzalloc(SOF_MEM_FLAG_USER, sizeof(*update));
+	if (!update)
+		return -ENOMEM;
+
+	ret = eq_iir_build(mod, (struct sof_eq_iir_config *)data, update->iir,
+			   &update->iir_delay, &update->iir_delay_size, cd->channels);
+	if (ret < 0) {
+		eq_iir_release_update(dev, update);
+		return ret;
+	}
+
+	*state = update;
+	return 0;
+}
+
+const struct comp_data_blob_prepare_ops eq_iir_prepare_ops = {
+	.prepare = eq_iir_prepare_update,
+	.release = eq_iir_release_update,
+};
+
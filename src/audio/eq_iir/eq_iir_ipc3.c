@@ -300,11 +300,11 @@ static int eq_iir_verify_params(struct comp_dev *dev,
 
 int eq_iir_new_blob(struct processing_module *mod, struct comp_data *cd,
 		    enum sof_ipc_frame source_format, enum sof_ipc_frame sink_format,
-		    int channels)
+		    int channels, struct eq_iir_update *update)
 {
 	int ret;
 
-	ret = eq_iir_setup(mod, channels);
+	ret = eq_iir_setup(mod, channels, update);
 	if (ret < 0) {
 		comp_err(mod->dev, "eq_iir_new_blob(), failed IIR setup");
 		return ret;
@@ -459,6 +459,11 @@ static int igo_nr_init(struct processing_module *mod)
 
 	/* update downstream (playback) or upstream (capture) buffer parameters */
 	mod->verify_params_flags = BUFF_PARAMS_RATE;
+
+#ifdef CONFIG_COMP_IGO_NR_DP_BATCH_PERIODS
+	/* noise reduction is not latency critical, run several frames per DP wake-up */
+	mod->dp_batch_periods = CONFIG_COMP_IGO_NR_DP_BATCH_PERIODS;
+#endif
 	comp_info(dev, "igo_nr created");
 	return 0;
 
@@ -122,6 +122,7 @@ static int kpb_register_client(struct comp_data *kpb, struct kpb_client *cli);
 #endif
 static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli);
 static enum task_state kpb_draining_task(void *arg);
+static size_t kpb_drain_history(struct comp_data *kpb, struct draining_data *dd);
 static int kpb_buffer_data(struct comp_dev *dev,
 			   const struct comp_buffer *source, size_t size);
 static size_t kpb_allocate_history_buffer(struct comp_data *kpb,
@@ -554,6 +555,38 @@ static struct comp_dev *kpb_new(const struct comp_driver *drv,
 	return dev;
 }
 
+/**
+ * \brief Convert history buffer bytes to stream bytes.
+ * \param[in] kpb - KPB component data pointer.
+ * \param[in] bytes - amount of bytes stored in history buffer.
+ *
+ * \return: amount of stream bytes represented by history bytes.
+ */
+static inline size_t kpb_hist_to_stream(const struct comp_data *kpb,
+					size_t bytes)
+{
+	if (kpb->hd.packed)
+		return bytes / KPB_PACKED_SAMPLE_BYTES * sizeof(int32_t);
+
+	return bytes;
+}
+
+/**
+ * \brief Convert stream bytes to history buffer bytes.
+ * \param[in] kpb - KPB component data pointer.
+ * \param[in] bytes - amount of stream bytes.
+ *
+ * \return: amount of history bytes needed to store stream bytes.
+ */
+static inline size_t kpb_stream_to_hist(const struct comp_data *kpb,
+					size_t bytes)
+{
+	if (kpb->hd.packed)
+		return bytes / sizeof(int32_t) * KPB_PACKED_SAMPLE_BYTES;
+
+	return bytes;
+}
+
 /**
  * \brief Allocate history buffer.
  * \param[in] kpb - KPB component data pointer.
@@ -566,7 +599,7 @@ static size_t kpb_allocate_history_buffer(struct comp_data *kpb,
 	struct history_buffer *hb;
 	struct history_buffer *new_hb = NULL;
 	/*! Total allocation size */
-	size_t hb_size = hb_size_req;
+	size_t hb_size = kpb_stream_to_hist(kpb, hb_size_req);
 	/*! Current allocation size */
 	size_t ca_size = hb_size;
 	/*! Memory caps priorites for history buffer */
@@ -642,6 +675,9 @@ static size_t kpb_allocate_history_buffer(struct comp_data *kpb,
 			 */
 			temp_ca_size = ca_size - KPB_ALLOCATION_STEP;
 			ca_size = (ca_size < temp_ca_size) ? 0 : temp_ca_size;
+			/* Don't split packed samples between blocks */
+			if (kpb->hd.packed)
+				ca_size -= ca_size % KPB_PACKED_SAMPLE_BYTES;
 			if (ca_size == 0) {
 				ca_size = hb_size;
 				i++;
@@ -653,7 +689,7 @@ static size_t kpb_allocate_history_buffer(struct comp_data *kpb,
 	comp_cl_info(&comp_kpb, "allocated %zu bytes for history buffer",
 		     allocated_size);
 
-	return allocated_size;
+	return kpb_hist_to_stream(kpb, allocated_size);
 }
 
 /**
@@ -805,6 +841,8 @@ static int kpb_prepare(struct comp_dev *dev)
 	int ret = 0;
 	int i;
 	size_t hb_size_req = KPB_MAX_BUFFER_SIZE(kpb->config.sampling_width, kpb->config.channels);
+	bool packed = IS_ENABLED(CONFIG_KPB_HISTORY_PACKED) &&
+		      kpb->config.sampling_width == 32;
 
 	comp_dbg(dev, "kpb_prepare()");
 
@@ -842,7 +880,8 @@ static int kpb_prepare(struct comp_dev *dev)
 	kpb->kpb_no_of_clients = 0;
 	kpb->hd.buffered = 0;
 
-	if (kpb->hd.c_hb && kpb->hd.buffer_size < hb_size_req) {
+	if (kpb->hd.c_hb && (kpb->hd.buffer_size < hb_size_req ||
+			     kpb->hd.packed != packed)) {
 		/* Host params has changed, we need to allocate new buffer */
 		kpb_free_history_buffer(kpb->hd.c_hb);
 		kpb->hd.c_hb = NULL;
@@ -850,6 +889,7 @@ static int kpb_prepare(struct comp_dev *dev)
 
 	if (!kpb->hd.c_hb) {
 		/* Allocate history buffer */
+		kpb->hd.packed = packed;
 		kpb->hd.buffer_size = kpb_allocate_history_buffer(kpb,
 								  hb_size_req);
 
@@ -1354,8 +1394,9 @@ static int kpb_copy(struct comp_dev *dev)
 		break;
 	case KPB_STATE_INIT_DRAINING:
 	case KPB_STATE_DRAINING:
-		/* In draining and init draining we only buffer data in
-		 * the internal history buffer.
+		/* In draining and init draining we buffer data in the internal
+		 * history buffer. While draining the history buffer is also
+		 * copied to host sink, see kpb_drain_history().
 		 */
 		avail_bytes = audio_stream_get_avail_bytes(&source->stream);
 		copy_bytes = MIN(avail_bytes, kpb->hd.free);
@@ -1378,6 +1419,33 @@ static int kpb_copy(struct comp_dev *dev)
 				  kpb->hd.free);
 		}
 
+		if (kpb->state != KPB_STATE_DRAINING)
+			break;
+
+		/* Real time data buffered meanwhile needs to be drained too */
+		dd->drain_req += dd->buffered_while_draining;
+		dd->buffered_while_draining = 0;
+
+		sink = kpb->host_sink;
+		if (!sink) {
+			comp_err(dev, "no sink.");
+			ret = -EINVAL;
+			break;
+		}
+
+		kpb_drain_history(kpb, dd);
+		if (!dd->drain_req) {
+			/* Draining is done. Now switch KPB to copy real time
+			 * stream to client's sink. This state is called
+			 * "draining on demand".
+			 */
+			kpb_change_state(kpb, KPB_STATE_HOST_COPY);
+		}
+
+		/* Let host copy run even with nothing drained so it can
+		 * update its pointers, same as in host copy state.
+		 */
+		ret = 0;
 		break;
 	default:
 		comp_cl_err(&comp_kpb, "wrong state (state %d, state log %x)",
@@ -1457,7 +1525,8 @@ static int kpb_buffer_data(struct comp_dev *dev,
 		}
 
 		/* Check how much space there is in current write buffer */
-		space_avail = (uintptr_t)buff->end_addr - (uintptr_t)buff->w_ptr;
+		space_avail = kpb_hist_to_stream(kpb, (uintptr_t)buff->end_addr -
+						 (uintptr_t)buff->w_ptr);
 
 		if (size_to_copy > space_avail) {
 			/* We have more data to copy than available space
@@ -1467,7 +1536,8 @@ static int kpb_buffer_data(struct comp_dev *dev,
 			kpb_buffer_samples(&source->stream, offset, buff->w_ptr,
 					   space_avail, sample_width);
 			/* Update write pointer & requested copy size */
-			buff->w_ptr = (char *)buff->w_ptr + space_avail;
+			buff->w_ptr = (char *)buff->w_ptr +
+				      kpb_stream_to_hist(kpb, space_avail);
 			size_to_copy = size_to_copy - space_avail;
 			/* Update read pointer's offset before continuing
 			 * with next buffer.
@@ -1481,7 +1551,8 @@ static int kpb_buffer_data(struct comp_dev *dev,
 			kpb_buffer_samples(&source->stream, offset, buff->w_ptr,
 					   size_to_copy, sample_width);
 			/* Update write pointer & requested copy size */
-			buff->w_ptr = (char *)buff->w_ptr + size_to_copy;
+			buff->w_ptr = (char *)buff->w_ptr +
+				      kpb_stream_to_hist(kpb, size_to_copy);
 			/* Reset requested copy size */
 			size_to_copy = 0;
 		}
@@ -1614,6 +1685,7 @@ static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 			       (KPB_SAMPLE_CONTAINER_SIZE(sample_width) / 8);
 	struct history_buffer *buff = kpb->hd.c_hb;
 	struct history_buffer *first_buff = buff;
+	size_t hist_drain_req = kpb_stream_to_hist(kpb, drain_req);
 	size_t buffered = 0;
 	size_t local_buffered;
 	size_t drain_interval;
@@ -1669,10 +1741,10 @@ static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 				comp_err(dev, "incorrect buffer label");
 			}
 			/* Check if this is already sufficient to start draining
-			 * if not, go to previous buffer and continue
-			 * calculations.
+			 * (in history buffer bytes), if not, go to previous
+			 * buffer and continue calculations.
 			 */
-			if (drain_req > buffered) {
+			if (hist_drain_req > buffered) {
 				if (buff->prev == first_buff) {
 					/* We went full circle and still don't
 					 * have sufficient data for draining.
@@ -1685,16 +1757,16 @@ static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 					buffered += (uintptr_t)buff->end_addr -
 						    (uintptr_t)buff->w_ptr;
 					buff->r_ptr = (char *)buff->w_ptr +
-						      (buffered - drain_req);
+						      (buffered - hist_drain_req);
 					break;
 				}
 				buff = buff->prev;
-			} else if (drain_req == buffered) {
+			} else if (hist_drain_req == buffered) {
 				buff->r_ptr = buff->start_addr;
 				break;
 			} else {
 				buff->r_ptr = (char *)buff->start_addr +
-					      (buffered - drain_req);
+					      (buffered - hist_drain_req);
 				break;
 			}
 
@@ -1732,9 +1804,8 @@ static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 		kpb->draining_task_data.drained = 0;
 		kpb->draining_task_data.sample_width = sample_width;
 		kpb->draining_task_data.drain_interval = drain_interval;
-		kpb->draining_task_data.period_copy_start = 0;
 		kpb->draining_task_data.pb_limit = period_bytes_limit;
-		kpb->draining_task_data.period_bytes = 0;
+		kpb->draining_task_data.granted = 0;
 		kpb->draining_task_data.next_copy_time = 0;
 		kpb->draining_task_data.dev = dev;
 		kpb->draining_task_data.sync_mode_on = kpb->sync_draining_mode;
@@ -1814,9 +1885,87 @@ static void adjust_drain_interval(struct comp_data *kpb, struct draining_data *d
 	dd->prev_adjustment_drained = dd->drained;
 }
 
+/**
+ * \brief Drain history buffer to host sink.
+ *
+ * Called from kpb_copy() in LL context, which is the only place touching
+ * the host sink and the draining cursors, so no locking is needed against
+ * the draining task. In sync mode the amount is limited by what the
+ * draining task has granted so far. When the sink fills up, host copy is
+ * run to empty it, up to KPB_DRAIN_MAX_SINK_FILLS sink buffers per call.
+ *
+ * \param[in] kpb - KPB component data pointer.
+ * \param[in] dd - draining data.
+ *
+ * \return: number of bytes drained.
+ */
+static size_t kpb_drain_history(struct comp_data *kpb, struct draining_data *dd)
+{
+	struct comp_buffer *sink = dd->sink;
+	struct history_buffer *buff = dd->hb;
+	size_t budget = dd->drain_req;
+	size_t total = 0;
+	size_t avail;
+	size_t sink_free;
+	size_t size_to_copy;
+	int fills = 1;
+
+	if (dd->sync_mode_on)
+		budget = MIN(budget, dd->granted - dd->drained);
+
+	while (budget) {
+		avail = kpb_hist_to_stream(kpb, (uintptr_t)buff->end_addr -
+					   (uintptr_t)buff->r_ptr);
+		sink_free = audio_stream_get_free_bytes(&sink->stream);
+		size_to_copy = MIN(avail, MIN(budget, sink_free));
+		/* Packed history can only be drained in whole samples */
+		size_to_copy = kpb_hist_to_stream(kpb, kpb_stream_to_hist(kpb, size_to_copy));
+		if (!size_to_copy) {
+			if (sink_free >= MIN(avail, budget) || fills++ == KPB_DRAIN_MAX_SINK_FILLS)
+				break;
+
+			/* Sink is full, let host component move the data out
+			 * so more history can be drained in this run.
+			 */
+			comp_copy(comp_buffer_get_sink_component(sink));
+			continue;
+		}
+
+		kpb_drain_samples(buff->r_ptr, &sink->stream, size_to_copy,
+				  dd->sample_width);
+		comp_update_buffer_produce(sink, size_to_copy);
+
+		buff->r_ptr = (char *)buff->r_ptr +
+			      (uint32_t)kpb_stream_to_hist(kpb, size_to_copy);
+		kpb->hd.free += MIN(kpb->hd.buffer_size -
+				    kpb->hd.free, size_to_copy);
+		budget -= size_to_copy;
+		total += size_to_copy;
+
+		/* no data left in the current buffer -- switch to the next buffer */
+		if (size_to_copy == avail) {
+			buff->r_ptr = buff->start_addr;
+			buff = buff->next;
+		}
+	}
+
+	dd->hb = buff;
+	dd->drain_req -= total;
+	dd->drained += total;
+
+	return total;
+}
+
 /**
  * \brief Draining task.
  *
+ * The task only paces draining, the data is moved by kpb_copy() in LL
+ * context. In sync mode a new host period worth of data is granted each
+ * drain_interval, once the previous grant has been fully drained, so the
+ * draining follows host read progress. Periods which fell due meanwhile
+ * are granted together, up to KPB_DRAIN_MAX_SINK_FILLS. The task completes
+ * once LL copy has drained everything and left the draining state.
+ *
  * \param[in] arg - pointer keeping drainig data previously prepared
  * by kpb_init_draining().
  *
@@ -1825,133 +1974,57 @@ static void adjust_drain_interval(struct comp_data *kpb, struct draining_data *d
 static enum task_state kpb_draining_task(void *arg)
 {
 	struct draining_data *draining_data = (struct draining_data *)arg;
-	struct comp_buffer *sink = draining_data->sink;
-	struct history_buffer *buff = draining_data->hb;
-	size_t sample_width = draining_data->sample_width;
-	size_t avail;
-	size_t size_to_copy;
 	uint64_t draining_time_end;
 	uint64_t draining_time_ms;
-	size_t period_bytes_limit = draining_data->pb_limit;
-	size_t *rt_stream_update = &draining_data->buffered_while_draining;
+	uint64_t periods;
+	uint64_t now;
 	struct comp_data *kpb = comp_get_drvdata(draining_data->dev);
-	bool sync_mode_on = draining_data->sync_mode_on;
-
-	/*
-	 * WORKAROUND: The code below accesses KPB sink buffer and calls comp_copy() on
-	 * component connected to sink. EDF task thread has preemptible low priority and
-	 * so can be preempted by LL thread. This could result in broken state of sink buffer
-	 * or component connected to sink.
-	 * Hence k_sched_lock() is used temporary to block LL from preempting EDF task thread.
-	 */
-#ifdef __ZEPHYR__
-	k_sched_lock();
-#endif
 
 	comp_cl_dbg(&comp_kpb, "kpb_draining_task()");
 
 	/* Have we received reset request? */
 	if (kpb->state == KPB_STATE_RESETTING) {
+		/* Reset clears the history buffer and the sinks kpb_copy() works
+		 * on, keep LL from preempting it.
+		 */
+#ifdef __ZEPHYR__
+		k_sched_lock();
+#endif
 		kpb_change_state(kpb, KPB_STATE_RESET_FINISHING);
 		kpb_reset(draining_data->dev);
-		draining_data->drain_req = 0;
-		goto out;
-	}
-
-	adjust_drain_interval(kpb, draining_data);
-
-	if (draining_data->drain_req > 0) {
-		/* Are we ready to drain further or host still need some time
-		 * to read the data already provided?
-		 */
-		if (sync_mode_on && draining_data->next_copy_time > sof_cycle_get_64()) {
-			/* Restore original EDF thread priority */
 #ifdef __ZEPHYR__
-			k_sched_unlock();
+		k_sched_unlock();
 #endif
-			return SOF_TASK_STATE_RESCHEDULE;
-		}
-
-		if (draining_data->period_copy_start == 0) {
-			/* starting new draining period */
-			draining_data->period_copy_start = sof_cycle_get_64();
-			draining_data->period_bytes = 0;
-		}
-
-		avail = (uintptr_t)buff->end_addr - (uintptr_t)buff->r_ptr;
-		size_to_copy = MIN(avail,
-				   MIN(draining_data->drain_req,
-				       audio_stream_get_free_bytes(&sink->stream)));
-
-		kpb_drain_samples(buff->r_ptr, &sink->stream, size_to_copy,
-				  sample_width);
-
-		buff->r_ptr = (char *)buff->r_ptr + (uint32_t)size_to_copy;
-		draining_data->drain_req -= size_to_copy;
-		draining_data->drained += size_to_copy;
-		draining_data->period_bytes += size_to_copy;
-		kpb->hd.free += MIN(kpb->hd.buffer_size -
-				    kpb->hd.free, size_to_copy);
-
-		/* no data left in the current buffer -- switch to the next buffer */
-		if (size_to_copy == avail) {
-			buff->r_ptr = buff->start_addr;
-			draining_data->hb = buff->next;
-		}
-
-		if (size_to_copy) {
-			comp_update_buffer_produce(sink, size_to_copy);
-			comp_copy(comp_buffer_get_sink_component(sink));
-		} else if (!audio_stream_get_free_bytes(&sink->stream)) {
-			/* There is no free space in sink buffer.
-			 * Call .copy() on sink component so it can
-			 * process its data further.
-			 */
-			comp_copy(comp_buffer_get_sink_component(sink));
-		}
+		goto out;
+	}
 
-		if (sync_mode_on && draining_data->period_bytes >= period_bytes_limit) {
-			draining_data->next_copy_time = draining_data->period_copy_start +
-				draining_data->drain_interval;
-			draining_data->period_copy_start = 0;
-		} else {
-			draining_data->next_copy_time = 0;
-		}
+	if (kpb->state == KPB_STATE_DRAINING) {
+		adjust_drain_interval(kpb, draining_data);
 
-		if (draining_data->drain_req == 0) {
-		/* We have finished draining of requested data however
-		 * while we were draining real time stream could provided
-		 * new data which needs to be copy to host.
-		 */
-			comp_cl_info(&comp_kpb, "kpb: update drain_req by %zu",
-				     *rt_stream_update);
-			kpb_lock(kpb);
-			draining_data->drain_req += *rt_stream_update;
-			*rt_stream_update = 0;
-			if (!draining_data->drain_req && kpb->state == KPB_STATE_DRAINING) {
-			/* Draining is done. Now switch KPB to copy real time
-			 * stream to client's sink. This state is called
-			 * "draining on demand"
-			 * Note! If KPB state changed during draining due to
-			 * i.e reset request we should not change that state.
+		now = sof_cycle_get_64();
+		if (!draining_data->sync_mode_on) {
+			/* unlimited draining, just check for completion */
+			draining_data->next_copy_time = now + k_ms_to_cyc_ceil64(1);
+		} else if (draining_data->next_copy_time <= now &&
+			   draining_data->drained >= draining_data->granted) {
+			/* Host has read the whole previous grant, release the
+			 * periods due since then, at most as many as LL copy
+			 * can drain in one run.
 			 */
-				kpb_change_state(kpb, KPB_STATE_HOST_COPY);
-			}
-			kpb_unlock(kpb);
+			periods = 1;
+			if (draining_data->drain_interval)
+				periods += (now - draining_data->next_copy_time) /
+					   draining_data->drain_interval;
+			periods = MIN(periods, KPB_DRAIN_MAX_SINK_FILLS);
+			draining_data->granted += periods * draining_data->pb_limit;
+			draining_data->next_copy_time = now + draining_data->drain_interval;
 		}
-	}
-
-out:
-	if (draining_data->drain_req > 0) {
-		/* Restore original EDF thread priority */
-#ifdef __ZEPHYR__
-		k_sched_unlock();
-#endif
 
 		/* continue drainig on next task iteration */
 		return SOF_TASK_STATE_RESCHEDULE;
 	}
 
+out:
 	/* finished drainig */
 	draining_time_end = sof_cycle_get_64();
 
@@ -1974,11 +2047,6 @@ out:
 		comp_cl_info(&comp_kpb, "KPB: kpb_draining_task(), done. %zu drained in > %u ms",
 			     draining_data->drained, UINT_MAX);
 
-	/* Restore original EDF thread priority */
-#ifdef __ZEPHYR__
-	k_sched_unlock();
-#endif
-
 	return SOF_TASK_STATE_COMPLETED;
 }
 
@@ -2055,6 +2123,66 @@ static void kpb_convert_24b_to_32b(const void *source, int ioffset,
 	}
 }
 #endif
+
+#if CONFIG_KPB_HISTORY_PACKED
+/* Packed history keeps the 24 significant bits of each 32-bit container,
+ * bits 23..0 of S24_4LE and bits 31..8 of S32_LE samples.
+ */
+static inline int kpb_packed_shift(const struct audio_stream *stream)
+{
+	return audio_stream_get_frm_fmt(stream) == SOF_IPC_FRAME_S32_LE ? 8 : 0;
+}
+
+static void kpb_pack_samples(const struct audio_stream *source, int ioffset,
+			     void *sink, unsigned int samples)
+{
+	int shift = kpb_packed_shift(source);
+	int32_t *src = audio_stream_wrap(source, (uint8_t *)audio_stream_get_rptr(source) +
+					 ioffset * sizeof(int32_t));
+	uint8_t *dst = sink;
+	uint32_t sample;
+	unsigned int i, n;
+
+	while (samples) {
+		src = audio_stream_wrap(source, src);
+		n = KPB_BYTES_TO_S32_SAMPLES(audio_stream_bytes_without_wrap(source, src));
+		n = MIN(n, samples);
+		for (i = 0; i < n; i++) {
+			sample = (uint32_t)*src++ >> shift;
+			dst[0] = sample & 0xFF;
+			dst[1] = (sample >> 8) & 0xFF;
+			dst[2] = (sample >> 16) & 0xFF;
+			dst += KPB_PACKED_SAMPLE_BYTES;
+		}
+		samples -= n;
+	}
+}
+
+static void kpb_unpack_samples(const void *source, struct audio_stream *sink,
+			       unsigned int samples)
+{
+	int shift = kpb_packed_shift(sink);
+	const uint8_t *src = source;
+	int32_t *dst = audio_stream_get_wptr(sink);
+	int32_t sample;
+	unsigned int i, n;
+
+	while (samples) {
+		dst = audio_stream_wrap(sink, dst);
+		n = KPB_BYTES_TO_S32_SAMPLES(audio_stream_bytes_without_wrap(sink, dst));
+		n = MIN(n, samples);
+		for (i = 0; i < n; i++) {
+			/* place the 24 bits at the top, sign extend down if needed */
+			sample = (int32_t)(((uint32_t)src[2] << 24) | (src[1] << 16) |
+					   (src[0] << 8));
+			*dst++ = shift ? sample : sample >> 8;
+			src += KPB_PACKED_SAMPLE_BYTES;
+		}
+		samples -= n;
+	}
+}
+#endif /* CONFIG_KPB_HISTORY_PACKED */
+
 /**
  * \brief Drain data samples safe, according to configuration.
  *
@@ -2083,7 +2211,11 @@ static void kpb_drain_samples(void *source, struct audio_stream *sink,
 		break;
 	case 32:
 		samples = KPB_BYTES_TO_S32_SAMPLES(size);
+#if CONFIG_KPB_HISTORY_PACKED
+		kpb_unpack_samples(source, sink, samples);
+#else
 		audio_stream_copy_from_linear(source, 0, sink, 0, samples);
+#endif
 		break;
 #endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
 	default:
@@ -2190,8 +2322,12 @@ static void kpb_buffer_samples(const struct audio_stream *source,
 	case 32:
 		samples_count = KPB_BYTES_TO_S32_SAMPLES(size);
 		samples_offset = KPB_BYTES_TO_S32_SAMPLES(offset);
+#if CONFIG_KPB_HISTORY_PACKED
+		kpb_pack_samples(source, samples_offset, sink, samples_count);
+#else
 		audio_stream_copy_to_linear(source, samples_offset,
 					    sink, 0, samples_count);
+#endif
 		break;
 #endif
 	default:
@@ -45,6 +45,7 @@ __cold static int level_multiplier_init(struct processing_module *mod)
 		return -ENOMEM;
 
 	md->private = cd;
+	mod->process_in_place = true;
 	cd->gain = LEVEL_MULTIPLIER_GAIN_ONE;
 	return 0;
 }
@@ -189,10 +189,51 @@ static void module_adapter_calculate_dp_period(struct comp_dev *dev)
 
 	}
 
+	/* a batch-processing module is woken once per batch */
+	if (mod->dp_batch_periods > 1)
+		period *= mod->dp_batch_periods;
+
 	dev->period = period;
 }
 #endif /* CONFIG_ZEPHYR_DP_SCHEDULER */
 
+#if CONFIG_COMP_BUFFER_IN_PLACE
+/*
+ * Alias the sink buffer of an in-place LL module onto its source buffer. Only
+ * done when both neighbours are LL modules of the same pipeline, so that the
+ * buffers are idle while the pipeline is prepared and reset. Buffers next to
+ * host endpoints are left alone, the endpoint may map them onto its own memory.
+ */
+static void module_adapter_alias_in_place(struct processing_module *mod)
+{
+	struct comp_dev *dev = mod->dev;
+	struct comp_buffer *source = comp_dev_get_first_data_producer(dev);
+	struct comp_buffer *sink = comp_dev_get_first_data_consumer(dev);
+	struct comp_dev *prev;
+	struct comp_dev *next;
+	int ret;
+
+	if (!mod->process_in_place || dev->ipc_config.proc_domain != COMP_PROCESSING_DOMAIN_LL)
+		return;
+
+	if (!source || !sink || comp_dev_get_next_data_producer(dev, source) ||
+	    comp_dev_get_next_data_consumer(dev, sink))
+		return;
+
+	prev = comp_buffer_get_source_component(source);
+	next = comp_buffer_get_sink_component(sink);
+	if (!prev || !next || prev->pipeline != dev->pipeline || next->pipeline != dev->pipeline ||
+	    prev->ipc_config.proc_domain != COMP_PROCESSING_DOMAIN_LL ||
+	    next->ipc_config.proc_domain != COMP_PROCESSING_DOMAIN_LL ||
+	    dev_comp_type(prev) == SOF_COMP_HOST || dev_comp_type(next) == SOF_COMP_HOST)
+		return;
+
+	ret = buffer_alias(source, sink);
+	if (ret < 0)
+		comp_dbg(dev, "no in-place processing, error %d", ret);
+}
+#endif
+
 /*
  * \brief Prepare the module
  * \param[in] dev - component device pointer.
@@ -271,10 +312,19 @@ int module_adapter_prepare(struct comp_dev *dev)
 			return -EINVAL;
 		}
 
+		if (mod->dp_batch_periods > 1 &&
+		    dev->period > CONFIG_ZEPHYR_DP_MAX_BATCH_PERIOD_US) {
+			comp_err(dev, "DP Module batch of %u periods exceeds latency budget, %u us > %u us",
+				 mod->dp_batch_periods, dev->period,
+				 CONFIG_ZEPHYR_DP_MAX_BATCH_PERIOD_US);
+			return -EINVAL;
+		}
+
 		/* align down period to LL cycle time */
 		dev->period /= LL_TIMER_PERIOD_US;
 		dev->period *= LL_TIMER_PERIOD_US;
-		comp_info(dev, "DP Module period set to %u us", dev->period);
+		comp_info(dev, "DP Module period set to %u us, batch of %u periods", dev->period,
+			  MAX(mod->dp_batch_periods, 1));
 	}
 #endif /* CONFIG_ZEPHYR_DP_SCHEDULER */
 
@@ -309,6 +359,10 @@ int module_adapter_prepare(struct comp_dev *dev)
 	mod->period_bytes = audio_stream_period_bytes(&sink->stream, dev->frames);
 	comp_dbg(dev, "got period_bytes = %u", mod->period_bytes);
 
+#if CONFIG_COMP_BUFFER_IN_PLACE
+	module_adapter_alias_in_place(mod);
+#endif
+
 	/* no more to do for sink/source mode */
 	if (IS_PROCESSING_MODE_SINK_SOURCE(mod))
 		return 0;
@@ -1231,6 +1285,16 @@ int module_adapter_reset(struct comp_dev *dev)
 	mod->total_data_consumed = 0;
 	mod->total_data_produced = 0;
 
+#if CONFIG_COMP_BUFFER_IN_PLACE
+	/* the sink buffer gets its own memory back, params may resize it */
+	if (mod->process_in_place) {
+		struct comp_buffer *sink = comp_dev_get_first_data_consumer(dev);
+
+		if (sink && buffer_unalias(sink) < 0)
+			comp_err(dev, "sink buffer stays aliased for in-place processing");
+	}
+#endif
+
 	list_for_item(blist, &mod->raw_data_buffers_list) {
 		struct comp_buffer *buffer = container_of(blist, struct comp_buffer,
 							  buffers_list);
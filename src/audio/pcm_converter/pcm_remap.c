@@ -5,6 +5,7 @@
 
 #include <sof/audio/pcm_converter.h>
 #include <sof/audio/audio_stream.h>
+#include <sof/audio/channel_remix.h>
 
 static void mute_channel_c16(struct audio_stream *stream, int channel, int frames)
 {
@@ -56,56 +57,22 @@ static int remap_c16(const struct audio_stream *source, uint32_t dummy1,
 		     struct audio_stream *sink, uint32_t dummy2,
 		     uint32_t source_samples, uint32_t chmap)
 {
-	int src_channel, sink_channel;
+	struct channel_remix remix;
 	int num_src_channels = audio_stream_get_channels(source);
-	int num_sink_channels = audio_stream_get_channels(sink);
 	int frames = source_samples / num_src_channels;
-
-	for (sink_channel = 0; sink_channel < num_sink_channels; sink_channel++) {
-		int16_t *src, *dst;
-		int frames_left;
-
-		src_channel = chmap & 0xf;
-		chmap >>= 4;
-
-		if (src_channel == 0xf) {
-			mute_channel_c16(sink, sink_channel, frames);
-			continue;
-		}
-
-		assert(src_channel < num_src_channels);
-
-		src = (int16_t *)audio_stream_get_rptr(source) + src_channel;
-		dst = (int16_t *)audio_stream_get_wptr(sink) + sink_channel;
-
-		frames_left = frames;
-
-		while (frames_left) {
-			int src_samples_wo_wrap, dst_samples_wo_wrap;
-			int src_loops, dst_loops, n, i;
-
-			src = audio_stream_wrap(source, src);
-			dst = audio_stream_wrap(sink, dst);
-
-			src_samples_wo_wrap = audio_stream_samples_without_wrap_s16(source, src);
-			src_loops = SOF_DIV_ROUND_UP(src_samples_wo_wrap, num_src_channels);
-
-			dst_samples_wo_wrap = audio_stream_samples_without_wrap_s16(sink, dst);
-			dst_loops = SOF_DIV_ROUND_UP(dst_samples_wo_wrap, num_sink_channels);
-
-			n = MIN(src_loops, dst_loops);
-			n = MIN(n, frames_left);
-
-			for (i = 0; i < n; i++) {
-				*dst = *src;
-				src += num_src_channels;
-				dst += num_sink_channels;
-			}
-
-			frames_left -= n;
-		}
+	int ch, ret;
+
+	/* a map the remix can't express yields silence rather than stale data */
+	ret = channel_remix_build_chmap(&remix, chmap, audio_stream_get_channels(sink),
+					num_src_channels);
+	if (ret < 0) {
+		for (ch = 0; ch < audio_stream_get_channels(sink); ch++)
+			mute_channel_c16(sink, ch, frames);
+		return source_samples;
 	}
 
+	channel_remix_s16(&remix, source, sink, frames);
+
 	return source_samples;
 }
 
@@ -347,7 +314,23 @@ static int remap_c32(const struct audio_stream *source, uint32_t dummy1,
 		     struct audio_stream *sink, uint32_t dummy2,
 		     uint32_t source_samples, uint32_t chmap)
 {
-	return remap_c32_left_shift(source, sink, source_samples, chmap, 0);
+	struct channel_remix remix;
+	int num_src_channels = audio_stream_get_channels(source);
+	int frames = source_samples / num_src_channels;
+	int ch, ret;
+
+	/* a map the remix can't express yields silence rather than stale data */
+	ret = channel_remix_build_chmap(&remix, chmap, audio_stream_get_channels(sink),
+					num_src_channels);
+	if (ret < 0) {
+		for (ch = 0; ch < audio_stream_get_channels(sink); ch++)
+			mute_channel_c32(sink, ch, frames);
+		return source_samples;
+	}
+
+	channel_remix_s32(&remix, source, sink, frames);
+
+	return source_samples;
 }
 
 static int remap_c32_to_c16_right_shift_16(const struct audio_stream *source, uint32_t dummy1,
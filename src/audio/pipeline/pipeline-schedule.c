@@ -372,9 +372,11 @@ int pipeline_comp_ll_task_init(struct pipeline *p)
 static enum task_state dp_task_run(void *data)
 {
 	struct processing_module *mod = data;
+	uint32_t processed;
+	int ret;
 
-	int ret = module_process_sink_src(mod, mod->sources, mod->num_of_sources,
-					  mod->sinks, mod->num_of_sinks);
+	/* the scheduler has checked the whole batch is queued, process it period by period */
+	ret = module_process_batch(mod, &processed);
 	if (ret)
 		pipeline_comp_copy_error_notify(mod->dev, ret);
 
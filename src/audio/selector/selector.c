@@ -242,6 +242,9 @@ static int selector_ctrl_set_data(struct comp_dev *dev,
 		cd->config.in_channels_count = cfg->in_channels_count;
 		cd->config.out_channels_count = cfg->out_channels_count;
 		cd->config.sel_channel = cfg->sel_channel;
+
+		/* the remix built in prepare() is based on the old selection */
+		cd->coeffs_changed = true;
 		break;
 	default:
 		comp_err(dev, "invalid cdata->cmd = %u",
@@ -391,6 +394,16 @@ static int selector_copy(struct comp_dev *dev)
 	comp_dbg(dev, "selector_copy(), source_bytes = 0x%x, sink_bytes = 0x%x",
 		 source_bytes, sink_bytes);
 
+	/* a new channel selection is applied, the channel counts are fixed */
+	if (cd->coeffs_changed) {
+		cd->coeffs_changed = false;
+		if (cd->config.out_channels_count != audio_stream_get_channels(&sink->stream) ||
+		    sel_build_remix(cd) < 0) {
+			comp_err(dev, "invalid channel selection");
+			return -EINVAL;
+		}
+	}
+
 	/* copy selected channels from in to out */
 	buffer_stream_invalidate(source, source_bytes);
 	cd->sel_func(dev, &sink->stream, &source->stream, frames);
@@ -775,6 +788,7 @@ static int selector_set_config(struct processing_module *mod, uint32_t config_id
 			return -EINVAL;
 
 		memcpy_s(&cd->coeffs_config, sizeof(cd->coeffs_config), fragment, data_offset_size);
+		cd->coeffs_changed = true;
 		return 0;
 	}
 
@@ -804,6 +818,15 @@ static int selector_process(struct processing_module *mod,
 
 	comp_dbg(mod->dev, "selector_process()");
 
+	/* the remix shape may change with the new coefficients */
+	if (cd->coeffs_changed) {
+		cd->coeffs_changed = false;
+		if (sel_build_remix(cd) < 0) {
+			comp_err(mod->dev, "invalid channel count for coefficients");
+			return -EINVAL;
+		}
+	}
+
 	if (avail_frames)
 		/* copy selected channels from in to out */
 		cd->sel_func(mod, input_buffers, output_buffers, avail_frames);
@@ -52,6 +52,11 @@ int RegisterOps(MicroSpeechOpResolver *op_resolver) {
 
 int TF_InitOps(struct tf_classify *tfc)
 {
+	// drop the interpreter of a previous model
+	delete interpreter;
+	delete op_resolver;
+	interpreter = nullptr;
+
 	op_resolver = new MicroSpeechOpResolver();
 	if (RegisterOps(op_resolver) != 0) {
 		tfc->error = "register ops failed";
@@ -106,11 +111,11 @@ static int Init_Interpreter(struct tf_classify *tfc)
 
 int TF_SetModel(struct tf_classify *tfc, unsigned char *model_tflite)
 {
-	// ignore passed in model today until we can load via binary kcontrol
-
 	// Map the model into a usable data structure. This doesn't involve any
-	// copying or parsing, it's a very lightweight operation.
-	model = tflite::GetModel(g_micro_speech_quantized_model_data);
+	// copying or parsing, it's a very lightweight operation. The built in
+	// model is used until one is loaded via binary kcontrol.
+	model = tflite::GetModel(model_tflite ? model_tflite :
+				 g_micro_speech_quantized_model_data);
 	if (model->version() != TFLITE_SCHEMA_VERSION) {
 		tfc->error = "failed to load model";
 		return -EINVAL;
@@ -46,8 +46,70 @@ static const char * const prediction[] = TFLM_CATEGORY_DATA;
 struct tflm_comp_data {
 	struct comp_data_blob_handler *model_handler;
 	struct tf_classify tfc;
+	uint8_t *model;		/* model loaded over bytes control, NULL for default */
+	uint8_t *model_new;	/* model being received */
 };
 
+/*
+ * Models are too big to be staged by the data blob handler and copied again,
+ * so fragments are written straight to the buffer the model will run from.
+ */
+static int tflm_model_stream(struct comp_dev *dev, enum module_cfg_fragment_position pos,
+			     uint32_t data_size, uint32_t offset,
+			     const uint8_t *fragment, size_t fragment_size)
+{
+	struct tflm_comp_data *cd = module_get_private_data(comp_mod(dev));
+	int ret;
+
+	if (pos == MODULE_CFG_FRAGMENT_FIRST || pos == MODULE_CFG_FRAGMENT_SINGLE) {
+		if (dev->state == COMP_STATE_ACTIVE) {
+			comp_err(dev, "model can not be changed while active");
+			return -EBUSY;
+		}
+
+		rfree(cd->model_new);
+		cd->model_new = rballoc(SOF_MEM_FLAG_USER, data_size);
+		if (!cd->model_new) {
+			comp_err(dev, "failed to allocate %u bytes for model", data_size);
+			return -ENOMEM;
+		}
+	}
+
+	ret = memcpy_s(cd->model_new + offset, data_size - offset, fragment, fragment_size);
+	if (ret)
+		goto err;
+
+	if (pos != MODULE_CFG_FRAGMENT_SINGLE && pos != MODULE_CFG_FRAGMENT_LAST)
+		return 0;
+
+	ret = TF_SetModel(&cd->tfc, cd->model_new);
+	if (ret < 0) {
+		comp_err(dev, "failed to set model: %s", cd->tfc.error);
+		TF_SetModel(&cd->tfc, cd->model);
+		goto err;
+	}
+
+	ret = TF_InitOps(&cd->tfc);
+	if (ret < 0) {
+		comp_err(dev, "failed to init ops: %s", cd->tfc.error);
+		/* go back to the previous model */
+		TF_SetModel(&cd->tfc, cd->model);
+		TF_InitOps(&cd->tfc);
+		goto err;
+	}
+
+	rfree(cd->model);
+	cd->model = cd->model_new;
+	cd->model_new = NULL;
+
+	return 0;
+
+err:
+	rfree(cd->model_new);
+	cd->model_new = NULL;
+	return ret;
+}
+
 __cold static int tflm_init(struct processing_module *mod)
 {
 	struct module_data *md = &mod->priv;
@@ -75,6 +137,8 @@ __cold static int tflm_init(struct processing_module *mod)
 		goto cd_fail;
 	}
 
+	comp_data_blob_set_stream(cd->model_handler, tflm_model_stream);
+
 	/* Get configuration data and reset DRC state */
 	ret = comp_init_data_blob(cd->model_handler, bs, cfg->data);
 	if (ret < 0) {
@@ -113,6 +177,8 @@ __cold static int tflm_free(struct processing_module *mod)
 	assert_can_be_cold();
 
 	comp_data_blob_handler_free(cd->model_handler);
+	rfree(cd->model_new);
+	rfree(cd->model);
 	rfree(cd);
 	return 0;
 }
@@ -133,11 +199,10 @@ __cold static int tflm_set_config(struct processing_module *mod, uint32_t param_
 	struct sof_ipc4_control_msg_payload *ctl = (struct sof_ipc4_control_msg_payload *)fragment;
 
 	comp_info(dev, "tflm_set_config(), bytes control");
+	/* the model is loaded by tflm_model_stream() */
 	ret = comp_data_blob_set(cd->model_handler, pos, data_offset_size, fragment,
 				 fragment_size);
 
-	/* TODO: now load the model from the blob */
-
 	return ret;
 }
 
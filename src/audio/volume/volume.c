@@ -284,6 +284,7 @@ static inline void volume_ramp(struct processing_module *mod)
 {
 	struct vol_data *cd = module_get_private_data(mod);
 	struct comp_dev *dev = mod->dev;
+	bool was_shortcut = cd->is_passthrough || cd->is_muted;
 	int32_t new_vol;
 	int32_t tvolume;
 	int32_t volume;
@@ -357,7 +358,17 @@ static inline void volume_ramp(struct processing_module *mod)
 		}
 	}
 
-	if (cd->is_passthrough)
+	/* Peak meters measure the input, so silence can't skip reading it */
+	cd->is_muted = cd->ramp_finished && !IS_ENABLED(CONFIG_COMP_PEAK_VOL);
+	for (i = 0; i < cd->channels; i++) {
+		if (cd->volume[i]) {
+			cd->is_muted = false;
+			break;
+		}
+	}
+
+	/* Unity and zero gain have dedicated functions, switch on entering or leaving them */
+	if (cd->is_passthrough || cd->is_muted || was_shortcut)
 		set_volume_process(cd, dev, true);
 }
 
@@ -380,6 +391,7 @@ void volume_reset_state(struct vol_data *cd)
 	cd->sample_rate_inv = 0;
 	cd->copy_gain = true;
 	cd->is_passthrough = false;
+	cd->is_muted = false;
 
 #if CONFIG_COMP_PEAK_VOL
 	memset(cd->peak_regs.peak_meter, 0, sizeof(cd->peak_regs.peak_meter));
@@ -195,6 +195,7 @@ struct vol_data {
 	bool copy_gain;				/**< control copy gain or not */
 	uint32_t attenuation;			/**< peakmeter adjustment in range [0 - 31] */
 	bool is_passthrough;			/**< is passthrough or do gain multiplication */
+	bool is_muted;				/**< all channels at zero gain, output silence */
 	uint32_t ramp_channel_counter;		/**< channels need new ramp volume */
 };
 
@@ -217,6 +218,17 @@ struct comp_zc_func_map {
 	vol_zc_func func;	/**< volume zc function */
 };
 
+/**
+ * \brief Writes silence for all channels, bit exact with zero gain.
+ * \param[in,out] mod Volume processing module handle
+ * \param[in,out] source Input buffer.
+ * \param[in,out] sink Destination buffer.
+ * \param[in] frames Number of frames to process.
+ * \param[in] attenuation factor for peakmeter adjustment (unused)
+ */
+void vol_silence(struct processing_module *mod, struct input_stream_buffer *source,
+		 struct output_stream_buffer *sink, uint32_t frames, uint32_t attenuation);
+
 #if CONFIG_IPC_MAJOR_3
 /**
  * \brief Retrievies volume processing function.
@@ -235,6 +247,8 @@ static inline vol_scale_func vol_get_processing_function(struct comp_dev *dev,
 		if (audio_stream_get_frm_fmt(&sinkb->stream) != volume_func_map[i].frame_fmt)
 			continue;
 
+		if (cd->is_muted)
+			return vol_silence;
 		if (cd->is_passthrough)
 			return volume_func_map[i].passthrough_func;
 		else
@@ -255,6 +269,9 @@ static inline vol_scale_func vol_get_processing_function(struct comp_dev *dev,
 {
 	struct processing_module *mod = comp_mod(dev);
 
+	if (cd->is_muted)
+		return vol_silence;
+
 	if (cd->is_passthrough) {
 		switch (mod->priv.cfg.base_cfg.audio_fmt.valid_bit_depth) {
 		case IPC4_DEPTH_16BIT:
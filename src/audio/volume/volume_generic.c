@@ -337,3 +337,23 @@ const size_t volume_func_count = ARRAY_SIZE(volume_func_map);
 
 #endif
 #endif
+
+/* Shared by all implementations, there's nothing to vectorize in writing zeros */
+void vol_silence(struct processing_module *mod, struct input_stream_buffer *bsource,
+		 struct output_stream_buffer *bsink, uint32_t frames, uint32_t attenuation)
+{
+	struct audio_stream *sink = bsink->data;
+	uint32_t bytes = frames * audio_stream_frame_bytes(sink);
+	uint8_t *y = audio_stream_wrap(sink, (uint8_t *)audio_stream_get_wptr(sink) + bsink->size);
+	uint32_t n;
+
+	/* volume doesn't convert formats, source frames are the same size */
+	bsource->consumed += bytes;
+	bsink->size += bytes;
+	while (bytes) {
+		n = MIN(bytes, audio_stream_bytes_without_wrap(sink, y));
+		memset(y, 0, n);
+		bytes -= n;
+		y = audio_stream_wrap(sink, y + n);
+	}
+}
@@ -97,7 +97,9 @@ int volume_init(struct processing_module *mod)
 	}
 
 	md->private = cd;
+	mod->process_in_place = true;
 	cd->is_passthrough = false;
+	cd->is_muted = false;
 
 	/* Set the default volumes. If IPC sets min_value or max_value to
 	 * not-zero, use them. Otherwise set to internal limits and notify
@@ -155,6 +155,7 @@ int volume_init(struct processing_module *mod)
 	}
 
 	md->private = cd;
+	mod->process_in_place = true;
 
 	for (channel = 0; channel < channels_count; channel++) {
 		if (vol->config[0].channel_id == IPC4_ALL_CHANNELS_MASK)
@@ -183,6 +184,7 @@ int volume_init(struct processing_module *mod)
 
 	cd->attenuation = 0;
 	cd->is_passthrough = false;
+	cd->is_muted = false;
 
 	volume_reset_state(cd);
 
@@ -254,6 +256,7 @@ static int volume_set_volume(struct processing_module *mod, const uint8_t *data,
 	}
 
 	cd->is_passthrough = false;
+	cd->is_muted = false;
 	volume_set_ramp_channel_counter(cd, channels_count);
 	cd->scale_vol = vol_get_processing_function(dev, cd);
 	volume_prepare_ramp(dev, cd);
@@ -337,6 +340,7 @@ static int volume_set_switch(struct processing_module *mod, const uint8_t *data,
 
 	cd->ramp_finished = false;
 	cd->is_passthrough = false;
+	cd->is_muted = false;
 	volume_set_ramp_channel_counter(cd, channels_count);
 	cd->scale_vol = vol_get_processing_function(dev, cd);
 	volume_prepare_ramp(dev, cd);
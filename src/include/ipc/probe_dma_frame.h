@@ -30,7 +30,7 @@ struct probe_data_packet {
  * Audio format from extraction probes is encoded as 32 bit value. Following
  * graphic explains encoding.
  *
- * A|BBBB|CCCC|DDDD|EEEEE|FF|GG|H|I|J|XXXXXXX
+ * A|BBBB|CCCC|DDDD|EEEEE|FF|GG|H|I|J|KKKK|L|XX
  * A - 1 bit - Specifies Type Encoding - 1 for Standard encoding
  * B - 4 bits - Specify Standard Type - 0 for Audio
  * C - 4 bits - Specify Audio format - 0 for PCM
@@ -57,6 +57,13 @@ struct probe_data_packet {
  * H - 1 bit - Specifies Sample Format - 0 for Integer, 1 for Floating point
  * I - 1 bit - Specifies Sample Endianness - 0 for LE
  * J - 1 bit - Specifies Interleaving - 1 for Sample Interleaving
+ * K - 4 bits - Specify Decimation - one of K + 1 frames of the probed buffer
+ *		is extracted, D is the sample rate of the probed buffer
+ * L - 1 bit - Specifies Packing - 1 for delta packed samples: each sample is
+ *	       the difference to the previous sample of its channel in the
+ *	       packet (to 0 for the first one), zigzag coded and stored 7 bits
+ *	       per byte, least significant first, bit 7 set on all but the last
+ *	       byte. The unpacked sample keeps the low container bytes.
  */
 #define PROBE_SHIFT_FMT_TYPE		31
 #define PROBE_SHIFT_STANDARD_TYPE	27
@@ -68,6 +75,8 @@ struct probe_data_packet {
 #define PROBE_SHIFT_SAMPLE_FMT		9
 #define PROBE_SHIFT_SAMPLE_END		8
 #define PROBE_SHIFT_INTERLEAVING_ST	7
+#define PROBE_SHIFT_DECIMATION		3
+#define PROBE_SHIFT_PACKING		2
 
 #define PROBE_MASK_FMT_TYPE		MASK(31, 31)
 #define PROBE_MASK_STANDARD_TYPE	MASK(30, 27)
@@ -79,5 +88,35 @@ struct probe_data_packet {
 #define PROBE_MASK_SAMPLE_FMT		MASK(9, 9)
 #define PROBE_MASK_SAMPLE_END		MASK(8, 8)
 #define PROBE_MASK_INTERLEAVING_ST	MASK(7, 7)
+#define PROBE_MASK_DECIMATION		MASK(6, 3)
+#define PROBE_MASK_PACKING		MASK(2, 2)
+
+/** Maximum size of a delta packed sample */
+#define PROBE_PACKED_SAMPLE_MAX		5
+
+/**
+ * \brief Definitions of shifts and masks for extraction options
+ *
+ * An extraction probe point may ask for less data than the raw buffer
+ * content in the upper bits of its purpose, 0 requests the raw data.
+ *
+ * CCCCCCCCCCCCCCCC|XX|P|T|DDDD|AAAAAAAA
+ * A - 8 bits - Specify Purpose - PROBE_PURPOSE_xxx
+ * D - 4 bits - Specify Decimation - extract one of D + 1 frames
+ * T - 1 bit - Specifies Truncation - 1 to truncate integer samples to 16 bits
+ * P - 1 bit - Specifies Packing - 1 to delta pack the samples
+ * C - 16 bits - Specify Channel Mask - channels to extract, 0 for all
+ */
+#define PROBE_SHIFT_PURPOSE		0
+#define PROBE_SHIFT_EXT_DECIMATION	8
+#define PROBE_SHIFT_EXT_TRUNCATE	12
+#define PROBE_SHIFT_EXT_PACKING		13
+#define PROBE_SHIFT_EXT_CHANNELS	16
+
+#define PROBE_MASK_PURPOSE		MASK(7, 0)
+#define PROBE_MASK_EXT_DECIMATION	MASK(11, 8)
+#define PROBE_MASK_EXT_TRUNCATE		MASK(12, 12)
+#define PROBE_MASK_EXT_PACKING		MASK(13, 13)
+#define PROBE_MASK_EXT_CHANNELS		MASK(31, 16)
 
 #endif
@@ -151,6 +151,14 @@ struct processing_module {
 	 */
 	bool dp_startup_delay;
 
+	/*
+	 * number of periods a DP module processes per wake-up, 0 or 1 for one period.
+	 * Set by deadline-tolerant modules in their init(): the module is then only
+	 * scheduled once that many periods of data and free space are queued, and its
+	 * deadline is extended accordingly. This saves thread switches and cache refills.
+	 */
+	uint32_t dp_batch_periods;
+
 	/* flag to indicate module does not pause */
 	bool no_pause;
 
@@ -173,6 +181,13 @@ struct processing_module {
 	 */
 	bool stream_copy_single_to_single;
 
+	/*
+	 * True for a module writing each output sample over the input sample it was
+	 * computed from, in the same format. With CONFIG_COMP_BUFFER_IN_PLACE the sink
+	 * buffer of such an LL module then shares the memory of its source buffer.
+	 */
+	bool process_in_place;
+
 	/* total processed data after stream started */
 	uint64_t total_data_consumed;
 	uint64_t total_data_produced;
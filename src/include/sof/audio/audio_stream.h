@@ -61,6 +61,11 @@ struct audio_stream {
 	uint8_t byte_align_req;
 	uint8_t frame_align_req;
 
+#if CONFIG_COMP_BUFFER_IN_PLACE
+	/* streams sharing the memory of the first stream for in-place processing */
+	struct audio_stream *alias_prev; /**< Stream whose read data is written here */
+	struct audio_stream *alias_next; /**< Stream written over this stream's data */
+#endif
 
 	/* runtime stream params */
 	struct sof_audio_stream_params runtime_stream_params;
@@ -612,6 +617,16 @@ audio_stream_avail_frames_aligned(const struct audio_stream *source,
 	return MIN(src_frames, sink_frames);
 }
 
+#if CONFIG_COMP_BUFFER_IN_PLACE
+/**
+ * Recalculates free space of all streams aliased with the given one.
+ * The first stream of the chain may only be written where no stream holds
+ * data, each following stream where its predecessor has been read.
+ * @param stream Any stream of the alias chain.
+ */
+void audio_stream_alias_sync(struct audio_stream *stream);
+#endif
+
 /**
  * Updates the buffer state after writing to the buffer.
  * @param buffer Buffer to update.
@@ -637,6 +652,11 @@ static inline void audio_stream_produce(struct audio_stream *buffer, uint32_t by
 
 	/* calculate free bytes */
 	buffer->free = buffer->size - buffer->avail;
+
+#if CONFIG_COMP_BUFFER_IN_PLACE
+	if (buffer->alias_prev || buffer->alias_next)
+		audio_stream_alias_sync(buffer);
+#endif
 }
 
 /**
@@ -660,6 +680,11 @@ static inline void audio_stream_consume(struct audio_stream *buffer, uint32_t by
 
 	/* calculate free bytes */
 	buffer->free = buffer->size - buffer->avail;
+
+#if CONFIG_COMP_BUFFER_IN_PLACE
+	if (buffer->alias_prev || buffer->alias_next)
+		audio_stream_alias_sync(buffer);
+#endif
 }
 
 #ifdef __ZEPHYR__
@@ -706,6 +731,11 @@ static inline void audio_stream_reset(struct audio_stream *buffer)
 
 	/* there are no avail samples at reset */
 	buffer->avail = 0;
+
+#if CONFIG_COMP_BUFFER_IN_PLACE
+	if (buffer->alias_prev || buffer->alias_next)
+		audio_stream_alias_sync(buffer);
+#endif
 }
 
 /**
@@ -121,6 +121,13 @@ extern struct tr_ctx buffer_tr;
 #define BUFFER_USAGE_SHARED	true	/* buffer used by multiple DSP core and/or HW blocks */
 #define BUFFER_USAGE_NOT_SHARED false	/* buffer only used by one HW block */
 
+/* buffer memory placement, chosen once producer and consumer are known */
+enum buffer_placement {
+	BUFFER_PLACEMENT_REQUESTED = 0,	/* memory flags used as requested */
+	BUFFER_PLACEMENT_LOCAL,		/* cached near memory, same core hot buffer */
+	BUFFER_PLACEMENT_SHARED,	/* producer and consumer on different cores */
+};
+
 /*
  * audio component buffer - connects 2 audio components together in pipeline.
  *
@@ -136,6 +143,7 @@ struct comp_buffer {
 	/* configuration */
 	uint32_t flags;
 	uint32_t core;
+	enum buffer_placement placement;	/* memory placement, for diagnostics */
 	struct tr_ctx tctx;			/* trace settings */
 
 	/* connected components */
@@ -218,6 +226,32 @@ struct comp_buffer *buffer_alloc_range(size_t preferred_size, size_t minimum_siz
 				       uint32_t flags, uint32_t align, bool is_shared);
 struct comp_buffer *buffer_new(const struct sof_ipc_buffer *desc, bool is_shared);
 
+/*
+ * Select memory flags for a buffer from the cores of its producer and
+ * consumer and from the pipeline period in microseconds.
+ */
+uint32_t buffer_placement_flags(uint32_t flags, uint32_t source_core, uint32_t sink_core,
+				uint32_t period_us, enum buffer_placement *placement);
+
+/*
+ * Move the data of a buffer, which is not in use yet, to the memory selected
+ * by buffer_placement_flags(). The buffer keeps its memory if that fails.
+ */
+int buffer_place(struct comp_buffer *buffer, uint32_t source_core, uint32_t sink_core,
+		 uint32_t period_us);
+
+#if CONFIG_COMP_BUFFER_IN_PLACE
+/*
+ * Let the sink buffer of an in-place module share the memory of its source
+ * buffer. Both buffers must be idle and carry samples of the same format. The
+ * sink buffer memory is freed, buffers already aliased behind it follow.
+ */
+int buffer_alias(struct comp_buffer *source, struct comp_buffer *sink);
+
+/* Give an aliased buffer its own memory again */
+int buffer_unalias(struct comp_buffer *buffer);
+#endif
+
 int buffer_set_size(struct comp_buffer *buffer, uint32_t size, uint32_t alignment);
 int buffer_set_size_range(struct comp_buffer *buffer, size_t preferred_size, size_t minimum_size,
 			  uint32_t alignment);
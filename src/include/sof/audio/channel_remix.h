@@ -0,0 +1,127 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2026 Intel Corporation. All rights reserved.
+ */
+
+/**
+ * \file audio/channel_remix.h
+ * \brief Generic channel remix engine
+ *
+ * A remix computes every sink channel as a sum of source channels weighted
+ * with Q10 coefficients. The coefficient matrix is analyzed once when the
+ * remix is built and processing then runs the kernel for the detected
+ * shape, so a plain copy or a pick of one channel out of a microphone
+ * array does not multiply the full matrix for every frame.
+ */
+
+#ifndef __SOF_AUDIO_CHANNEL_REMIX_H__
+#define __SOF_AUDIO_CHANNEL_REMIX_H__
+
+#include <stdint.h>
+
+struct audio_stream;
+
+/** \brief Maximum number of source channels of a remix. */
+#define CHANNEL_REMIX_SOURCE_MAX	16
+
+/** \brief Maximum number of sink channels of a remix. */
+#define CHANNEL_REMIX_SINK_MAX		8
+
+/** \brief Maximum number of non-zero coefficients of a sparse remix. */
+#define CHANNEL_REMIX_TAPS_MAX		32
+
+/** \brief Fractional bits of the remix coefficients. */
+#define CHANNEL_REMIX_Q_SHIFT		10
+#define CHANNEL_REMIX_UNITY		(1 << CHANNEL_REMIX_Q_SHIFT)
+
+/** \brief Pick table entry of a sink channel that outputs silence. */
+#define CHANNEL_REMIX_SILENT		0xff
+
+/** \brief Remix shapes, from the cheapest to the most generic one. */
+enum channel_remix_shape {
+	CHANNEL_REMIX_COPY = 0,	/**< identity, frames are copied as they are */
+	CHANNEL_REMIX_PICK,	/**< every sink channel is one source channel or silence */
+	CHANNEL_REMIX_DOWNMIX2,	/**< single sink channel mixed from two source channels */
+	CHANNEL_REMIX_SPARSE,	/**< list of non-zero coefficients per sink channel */
+	CHANNEL_REMIX_DENSE,	/**< full coefficient matrix */
+};
+
+/** \brief Non-zero coefficient of a sparse remix. */
+struct channel_remix_tap {
+	uint8_t channel;	/**< source channel index */
+	int16_t coeff;		/**< Q10 coefficient */
+};
+
+/** \brief Remix description built from a coefficient matrix or a channel map. */
+struct channel_remix {
+	enum channel_remix_shape shape;
+	uint8_t source_channels;
+	uint8_t sink_channels;
+	uint8_t pick[CHANNEL_REMIX_SINK_MAX];	/**< source channel per sink channel */
+	uint8_t num_taps[CHANNEL_REMIX_SINK_MAX]; /**< taps per sink channel */
+	struct channel_remix_tap taps[CHANNEL_REMIX_TAPS_MAX];
+
+	/* matrix the remix was built from, only used by the dense shape */
+	const int16_t *coeffs;
+	int coeffs_stride;
+};
+
+/**
+ * \brief Builds a remix from a Q10 coefficient matrix.
+ * \param[out] remix Remix to build.
+ * \param[in] coeffs Matrix with one row per sink channel, must stay valid
+ *		     while the remix is in use.
+ * \param[in] stride Distance between matrix rows in coefficients.
+ * \param[in] sink_channels Number of sink channels.
+ * \param[in] source_channels Number of source channels.
+ * \return Error code.
+ */
+int channel_remix_build(struct channel_remix *remix, const int16_t *coeffs, int stride,
+			int sink_channels, int source_channels);
+
+/**
+ * \brief Builds a remix from a channel map.
+ *
+ * Each nibble of the map, starting from the least significant one, gives the
+ * source channel of a sink channel, 0xf mutes the sink channel.
+ *
+ * \param[out] remix Remix to build.
+ * \param[in] chmap Channel map.
+ * \param[in] sink_channels Number of sink channels.
+ * \param[in] source_channels Number of source channels.
+ * \return Error code.
+ */
+int channel_remix_build_chmap(struct channel_remix *remix, uint32_t chmap,
+			      int sink_channels, int source_channels);
+
+/**
+ * \brief Remixes 16 bit frames.
+ * \param[in] remix Remix to apply.
+ * \param[in] source Source stream, read from its read pointer.
+ * \param[in,out] sink Sink stream, written from its write pointer.
+ * \param[in] frames Number of frames to process.
+ */
+void channel_remix_s16(const struct channel_remix *remix, const struct audio_stream *source,
+		       struct audio_stream *sink, uint32_t frames);
+
+/**
+ * \brief Remixes 24 bit frames in 32 bit containers.
+ * \param[in] remix Remix to apply.
+ * \param[in] source Source stream, read from its read pointer.
+ * \param[in,out] sink Sink stream, written from its write pointer.
+ * \param[in] frames Number of frames to process.
+ */
+void channel_remix_s24(const struct channel_remix *remix, const struct audio_stream *source,
+		       struct audio_stream *sink, uint32_t frames);
+
+/**
+ * \brief Remixes 32 bit frames.
+ * \param[in] remix Remix to apply.
+ * \param[in] source Source stream, read from its read pointer.
+ * \param[in,out] sink Sink stream, written from its write pointer.
+ * \param[in] frames Number of frames to process.
+ */
+void channel_remix_s32(const struct channel_remix *remix, const struct audio_stream *source,
+		       struct audio_stream *sink, uint32_t frames);
+
+#endif /* __SOF_AUDIO_CHANNEL_REMIX_H__ */
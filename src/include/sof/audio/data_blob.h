@@ -15,6 +15,36 @@ struct comp_dev;
 
 struct comp_data_blob_handler;
 
+/**
+ * Optional callbacks of a data blob handler to move the derivation of
+ * processing state (e.g. filter coefficients) from a data blob out of
+ * the audio thread.
+ */
+struct comp_data_blob_prepare_ops {
+	/**
+	 * Called in IPC context when a new data blob has been received
+	 * while the component holds a configuration, i.e. when the blob
+	 * will be applied by comp_data_blob_swap().
+	 *
+	 * @param dev Component device
+	 * @param data New data blob
+	 * @param data_size New data blob size
+	 * @param state Set to the state derived from the data blob
+	 * @return 0 on success, negative error code discards the blob
+	 */
+	int (*prepare)(struct comp_dev *dev, const void *data, uint32_t data_size,
+		       void **state);
+
+	/**
+	 * Frees a state returned by prepare(). Called outside of the
+	 * audio thread unless updates come faster than periods.
+	 *
+	 * @param dev Component device
+	 * @param state Prepared state to free
+	 */
+	void (*release)(struct comp_dev *dev, void *state);
+};
+
 /**
  * Returns data blob. In case when new data blob is available it returns new
  * one. Function returns also data blob size in case when size pointer is given.
@@ -36,6 +66,28 @@ void *comp_get_data_blob(struct comp_data_blob_handler *blob_handler,
 bool comp_is_new_data_blob_available(struct comp_data_blob_handler
 					*blob_handler);
 
+/**
+ * Applies a new data blob and the state prepared for it, if available.
+ * Meant to be called from the audio thread at a period boundary, it only
+ * swaps pointers. The previous data blob and state are retired and freed
+ * later in IPC context. The previous state stays valid until the next call,
+ * so it can be used as a crossfade hook, e.g. to run the old and new
+ * filters for one period and mix their outputs.
+ *
+ * @param blob_handler Data blob handler
+ * @param old_state Optional, set to the retired state on swap, NULL otherwise
+ * @return true when a new data blob has been applied
+ */
+bool comp_data_blob_swap(struct comp_data_blob_handler *blob_handler, void **old_state);
+
+/**
+ * Returns the state prepared for the current data blob, NULL if the blob
+ * has been applied without comp_data_blob_swap().
+ *
+ * @param blob_handler Data blob handler
+ */
+void *comp_data_blob_get_state(struct comp_data_blob_handler *blob_handler);
+
 /**
  * Checks whether there is a valid data blob is available.
  *
@@ -152,4 +204,34 @@ void comp_data_blob_set_validator(struct comp_data_blob_handler *blob_handler,
 				  int (*validator)(struct comp_dev *dev, void *new_data,
 						   uint32_t new_data_size));
 
+/**
+ * Set callbacks deriving processing state from new data blobs outside of
+ * the audio thread, see comp_data_blob_swap().
+ *
+ * @param blob_handler Data blob handler
+ * @param ops Prepare callbacks, both must be set
+ */
+void comp_data_blob_set_prepare_ops(struct comp_data_blob_handler *blob_handler,
+				    const struct comp_data_blob_prepare_ops *ops);
+
+/**
+ * Set a callback consuming new data blobs fragment by fragment, straight
+ * from the IPC payload. The handler then neither allocates nor copies new
+ * data blobs, which saves staging memory and time on very big blobs like
+ * models, but comp_get_data_blob() only returns the blob set with
+ * comp_init_data_blob(). Fragments arrive in order, a FIRST or SINGLE
+ * fragment starts a new transfer and aborts any unfinished one.
+ *
+ * @param blob_handler Data blob handler
+ * @param stream Fragment consumer, NULL restores staging. Called with the
+ *		 fragment position, the size of the whole data blob and the
+ *		 offset of the fragment in it. A negative error code aborts
+ *		 the transfer.
+ */
+void comp_data_blob_set_stream(struct comp_data_blob_handler *blob_handler,
+			       int (*stream)(struct comp_dev *dev,
+					     enum module_cfg_fragment_position pos,
+					     uint32_t data_size, uint32_t offset,
+					     const uint8_t *fragment, size_t fragment_size));
+
 #endif /* __SOF_AUDIO_DATA_BLOB_H__ */
@@ -52,12 +52,16 @@ struct comp_buffer;
 	 (channels_number)))
 /**< Defines how much faster draining is in comparison to pipeline copy. */
 #define KPB_DRAIN_NUM_OF_PPL_PERIODS_AT_ONCE 2
+/**< Max number of host sink buffers drained in one LL copy. */
+#define KPB_DRAIN_MAX_SINK_FILLS 4
 /**< Host buffer shall be at least two times bigger than history buffer. */
 #define HOST_BUFFER_MIN_SIZE(hb, channels_number) ((hb) * (channels_number))
 
 /**< Convert with right shift a bytes count to samples count */
 #define KPB_BYTES_TO_S16_SAMPLES(s)	((s) >> 1)
 #define KPB_BYTES_TO_S32_SAMPLES(s)	((s) >> 2)
+/**< Size of a 32-bit container sample in packed history buffer */
+#define KPB_PACKED_SAMPLE_BYTES 3
 
 /* Macro that returns mask with selected bits set */
 #define KPB_COUNT_TO_BITMASK(cnt) (((0x1 << (cnt)) - 1))
@@ -145,16 +149,15 @@ struct history_buffer {
 struct draining_data {
 	struct comp_buffer *sink;
 	struct history_buffer *hb;
-	size_t drain_req;
-	size_t drained;
+	size_t drain_req; /**< bytes left to drain, updated by LL copy only */
+	size_t drained; /**< bytes drained so far, updated by LL copy only */
 	uint8_t is_draining_active;
 	size_t sample_width;
 	size_t buffered_while_draining;
 	uint64_t draining_time_start;
 	size_t drain_interval;
-	uint64_t period_copy_start;
 	size_t pb_limit; /**< Period bytes limit */
-	size_t period_bytes;
+	size_t granted; /**< bytes released for draining, updated by task only */
 	uint64_t next_copy_time;
 	struct comp_dev *dev;
 	bool sync_mode_on;
@@ -169,6 +172,7 @@ struct history_data {
 	size_t buffered; /**< amount of buffered data */
 	size_t free; /** spce we can use to write new data */
 	struct history_buffer *c_hb; /**< current buffer used for writing */
+	bool packed; /**< 32-bit samples stored as 24-bit in history buffer */
 };
 
 /* moved to ipc4/kpb.h */
@@ -247,6 +247,35 @@ bool module_is_ready_to_process(struct processing_module *mod,
 						  num_of_sinks);
 }
 
+/*
+ * A DP module processing a batch of periods per wake-up only becomes ready once
+ * the whole batch is queued. A module-specific readiness check takes precedence,
+ * the batch is then only an upper limit of periods processed per wake-up.
+ */
+static inline
+bool module_is_ready_to_process_batch(struct processing_module *mod)
+{
+	const struct module_interface *const ops = mod->dev->drv->adapter_ops;
+	uint32_t periods = mod->dp_batch_periods;
+	int i;
+
+	if (periods <= 1 || ops->is_ready_to_process)
+		return module_is_ready_to_process(mod, mod->sources, mod->num_of_sources,
+						  mod->sinks, mod->num_of_sinks);
+
+	for (i = 0; i < mod->num_of_sources; i++)
+		if (source_get_data_available(mod->sources[i]) <
+		    periods * source_get_min_available(mod->sources[i]))
+			return false;
+
+	for (i = 0; i < mod->num_of_sinks; i++)
+		if (sink_get_free_size(mod->sinks[i]) <
+		    periods * sink_get_min_free_space(mod->sinks[i]))
+			return false;
+
+	return true;
+}
+
 int module_process_sink_src(struct processing_module *mod,
 			    struct sof_source **sources, int num_of_sources,
 			    struct sof_sink **sinks, int num_of_sinks);
@@ -254,6 +283,35 @@ int module_process_legacy(struct processing_module *mod,
 			  struct input_stream_buffer *input_buffers, int num_input_buffers,
 			  struct output_stream_buffer *output_buffers,
 			  int num_output_buffers);
+
+/*
+ * Processes a DP wake-up: the scheduler has checked that the first period is
+ * ready, the following ones up to dp_batch_periods are processed as long as
+ * they are ready too. The number of periods processed is returned in
+ * processed, the return value is the error of the period that failed.
+ */
+static inline int module_process_batch(struct processing_module *mod, uint32_t *processed)
+{
+	uint32_t periods = MAX(mod->dp_batch_periods, 1);
+	uint32_t i;
+	int ret = 0;
+
+	for (i = 0; i < periods; i++) {
+		if (i && !module_is_ready_to_process(mod, mod->sources, mod->num_of_sources,
+						     mod->sinks, mod->num_of_sinks))
+			break;
+
+		ret = module_process_sink_src(mod, mod->sources, mod->num_of_sources,
+					      mod->sinks, mod->num_of_sinks);
+		if (ret)
+			break;
+	}
+
+	*processed = i;
+
+	return ret;
+}
+
 int module_reset(struct processing_module *mod);
 int module_free(struct processing_module *mod);
 int module_set_configuration(struct processing_module *mod,
@@ -14,6 +14,7 @@
 #ifndef __SOF_AUDIO_SELECTOR_H__
 #define __SOF_AUDIO_SELECTOR_H__
 
+#include <sof/audio/channel_remix.h>
 #include <sof/audio/module_adapter/module/generic.h>
 #include <sof/trace/trace.h>
 #include <ipc/stream.h>
@@ -22,6 +23,7 @@
 #endif
 #include <user/selector.h>
 #include <user/trace.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 struct comp_buffer;
@@ -110,6 +112,7 @@ struct comp_data {
 	struct sof_selector_ipc4_config sel_ipc4_cfg;
 	struct ipc4_selector_coeffs_config coeffs_config;
 #endif
+	bool coeffs_changed;	/**< remix to be rebuilt before next process */
 
 	uint32_t source_period_bytes;	/**< source number of period bytes */
 	uint32_t sink_period_bytes;	/**< sink number of period bytes */
@@ -117,6 +120,7 @@ struct comp_data {
 	enum sof_ipc_frame sink_format;		/**< sink frame format */
 	struct sof_sel_config config;	/**< component configuration data */
 	sel_func sel_func;	/**< channel selector processing function */
+	struct channel_remix remix;	/**< remix applied by sel_func */
 };
 
 /** \brief Selector processing functions map. */
@@ -129,6 +133,13 @@ struct comp_func_map {
 /** \brief Map of formats with dedicated processing functions. */
 extern const struct comp_func_map func_map[];
 
+/**
+ * \brief Builds the channel remix from the selector configuration.
+ * \param[in,out] cd Selector component data.
+ * \return Error code.
+ */
+int sel_build_remix(struct comp_data *cd);
+
 #if CONFIG_IPC_MAJOR_4
 /**
  * \brief Retrieves selector processing function.
@@ -232,6 +232,17 @@ int comp_verify_params(struct comp_dev *dev, uint32_t flag,
 int comp_buffer_connect(struct comp_dev *comp, uint32_t comp_core,
 			struct comp_buffer *buffer, uint32_t dir);
 
+/**
+ * \brief Place buffer memory once its producer and consumer are known
+ * @param ipc The global IPC context.
+ * @param buffer Component buffer
+ * @param source Component producing data into the buffer
+ * @param sink Component consuming data from the buffer
+ * @return 0 on success or negative error.
+ */
+int ipc_buffer_place(struct ipc *ipc, struct comp_buffer *buffer,
+		     struct comp_dev *source, struct comp_dev *sink);
+
 #define ipc_get_comp_by_id(ipc, comp_id) ipc_get_comp_dev(ipc, COMP_TYPE_COMPONENT, comp_id)
 #define ipc_get_pipeline_by_id(ipc, ppln_id) ipc_get_comp_dev(ipc, COMP_TYPE_PIPELINE, ppln_id)
 #define ipc_get_buffer_by_id(ipc, buf_id) ipc_get_comp_dev(ipc, COMP_TYPE_BUFFER, buf_id)
@@ -12,6 +12,7 @@
 #include <sof/list.h>
 #include <rtos/spinlock.h>
 #include <rtos/sof.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 /* notifier target core masks */
@@ -38,18 +39,36 @@ enum notify_id {
 	NOTIFIER_ID_COUNT
 };
 
+/** \brief Number of per-type buckets indexing callbacks by caller. */
+#define NOTIFIER_CALLER_HASH_SIZE	4
+
+/** \brief Number of cross-core events that can be queued per core. */
+#define NOTIFIER_REMOTE_QUEUE_SIZE	8
+
 struct notify {
-	struct list_item list[NOTIFIER_ID_COUNT]; /* list of callback handles */
+	/* callback handles without caller filter, run for every event */
+	struct list_item list[NOTIFIER_ID_COUNT];
+	/* callback handles filtered by caller, hashed by caller address */
+	struct list_item caller_list[NOTIFIER_ID_COUNT][NOTIFIER_CALLER_HASH_SIZE];
 	struct k_spinlock lock;	/* list lock */
 };
 
-struct notify_data {
+struct notify_event {
 	const void *caller;
 	enum notify_id type;
 	uint32_t data_size;
 	void *data;
 };
 
+/* queue of events sent to a core, drained on a single IDC message */
+struct notify_data {
+	struct k_spinlock lock;	/* queue lock */
+	uint32_t first;		/* index of the oldest queued event */
+	uint32_t count;		/* number of queued events */
+	uint32_t dropped;	/* events lost on queue overflow or failed IDC */
+	struct notify_event events[NOTIFIER_REMOTE_QUEUE_SIZE];
+};
+
 #ifdef CLK_SSP
 #define NOTIFIER_CLK_CHANGE_ID(clk) \
 	((clk) == CLK_SSP ? NOTIFIER_ID_SSP_FREQ : NOTIFIER_ID_CPU_FREQ)
@@ -90,10 +109,13 @@ void notifier_unregister(void *receiver_data_filter, void *caller_id_filter, enu
  */
 void notifier_unregister_all(void *receiver_data_filter, void *caller_id_filter);
 
+/** Run all events queued for the current core by other cores. */
 void notifier_notify_remote(void);
 
 /* data_size is required to manage cache coherency for notifications
- * across cores.
+ * across cores. Events for other cores are queued and a single IDC
+ * message is sent per batch, the payload must stay valid until the
+ * target core has run its callbacks.
  */
 void notifier_event(const void *caller_id, enum notify_id event_type, uint32_t core_mask,
 		    void *caller_data, uint32_t data_size);
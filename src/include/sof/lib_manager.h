@@ -110,6 +110,10 @@ struct lib_manager_module {
 	struct llext_buf_loader *ebl; /* Zephyr loadable extension buffer loader */
 	unsigned int n_dependent; /* For auxiliary modules: number of dependents */
 	bool mapped;
+#if CONFIG_LLEXT_MANAGER_CACHE
+	bool cached;		/* No instances, .text and .rodata still mapped */
+	struct list_item cache_list;	/* Entry in the unused module cache */
+#endif
 	struct lib_manager_segment_desc segment[LIB_MANAGER_N_SEGMENTS];
 };
 
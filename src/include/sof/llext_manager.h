@@ -16,6 +16,18 @@ struct comp_dev;
 struct comp_driver;
 struct comp_ipc_config;
 
+/* Cumulative module management costs, in DSP cycles */
+struct llext_manager_stats {
+	uint32_t link_count;
+	uint64_t link_cycles;
+	uint32_t load_count;
+	uint64_t load_cycles;
+	uint32_t unmap_count;
+	uint64_t unmap_cycles;
+	uint32_t cache_hits;
+	uint32_t evictions;
+};
+
 static inline bool module_is_llext(const struct sof_man_module *mod)
 {
 	return mod->type.load_type == SOF_MAN_MOD_TYPE_LLEXT ||
@@ -30,6 +42,8 @@ int llext_manager_free_module(const uint32_t component_id);
 int llext_manager_add_library(uint32_t module_id);
 
 bool comp_is_llext(struct comp_dev *comp);
+
+void llext_manager_get_stats(struct llext_manager_stats *stats);
 #else
 #define module_is_llext(mod) false
 #define llext_manager_allocate_module(ipc_config, ipc_specific_config) 0
@@ -38,6 +52,19 @@ bool comp_is_llext(struct comp_dev *comp);
 #define comp_is_llext(comp) false
 #endif
 
+#if CONFIG_LLEXT_MANAGER_CACHE
+void llext_manager_cache_flush(void);
+
+/*
+ * Evict the least recently used cached module to free physical pages for
+ * another allocation. Returns false if nothing could be evicted.
+ */
+bool llext_manager_cache_reclaim(void);
+#else
+#define llext_manager_cache_flush() do { } while (0)
+#define llext_manager_cache_reclaim() false
+#endif
+
 #if CONFIG_LLEXT_EXPERIMENTAL && !CONFIG_ADSP_IMR_CONTEXT_SAVE
 int llext_manager_store_to_dram(void);
 int llext_manager_restore_from_dram(void);
@@ -23,6 +23,30 @@ struct mat_matrix_16b {
 	int16_t data[];
 };
 
+struct mat_matrix_32b {
+	int16_t rows;
+	int16_t columns;
+	int16_t fractions;
+	int16_t reserved;
+	int32_t data[];
+};
+
+/*
+ * Sparse band matrix for filterbanks, each column has one run of non-zero rows.
+ * The data of a column is the index of the next column data, the first row,
+ * the number of rows and the coefficients, the same layout as the Mel
+ * filterbank triangles.
+ */
+struct mat_band_16b {
+	int16_t rows;
+	int16_t columns;
+	int16_t fractions;
+	int16_t length; /* int16_t words in data */
+	int16_t data[];
+};
+
+#define MAT_BAND_HEADER_LENGTH	3
+
 static inline void mat_init_16b(struct mat_matrix_16b *mat, int16_t rows, int16_t columns,
 				int16_t fractions)
 {
@@ -75,8 +99,71 @@ static inline int16_t *mat_get_row_vector_16b(struct mat_matrix_16b *mat, int ro
 	return mat->data + row * mat->columns;
 }
 
+static inline void mat_init_32b(struct mat_matrix_32b *mat, int16_t rows, int16_t columns,
+				int16_t fractions)
+{
+	mat->rows = rows;
+	mat->columns = columns;
+	mat->fractions = fractions;
+}
+
+static inline struct mat_matrix_32b *mat_matrix_alloc_32b(int16_t rows, int16_t columns,
+							  int16_t fractions)
+{
+	struct mat_matrix_32b *mat;
+	const int mat_size = sizeof(int32_t) * rows * columns + sizeof(struct mat_matrix_32b);
+
+	mat = rzalloc(SOF_MEM_FLAG_USER, mat_size);
+	if (mat)
+		mat_init_32b(mat, rows, columns, fractions);
+
+	return mat;
+}
+
+static inline int32_t mat_get_scalar_32b(struct mat_matrix_32b *mat, int row, int col)
+{
+	return mat->data[col + row * mat->columns];
+}
+
+static inline void mat_set_scalar_32b(struct mat_matrix_32b *mat, int row, int col, int32_t val)
+{
+	mat->data[col + row * mat->columns] = val;
+}
+
+/* Returns the number of band data words needed for the matrix, or negative error code */
+int mat_band_length_16b(struct mat_matrix_16b *mat);
+
+int mat_band_from_matrix_16b(struct mat_band_16b *band, int length, struct mat_matrix_16b *mat);
+
+static inline struct mat_band_16b *mat_band_alloc_16b(struct mat_matrix_16b *mat)
+{
+	struct mat_band_16b *band;
+	int length = mat_band_length_16b(mat);
+
+	if (length < 0)
+		return NULL;
+
+	band = rzalloc(SOF_MEM_FLAG_USER, sizeof(int16_t) * length + sizeof(struct mat_band_16b));
+	if (band && mat_band_from_matrix_16b(band, length, mat) < 0) {
+		rfree(band);
+		return NULL;
+	}
+
+	return band;
+}
+
 int mat_multiply(struct mat_matrix_16b *a, struct mat_matrix_16b *b, struct mat_matrix_16b *c);
 
+/* Multiplies 32 bit data in a with 16 bit coefficients in b */
+int mat_multiply_32x16b(struct mat_matrix_32b *a, struct mat_matrix_16b *b,
+			struct mat_matrix_32b *c);
+
+int mat_multiply_band_16b(struct mat_matrix_16b *a, struct mat_band_16b *b,
+			  struct mat_matrix_16b *c);
+
+int mat_multiply_band_32x16b(struct mat_matrix_32b *a, struct mat_band_16b *b,
+			     struct mat_matrix_32b *c);
+
 int mat_multiply_elementwise(struct mat_matrix_16b *a, struct mat_matrix_16b *b,
 			     struct mat_matrix_16b *c);
 
@@ -61,6 +61,8 @@ struct ll_schedule_domain_ops {
 	bool (*domain_is_pending)(struct ll_schedule_domain *domain,
 				  struct task *task, struct comp_dev **comp);
 	void (*domain_task_cancel)(struct ll_schedule_domain *domain, struct task *task);
+	void (*domain_set_wake_period)(struct ll_schedule_domain *domain, int core,
+				       uint32_t ticks);
 };
 
 struct ll_schedule_domain {
@@ -150,6 +152,21 @@ static inline void domain_task_cancel(struct ll_schedule_domain *domain,
 		domain->ops->domain_task_cancel(domain, task);
 }
 
+/*
+ * let the domain wake the core only every 'ticks' scheduler ticks, returns
+ * the number of ticks between wake-ups the domain is going to use
+ */
+static inline uint32_t domain_set_wake_period(struct ll_schedule_domain *domain,
+					      uint32_t ticks)
+{
+	if (!domain->ops->domain_set_wake_period)
+		return 1;
+
+	domain->ops->domain_set_wake_period(domain, cpu_get_id(), ticks);
+
+	return ticks;
+}
+
 static inline int domain_register(struct ll_schedule_domain *domain,
 				  struct task *task,
 				  void (*handler)(void *arg), void *arg)
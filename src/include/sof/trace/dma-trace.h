@@ -12,6 +12,7 @@
 #include <rtos/task.h>
 #include <rtos/sof.h>
 #include <rtos/spinlock.h>
+#include <rtos/atomic.h>
 #include <ipc/trace.h>
 #include <stdint.h>
 
@@ -27,6 +28,16 @@ struct dma_trace_buf {
 	uint32_t avail;		/* bytes available to read */
 };
 
+#if CONFIG_TRACE_PER_CORE
+/* lock-free ring of one core, written by the core and read by trace_work */
+struct dma_trace_core_buf {
+	char *addr;		/* buffer base address */
+	atomic_t w;		/* bytes written so far */
+	atomic_t r;		/* bytes read so far */
+	atomic_t dropped;	/* amount of dropped entries */
+};
+#endif
+
 struct dma_trace_data {
 	struct dma_sg_config config;
 	struct dma_trace_buf dmatb;
@@ -45,6 +56,11 @@ struct dma_trace_data {
 	uint32_t dropped_entries;	/* amount of dropped entries */
 	struct k_spinlock lock;		/* dma trace lock */
 	uint64_t time_delta;		/* difference between the host time */
+#if CONFIG_TRACE_PER_CORE
+	struct dma_trace_core_buf core_buf[CONFIG_CORE_COUNT];
+	atomic_t core_writers;		/* cores appending to their ring */
+	uint32_t flush_request;		/* a secondary core ring is filling up */
+#endif
 };
 
 int dma_trace_init_early(struct sof *sof);
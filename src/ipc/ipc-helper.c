@@ -222,6 +222,22 @@ __cold int comp_buffer_connect(struct comp_dev *comp, uint32_t comp_core,
 	return pipeline_connect(comp, buffer, dir);
 }
 
+__cold int ipc_buffer_place(struct ipc *ipc, struct comp_buffer *buffer,
+			    struct comp_dev *source, struct comp_dev *sink)
+{
+	struct ipc_comp_dev *ipc_pipe;
+	uint32_t period = 0;
+
+	assert_can_be_cold();
+
+	ipc_pipe = ipc_get_comp_by_ppl_id(ipc, COMP_TYPE_PIPELINE,
+					  source->ipc_config.pipeline_id, IPC_COMP_ALL);
+	if (ipc_pipe && ipc_pipe->pipeline)
+		period = ipc_pipe->pipeline->period;
+
+	return buffer_place(buffer, source->ipc_config.core, sink->ipc_config.core, period);
+}
+
 int ipc_pipeline_complete(struct ipc *ipc, uint32_t comp_id)
 {
 	struct ipc_comp_dev *ipc_pipe;
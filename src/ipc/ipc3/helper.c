@@ -635,6 +635,10 @@ int ipc_comp_connect(struct ipc *ipc, ipc_pipe_comp_connect *_connect)
 	struct sof_ipc_pipe_comp_connect *connect = ipc_from_pipe_connect(_connect);
 	struct ipc_comp_dev *icd_source;
 	struct ipc_comp_dev *icd_sink;
+	struct comp_buffer *buffer;
+	struct comp_dev *source;
+	struct comp_dev *sink;
+	int ret;
 
 	/* check whether the components already exist */
 	icd_source = ipc_get_comp_dev(ipc, COMP_TYPE_ANY, connect->source_id);
@@ -653,16 +657,29 @@ int ipc_comp_connect(struct ipc *ipc, ipc_pipe_comp_connect *_connect)
 
 	/* check source and sink types */
 	if (icd_source->type == COMP_TYPE_BUFFER &&
-	    icd_sink->type == COMP_TYPE_COMPONENT)
-		return ipc_buffer_to_comp_connect(icd_source, icd_sink);
-	else if (icd_source->type == COMP_TYPE_COMPONENT &&
-		 icd_sink->type == COMP_TYPE_BUFFER)
-		return ipc_comp_to_buffer_connect(icd_source, icd_sink);
-	else {
+	    icd_sink->type == COMP_TYPE_COMPONENT) {
+		buffer = icd_source->cb;
+		ret = ipc_buffer_to_comp_connect(icd_source, icd_sink);
+	} else if (icd_source->type == COMP_TYPE_COMPONENT &&
+		 icd_sink->type == COMP_TYPE_BUFFER) {
+		buffer = icd_sink->cb;
+		ret = ipc_comp_to_buffer_connect(icd_source, icd_sink);
+	} else {
 		tr_err(&ipc_tr, "invalid source and sink types, connect->source_id = %u, connect->sink_id = %u",
 		       connect->source_id, connect->sink_id);
 		return -EINVAL;
 	}
+
+	if (ret < 0)
+		return ret;
+
+	/* both ends are known after the second connection, place the buffer */
+	source = comp_buffer_get_source_component(buffer);
+	sink = comp_buffer_get_sink_component(buffer);
+	if (source && sink)
+		return ipc_buffer_place(ipc, buffer, source, sink);
+
+	return 0;
 }
 
 int ipc_comp_new(struct ipc *ipc, ipc_comp *_comp)
@@ -585,6 +585,15 @@ __cold int ipc_comp_connect(struct ipc *ipc, ipc_pipe_comp_connect *_connect)
 		return IPC4_OUT_OF_MEMORY;
 	}
 
+	/*
+	 * Both ends are known, place the buffer before it is connected. IPC4 passes
+	 * no memory hints for buffers and runs all LL pipelines at the LL tick, so
+	 * this only records whether the buffer is shared between cores.
+	 */
+	ret = ipc_buffer_place(ipc, buffer, source, sink);
+	if (ret < 0)
+		goto free;
+
 	/*
 	 * set min_free_space and min_available in sink/src api of created buffer.
 	 * buffer is connected like:
@@ -18,6 +18,7 @@
 #include <rtos/sof.h>
 #include <rtos/symbol.h>
 #include <ipc/topology.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 LOG_MODULE_REGISTER(notifier, CONFIG_SOF_LOG_LEVEL);
@@ -36,6 +37,43 @@ struct callback_handle {
 	uint32_t num_registrations;
 };
 
+static inline struct list_item *notifier_caller_list(struct notify *notify,
+						     const void *caller,
+						     enum notify_id type)
+{
+	uintptr_t addr = (uintptr_t)caller;
+
+	/* callers are heap objects: fold in higher address bits and drop
+	 * the always-zero alignment bits
+	 */
+	addr ^= addr >> 6;
+
+	return &notify->caller_list[type][(addr >> 3) % NOTIFIER_CALLER_HASH_SIZE];
+}
+
+/* list a callback handle with the given caller filter belongs to */
+static inline struct list_item *notifier_handle_list(struct notify *notify,
+						     const void *caller,
+						     enum notify_id type)
+{
+	return caller ? notifier_caller_list(notify, caller, type) : &notify->list[type];
+}
+
+static struct callback_handle *notifier_first_handle(struct notify *notify,
+						     enum notify_id type)
+{
+	struct list_item *list = &notify->list[type];
+	int i;
+
+	for (i = 0; list_is_empty(list) && i < NOTIFIER_CALLER_HASH_SIZE; i++)
+		list = &notify->caller_list[type][i];
+
+	if (list_is_empty(list))
+		return NULL;
+
+	return container_of(list->next, struct callback_handle, list);
+}
+
 int notifier_register(void *receiver, void *caller, enum notify_id type,
 		      void (*cb)(void *arg, enum notify_id type, void *data),
 		      uint32_t flags)
@@ -50,13 +88,12 @@ int notifier_register(void *receiver, void *caller, enum notify_id type,
 	key = k_spin_lock(&notify->lock);
 
 	/* Find already registered event of this type */
-	if (flags & NOTIFIER_FLAG_AGGREGATE &&
-	    !list_is_empty(&notify->list[type])) {
-		handle = container_of((&notify->list[type])->next,
-				      struct callback_handle, list);
-		handle->num_registrations++;
-
-		goto out;
+	if (flags & NOTIFIER_FLAG_AGGREGATE) {
+		handle = notifier_first_handle(notify, type);
+		if (handle) {
+			handle->num_registrations++;
+			goto out;
+		}
 	}
 
 	handle = rzalloc(SOF_MEM_FLAG_USER,
@@ -73,7 +110,7 @@ int notifier_register(void *receiver, void *caller, enum notify_id type,
 	handle->cb = cb;
 	handle->num_registrations = 1;
 
-	list_item_prepend(&handle->list, &notify->list[type]);
+	list_item_prepend(&handle->list, notifier_handle_list(notify, caller, type));
 
 out:
 	k_spin_unlock(&notify->lock, key);
@@ -81,13 +118,30 @@ out:
 }
 EXPORT_SYMBOL(notifier_register);
 
-void notifier_unregister(void *receiver, void *caller, enum notify_id type)
+static void notifier_unregister_list(struct list_item *list, void *receiver,
+				     void *caller)
 {
-	struct notify *notify = *arch_notify_get();
 	struct list_item *wlist;
 	struct list_item *tlist;
 	struct callback_handle *handle;
+
+	list_for_item_safe(wlist, tlist, list) {
+		handle = container_of(wlist, struct callback_handle, list);
+		if ((!receiver || handle->receiver == receiver) &&
+		    (!caller || handle->caller == caller)) {
+			if (!--handle->num_registrations) {
+				list_item_del(&handle->list);
+				rfree(handle);
+			}
+		}
+	}
+}
+
+void notifier_unregister(void *receiver, void *caller, enum notify_id type)
+{
+	struct notify *notify = *arch_notify_get();
 	k_spinlock_key_t key;
+	int i;
 
 	assert(type >= NOTIFIER_ID_CPU_FREQ && type < NOTIFIER_ID_COUNT);
 
@@ -103,15 +157,15 @@ void notifier_unregister(void *receiver, void *caller, enum notify_id type)
 	 * Event consumer might unregister from all callers by passing caller
 	 * NULL
 	 */
-	list_for_item_safe(wlist, tlist, &notify->list[type]) {
-		handle = container_of(wlist, struct callback_handle, list);
-		if ((!receiver || handle->receiver == receiver) &&
-		    (!caller || handle->caller == caller)) {
-			if (!--handle->num_registrations) {
-				list_item_del(&handle->list);
-				rfree(handle);
-			}
-		}
+	if (caller) {
+		/* only handles filtered on this caller can match */
+		notifier_unregister_list(notifier_caller_list(notify, caller, type),
+					 receiver, caller);
+	} else {
+		notifier_unregister_list(&notify->list[type], receiver, NULL);
+		for (i = 0; i < NOTIFIER_CALLER_HASH_SIZE; i++)
+			notifier_unregister_list(&notify->caller_list[type][i],
+						 receiver, NULL);
 	}
 
 	k_spin_unlock(&notify->lock, key);
@@ -126,42 +180,153 @@ void notifier_unregister_all(void *receiver, void *caller)
 		notifier_unregister(receiver, caller, i);
 }
 
-static void notifier_notify(const void *caller, enum notify_id type, void *data)
+static void notifier_notify_list(struct list_item *list, const void *caller,
+				 enum notify_id type, void *data)
 {
-	struct notify *notify = *arch_notify_get();
 	struct list_item *wlist;
 	struct list_item *tlist;
 	struct callback_handle *handle;
 
-	/* iterate through notifiers and send event to
-	 * interested clients
-	 */
-	list_for_item_safe(wlist, tlist, &notify->list[type]) {
+	list_for_item_safe(wlist, tlist, list) {
 		handle = container_of(wlist, struct callback_handle, list);
 		if (!caller || !handle->caller || handle->caller == caller)
 			handle->cb(handle->receiver, type, data);
 	}
 }
 
+/* true when at least one callback would be run for the event */
+static bool notifier_has_receivers(struct notify *notify, const void *caller,
+				   enum notify_id type)
+{
+	if (!list_is_empty(&notify->list[type]))
+		return true;
+
+	if (caller)
+		return !list_is_empty(notifier_caller_list(notify, caller, type));
+
+	return !!notifier_first_handle(notify, type);
+}
+
+static void notifier_notify(const void *caller, enum notify_id type, void *data)
+{
+	struct notify *notify = *arch_notify_get();
+	int i;
+
+	/* iterate through notifiers and send event to
+	 * interested clients, a caller only has to look at the handles
+	 * without filter and at its own bucket
+	 */
+	notifier_notify_list(&notify->list[type], caller, type, data);
+
+	if (caller) {
+		notifier_notify_list(notifier_caller_list(notify, caller, type),
+				     caller, type, data);
+		return;
+	}
+
+	for (i = 0; i < NOTIFIER_CALLER_HASH_SIZE; i++)
+		notifier_notify_list(&notify->caller_list[type][i], caller, type, data);
+}
+
 void notifier_notify_remote(void)
 {
 	struct notify *notify = *arch_notify_get();
 	struct notify_data *notify_data = notify_data_get() + cpu_get_id();
+	struct notify_event event;
+	k_spinlock_key_t key;
+
+	/* run every event queued since the IDC message has been sent */
+	for (;;) {
+		key = k_spin_lock(&notify_data->lock);
+
+		if (!notify_data->count) {
+			k_spin_unlock(&notify_data->lock, key);
+			break;
+		}
+
+		event = notify_data->events[notify_data->first];
+		notify_data->first = (notify_data->first + 1) % NOTIFIER_REMOTE_QUEUE_SIZE;
+		notify_data->count--;
+
+		k_spin_unlock(&notify_data->lock, key);
+
+		if (notifier_has_receivers(notify, event.caller, event.type)) {
+			dcache_invalidate_region((__sparse_force void __sparse_cache *)event.data,
+						 event.data_size);
+			notifier_notify(event.caller, event.type, event.data);
+		}
+	}
+}
+
+/* queues event for the remote core, returns true if an IDC has to be sent */
+static bool notifier_queue_remote(struct notify_data *notify_data, const void *caller,
+				  enum notify_id type, void *data, uint32_t data_size)
+{
+	struct notify_event *event;
+	k_spinlock_key_t key;
+	bool was_empty;
 
-	if (!list_is_empty(&notify->list[notify_data->type])) {
-		dcache_invalidate_region((__sparse_force void __sparse_cache *)notify_data->data,
-					 notify_data->data_size);
-		notifier_notify(notify_data->caller, notify_data->type,
-				notify_data->data);
+	key = k_spin_lock(&notify_data->lock);
+
+	if (notify_data->count == NOTIFIER_REMOTE_QUEUE_SIZE) {
+		notify_data->dropped++;
+		k_spin_unlock(&notify_data->lock, key);
+		tr_err(&nt_tr, "notifier_queue_remote(): queue full, event %u dropped",
+		       type);
+		return false;
 	}
 
+	was_empty = !notify_data->count;
+
+	event = &notify_data->events[(notify_data->first + notify_data->count) %
+				     NOTIFIER_REMOTE_QUEUE_SIZE];
+	event->caller = caller;
+	event->type = type;
+
+	/* NOTE: for transcore events, payload has to
+	 * be allocated on heap, not on stack
+	 */
+	event->data = data;
+	event->data_size = data_size;
+	notify_data->count++;
+
+	k_spin_unlock(&notify_data->lock, key);
+
+	/* a non-empty queue already has an IDC message in flight */
+	return was_empty;
+}
+
+/*
+ * Sends the IDC message draining the queue. Without it the queued events would
+ * never run, and a non-empty queue would keep later events from sending
+ * another one, so on failure they are dropped.
+ */
+static void notifier_kick_remote(struct notify_data *notify_data, struct idc_msg *notify_msg)
+{
+	k_spinlock_key_t key;
+	uint32_t dropped;
+	int ret;
+
+	ret = idc_send_msg(notify_msg, IDC_NON_BLOCKING);
+	if (ret >= 0)
+		return;
+
+	key = k_spin_lock(&notify_data->lock);
+	dropped = notify_data->count;
+	notify_data->dropped += dropped;
+	notify_data->count = 0;
+	k_spin_unlock(&notify_data->lock, key);
+
+	tr_err(&nt_tr, "notifier_kick_remote(): IDC to core %u failed %d, %u events dropped",
+	       notify_msg->core, ret, dropped);
 }
 
 void notifier_event(const void *caller, enum notify_id type, uint32_t core_mask,
 		    void *data, uint32_t data_size)
 {
-	struct notify_data *notify_data;
 	struct idc_msg notify_msg = { IDC_MSG_NOTIFY, IDC_MSG_NOTIFY_EXT };
+	bool written_back = false;
+	void __sparse_cache *data_c = (__sparse_force void __sparse_cache *)data;
 	int i;
 
 	/* notify selected targets */
@@ -170,21 +335,17 @@ void notifier_event(const void *caller, enum notify_id type, uint32_t core_mask,
 			if (i == cpu_get_id()) {
 				notifier_notify(caller, type, data);
 			} else if (cpu_is_core_enabled(i)) {
-				notify_msg.core = i;
-				notify_data = notify_data_get() + i;
-				notify_data->caller = caller;
-				notify_data->type = type;
-
-				/* NOTE: for transcore events, payload has to
-				 * be allocated on heap, not on stack
-				 */
-				notify_data->data = data;
-				notify_data->data_size = data_size;
-
-				dcache_writeback_region((__sparse_force void __sparse_cache *)
-							notify_data->data, data_size);
-
-				idc_send_msg(&notify_msg, IDC_NON_BLOCKING);
+				/* payload is the same for all cores */
+				if (!written_back) {
+					dcache_writeback_region(data_c, data_size);
+					written_back = true;
+				}
+
+				if (notifier_queue_remote(notify_data_get() + i, caller, type,
+							  data, data_size)) {
+					notify_msg.core = i;
+					notifier_kick_remote(notify_data_get() + i, &notify_msg);
+				}
 			}
 		}
 	}
@@ -193,7 +354,8 @@ void notifier_event(const void *caller, enum notify_id type, uint32_t core_mask,
 void init_system_notify(struct sof *sof)
 {
 	struct notify **notify = arch_notify_get();
-	int i;
+	int i, j;
+
 	*notify = rzalloc(SOF_MEM_FLAG_USER | SOF_MEM_FLAG_COHERENT,
 			  sizeof(**notify));
 	if (!*notify) {
@@ -202,12 +364,18 @@ void init_system_notify(struct sof *sof)
 	}
 
 	k_spinlock_init(&(*notify)->lock);
-	for (i = NOTIFIER_ID_CPU_FREQ; i < NOTIFIER_ID_COUNT; i++)
+	for (i = NOTIFIER_ID_CPU_FREQ; i < NOTIFIER_ID_COUNT; i++) {
 		list_init(&(*notify)->list[i]);
+		for (j = 0; j < NOTIFIER_CALLER_HASH_SIZE; j++)
+			list_init(&(*notify)->caller_list[i][j]);
+	}
 
-	if (cpu_get_id() == PLATFORM_PRIMARY_CORE_ID)
+	if (cpu_get_id() == PLATFORM_PRIMARY_CORE_ID) {
 		sof->notify_data = platform_shared_get(notify_data_shared,
 						       sizeof(notify_data_shared));
+		for (i = 0; i < CONFIG_CORE_COUNT; i++)
+			k_spinlock_init(&sof->notify_data[i].lock);
+	}
 }
 
 void free_system_notify(void)
@@ -17,6 +17,7 @@
 
 #include <rtos/sof.h>
 #include <rtos/spinlock.h>
+#include <rtos/timer.h>
 #include <sof/lib/cpu-clk-manager.h>
 #include <sof/lib_manager.h>
 #include <sof/lib/regions_mm.h>
@@ -48,6 +49,48 @@ extern struct tr_ctx lib_manager_tr;
 
 #define PAGE_SZ		CONFIG_MM_DRV_PAGE_SIZE
 
+/* Load, link and unmap costs, protected by IPC serialization */
+static struct llext_manager_stats llext_stats;
+
+#if CONFIG_LLEXT_MANAGER_CACHE
+/*
+ * Modules without instances, whose .text and .rodata are kept mapped,
+ * least recently used first. The page allocator may evict them from other
+ * threads, so the cache and the mapping of modules and their dependencies
+ * are protected by llext_cache_lock, a recursive mutex.
+ */
+static struct list_item llext_cache = LIST_INIT(llext_cache);
+static K_MUTEX_DEFINE(llext_cache_lock);
+
+/* Prefetching only uses free memory, it doesn't evict other modules */
+static bool llext_prefetching;
+
+static bool llext_manager_cache_evict(void);
+#endif
+
+static inline void llext_manager_cache_lock(void)
+{
+#if CONFIG_LLEXT_MANAGER_CACHE
+	k_mutex_lock(&llext_cache_lock, K_FOREVER);
+#endif
+}
+
+static inline void llext_manager_cache_unlock(void)
+{
+#if CONFIG_LLEXT_MANAGER_CACHE
+	k_mutex_unlock(&llext_cache_lock);
+#endif
+}
+
+static inline bool llext_manager_is_cached(const struct lib_manager_module *mctx)
+{
+#if CONFIG_LLEXT_MANAGER_CACHE
+	return mctx->cached;
+#else
+	return false;
+#endif
+}
+
 static int llext_manager_update_flags(void __sparse_cache *vma, size_t size, uint32_t flags)
 {
 	size_t pre_pad_size = (uintptr_t)vma & (PAGE_SZ - 1);
@@ -109,6 +152,12 @@ static int llext_manager_load_data_from_storage(const struct sys_mm_drv_region *
 
 	int ret = llext_manager_align_map(virtual_region, vma, size, SYS_MM_MEM_PERM_RW);
 
+#if CONFIG_LLEXT_MANAGER_CACHE
+	/* Out of memory, drop least recently used cached modules, unless prefetching */
+	while (ret < 0 && !llext_prefetching && llext_manager_cache_evict())
+		ret = llext_manager_align_map(virtual_region, vma, size, SYS_MM_MEM_PERM_RW);
+#endif
+
 	if (ret < 0) {
 		tr_err(&lib_manager_tr, "cannot map %u of %p", size, (__sparse_force void *)vma);
 		return ret;
@@ -197,6 +246,16 @@ static void llext_manager_unmap_detached_sections(const struct llext_loader *ldr
 #endif
 }
 
+/* Unmap one segment of a module together with its detached sections */
+static int llext_manager_unmap_segment(struct lib_manager_module *mctx,
+				       enum llext_mem region,
+				       void __sparse_cache *vma, size_t size)
+{
+	llext_manager_unmap_detached_sections(&mctx->ebl->loader, mctx->llext, region,
+					      vma, size);
+	return llext_manager_align_unmap(vma, size);
+}
+
 static int llext_manager_load_module(struct lib_manager_module *mctx)
 {
 	/* Executable code (.text) */
@@ -257,17 +316,22 @@ static int llext_manager_load_module(struct lib_manager_module *mctx)
 	if (!virtual_region || !virtual_region->size)
 		return -EFAULT;
 
-	/* Copy Code */
-	ret = llext_manager_load_data_from_storage(virtual_region, ldr, ext, LLEXT_MEM_TEXT,
-						   va_base_text, text_size, SYS_MM_MEM_PERM_EXEC);
-	if (ret < 0)
-		return ret;
+	/* A cached module still has its code and read-only data mapped */
+	if (!llext_manager_is_cached(mctx)) {
+		/* Copy Code */
+		ret = llext_manager_load_data_from_storage(virtual_region, ldr, ext,
+							   LLEXT_MEM_TEXT, va_base_text,
+							   text_size, SYS_MM_MEM_PERM_EXEC);
+		if (ret < 0)
+			return ret;
 
-	/* Copy read-only data */
-	ret = llext_manager_load_data_from_storage(virtual_region, ldr, ext, LLEXT_MEM_RODATA,
-						   va_base_rodata, rodata_size, 0);
-	if (ret < 0)
-		goto e_text;
+		/* Copy read-only data */
+		ret = llext_manager_load_data_from_storage(virtual_region, ldr, ext,
+							   LLEXT_MEM_RODATA, va_base_rodata,
+							   rodata_size, 0);
+		if (ret < 0)
+			goto e_text;
+	}
 
 	/* Copy writable data */
 	/*
@@ -286,6 +350,8 @@ static int llext_manager_load_module(struct lib_manager_module *mctx)
 	return 0;
 
 e_rodata:
+	if (llext_manager_is_cached(mctx))
+		return ret;
 	llext_manager_align_unmap(va_base_rodata, rodata_size);
 e_text:
 	llext_manager_align_unmap(va_base_text, text_size);
@@ -295,9 +361,6 @@ e_text:
 
 static int llext_manager_unload_module(struct lib_manager_module *mctx)
 {
-	const struct llext_loader *ldr = &mctx->ebl->loader;
-	const struct llext *ext = mctx->llext;
-
 	/* Executable code (.text) */
 	void __sparse_cache *va_base_text = (void __sparse_cache *)
 		mctx->segment[LIB_MANAGER_TEXT].addr;
@@ -313,27 +376,31 @@ static int llext_manager_unload_module(struct lib_manager_module *mctx)
 		mctx->segment[LIB_MANAGER_DATA].addr;
 	size_t data_size = mctx->segment[LIB_MANAGER_DATA].size +
 		mctx->segment[LIB_MANAGER_BSS].size;
+	uint64_t start = sof_cycle_get_64();
 	int err = 0, ret;
 
-	llext_manager_unmap_detached_sections(ldr, ext, LLEXT_MEM_TEXT,
-					      va_base_text, text_size);
-	ret = llext_manager_align_unmap(va_base_text, text_size);
-	if (ret < 0)
-		err = ret;
+	/* Writable data has already been unmapped when the module was cached */
+	if (mctx->mapped) {
+		ret = llext_manager_unmap_segment(mctx, LLEXT_MEM_DATA, va_base_data, data_size);
+		if (ret < 0)
+			err = ret;
+	}
 
-	llext_manager_unmap_detached_sections(ldr, ext, LLEXT_MEM_DATA,
-					      va_base_data, data_size);
-	ret = llext_manager_align_unmap(va_base_data, data_size);
+	ret = llext_manager_unmap_segment(mctx, LLEXT_MEM_TEXT, va_base_text, text_size);
 	if (ret < 0 && !err)
 		err = ret;
 
-	llext_manager_unmap_detached_sections(ldr, ext, LLEXT_MEM_RODATA,
-					      va_base_rodata, rodata_size);
-	ret = llext_manager_align_unmap(va_base_rodata, rodata_size);
+	ret = llext_manager_unmap_segment(mctx, LLEXT_MEM_RODATA, va_base_rodata, rodata_size);
 	if (ret < 0 && !err)
 		err = ret;
 
 	mctx->mapped = false;
+#if CONFIG_LLEXT_MANAGER_CACHE
+	mctx->cached = false;
+#endif
+
+	llext_stats.unmap_count++;
+	llext_stats.unmap_cycles += sof_cycle_get_64() - start;
 
 	return err;
 }
@@ -376,9 +443,14 @@ static int llext_manager_link(const char *name,
 			.keep_section_info = true,
 		};
 
+		uint64_t start = sof_cycle_get_64();
+
 		ret = llext_load(ldr, name, llext, &ldr_parm);
 		if (ret)
 			return ret;
+
+		llext_stats.link_count++;
+		llext_stats.link_cycles += sof_cycle_get_64() - start;
 	}
 
 	/* All code sections */
@@ -623,6 +695,171 @@ static void llext_manager_depend_unlink_rollback(struct lib_manager_module *dep_
 			llext_manager_unload_module(dep_ctx[n]);
 }
 
+/* Drop references to all dependencies of a module */
+static void llext_manager_depend_put(struct lib_manager_module *mctx)
+{
+	struct lib_manager_module *dep_ctx[LLEXT_MAX_DEPENDENCIES] = {};
+	int i;	/* signed to match llext_manager_depend_unlink_rollback() */
+
+	for (i = 0; i < ARRAY_SIZE(mctx->llext->dependency); i++)
+		if (llext_lib_find(mctx->llext->dependency[i], &dep_ctx[i]) < 0)
+			break;
+
+	if (i)
+		llext_manager_depend_unlink_rollback(dep_ctx, i - 1);
+}
+
+#if CONFIG_LLEXT_MANAGER_CACHE
+/*
+ * The last instance of a module is gone: unmap its writable data but keep
+ * code, read-only data and dependencies resident until memory is needed.
+ */
+static int llext_manager_cache_put(struct lib_manager_module *mctx)
+{
+	void __sparse_cache *va_base_data = (void __sparse_cache *)
+		mctx->segment[LIB_MANAGER_DATA].addr;
+	size_t data_size = mctx->segment[LIB_MANAGER_DATA].size +
+		mctx->segment[LIB_MANAGER_BSS].size;
+	uint64_t start = sof_cycle_get_64();
+	int ret;
+
+	ret = llext_manager_unmap_segment(mctx, LLEXT_MEM_DATA, va_base_data, data_size);
+
+	mctx->mapped = false;
+	mctx->cached = true;
+	list_item_append(&mctx->cache_list, &llext_cache);
+
+	llext_stats.unmap_count++;
+	llext_stats.unmap_cycles += sof_cycle_get_64() - start;
+
+	return ret;
+}
+
+/* Fully unload the least recently used cached module */
+static bool llext_manager_cache_evict(void)
+{
+	struct lib_manager_module *mctx;
+
+	if (list_is_empty(&llext_cache))
+		return false;
+
+	mctx = list_first_item(&llext_cache, struct lib_manager_module, cache_list);
+	list_item_del(&mctx->cache_list);
+
+	tr_info(&lib_manager_tr, "evicting %s", mctx->llext->name);
+
+	llext_manager_depend_put(mctx);
+	llext_manager_unload_module(mctx);
+	llext_stats.evictions++;
+
+	return true;
+}
+
+void llext_manager_cache_flush(void)
+{
+	llext_manager_cache_lock();
+	while (llext_manager_cache_evict())
+		;
+	llext_manager_cache_unlock();
+}
+
+bool llext_manager_cache_reclaim(void)
+{
+	bool evicted;
+
+	/* Don't wait for the IPC thread, the allocation fails instead */
+	if (k_is_in_isr() || k_mutex_lock(&llext_cache_lock, K_NO_WAIT))
+		return false;
+
+	evicted = llext_manager_cache_evict();
+	k_mutex_unlock(&llext_cache_lock);
+
+	return evicted;
+}
+#endif
+
+/* Map a module and, unless it is cached, its dependencies into SRAM */
+static int llext_manager_map_module(struct lib_manager_module *mctx)
+{
+	uint64_t start = sof_cycle_get_64();
+	int i, ret;
+
+#if CONFIG_LLEXT_MANAGER_CACHE
+	if (mctx->cached) {
+		/* Dependencies are still held, only writable data needs restoring */
+		list_item_del(&mctx->cache_list);
+		ret = llext_manager_load_module(mctx);
+		if (ret < 0) {
+			list_item_append(&mctx->cache_list, &llext_cache);
+			return ret;
+		}
+
+		mctx->cached = false;
+		llext_stats.cache_hits++;
+		goto out;
+	}
+#endif
+
+	/*
+	 * Check if any dependencies need to be mapped - collect
+	 * pointers to library contexts
+	 */
+	struct lib_manager_module *dep_ctx[LLEXT_MAX_DEPENDENCIES] = {};
+
+	for (i = 0; i < ARRAY_SIZE(mctx->llext->dependency); i++) {
+		struct lib_manager_module *dep;
+
+		/* Dependencies are filled from the beginning of the array upwards */
+		if (!mctx->llext->dependency[i])
+			break;
+
+		ret = llext_lib_find(mctx->llext->dependency[i], &dep);
+		if (ret < 0) {
+			tr_err(&lib_manager_tr,
+			       "Unmet dependency: cannot find dependency %u", i);
+			continue;
+		}
+
+		tr_dbg(&lib_manager_tr, "%s depending on %s index %u, %u users",
+		       mctx->llext->name, mctx->llext->dependency[i]->name,
+		       dep->start_idx, dep->n_dependent);
+
+		/*
+		 * Protected by the IPC serialization, but maybe we should protect the
+		 * dependent-count explicitly too. It is incremented when a new dependent
+		 * is identified. If it's non-zero, then some other modules also depend
+		 * on it and have already mapped it.
+		 */
+		if (dep->n_dependent++)
+			continue;
+
+		/* First user of this dependency, load it into SRAM */
+		ret = llext_manager_load_module(dep);
+		if (ret < 0) {
+			dep->n_dependent--;
+			llext_manager_depend_unlink_rollback(dep_ctx, i - 1);
+			return ret;
+		}
+
+		dep_ctx[i] = dep;
+	}
+
+	/* Map executable code and data */
+	ret = llext_manager_load_module(mctx);
+	if (ret < 0) {
+		llext_manager_depend_put(mctx);
+		return ret;
+	}
+
+#if CONFIG_LLEXT_MANAGER_CACHE
+out:
+#endif
+	llext_stats.load_count++;
+	llext_stats.load_cycles += sof_cycle_get_64() - start;
+
+	return 0;
+}
+
 uintptr_t llext_manager_allocate_module(const struct comp_ipc_config *ipc_config,
 					const void *ipc_specific_config)
 {
@@ -661,54 +898,10 @@ uintptr_t llext_manager_allocate_module(const struct comp_ipc_config *ipc_config
 	}
 
 	if (!mctx->mapped) {
-		int i, ret;
-
-		/*
-		 * Check if any dependencies need to be mapped - collect
-		 * pointers to library contexts
-		 */
-		struct lib_manager_module *dep_ctx[LLEXT_MAX_DEPENDENCIES] = {};
-
-		for (i = 0; i < ARRAY_SIZE(mctx->llext->dependency); i++) {
-			struct lib_manager_module *dep;
-
-			/* Dependencies are filled from the beginning of the array upwards */
-			if (!mctx->llext->dependency[i])
-				break;
-
-			ret = llext_lib_find(mctx->llext->dependency[i], &dep);
-			if (ret < 0) {
-				tr_err(&lib_manager_tr,
-				       "Unmet dependency: cannot find dependency %u", i);
-				continue;
-			}
+		llext_manager_cache_lock();
+		int ret = llext_manager_map_module(mctx);
 
-			tr_dbg(&lib_manager_tr, "%s depending on %s index %u, %u users",
-			       mctx->llext->name, mctx->llext->dependency[i]->name,
-			       dep->start_idx, dep->n_dependent);
-
-			/*
-			 * Protected by the IPC serialization, but maybe we should protect the
-			 * dependent-count explicitly too. It is incremented when a new dependent
-			 * is identified. If it's non-zero, then some other modules also depend
-			 * on it and have already mapped it.
-			 */
-			if (dep->n_dependent++)
-				continue;
-
-			/* First user of this dependency, load it into SRAM */
-			ret = llext_manager_load_module(dep);
-			if (ret < 0) {
-				dep->n_dependent--;
-				llext_manager_depend_unlink_rollback(dep_ctx, i - 1);
-				return 0;
-			}
-
-			dep_ctx[i] = dep;
-		}
-
-		/* Map executable code and data */
-		ret = llext_manager_load_module(mctx);
+		llext_manager_cache_unlock();
 		if (ret < 0)
 			return 0;
 	}
@@ -760,17 +953,6 @@ int llext_manager_free_module(const uint32_t component_id)
 		return 0;
 	}
 
-	struct lib_manager_module *dep_ctx[LLEXT_MAX_DEPENDENCIES] = {};
-	int i;	/* signed to match llext_manager_depend_unlink_rollback() */
-
-	for (i = 0; i < ARRAY_SIZE(mctx->llext->dependency); i++)
-		if (llext_lib_find(mctx->llext->dependency[i], &dep_ctx[i]) < 0)
-			break;
-
-	/* Last user cleaning up, put dependencies */
-	if (i)
-		llext_manager_depend_unlink_rollback(dep_ctx, i - 1);
-
 	/*
 	 * The last instance of the module has been destroyed and it can now be
 	 * unloaded from SRAM
@@ -780,8 +962,53 @@ int llext_manager_free_module(const uint32_t component_id)
 	/* Since the LLEXT context now is preserved, we have to flush logs ourselves */
 	log_flush();
 
+#if CONFIG_LLEXT_MANAGER_CACHE
+	llext_manager_cache_lock();
+	int ret = llext_manager_cache_put(mctx);
+
+	llext_manager_cache_unlock();
+
+	return ret;
+#else
+	/* Last user cleaning up, put dependencies */
+	llext_manager_depend_put(mctx);
+
 	return llext_manager_unload_module(mctx);
+#endif
+}
+
+#if CONFIG_LLEXT_MANAGER_PREFETCH
+/*
+ * Link a module and load it into the cache, so that creating its first
+ * instance only needs to restore writable data.
+ */
+static int llext_manager_prefetch(uint32_t module_id, const struct sof_man_fw_desc *desc,
+				  struct lib_manager_mod_ctx *ctx)
+{
+	const struct sof_man_module_manifest *mod_manifest;
+	const void *buildinfo;
+	struct lib_manager_module *mctx;
+	int ret;
+
+	ret = llext_manager_link_single(module_id, desc, ctx, &buildinfo, &mod_manifest);
+	if (ret < 0)
+		return ret;
+
+	mctx = ctx->mod + ret;
+	if (mctx->mapped || mctx->cached)
+		return 0;
+
+	llext_manager_cache_lock();
+	llext_prefetching = true;
+	ret = llext_manager_map_module(mctx);
+	llext_prefetching = false;
+	if (!ret)
+		ret = llext_manager_cache_put(mctx);
+	llext_manager_cache_unlock();
+
+	return ret;
 }
+#endif
 
 /* An auxiliary library has been loaded, need to read in its exported symbols */
 int llext_manager_add_library(uint32_t module_id)
@@ -813,9 +1040,36 @@ int llext_manager_add_library(uint32_t module_id)
 		}
 	}
 
+#if CONFIG_LLEXT_MANAGER_PREFETCH
+	/*
+	 * The host loads libraries for the modules its topology uses, get
+	 * them linked and resident now rather than on first stream start.
+	 */
+	for (i = 0; i < ctx->n_mod; i++) {
+		uint32_t mod_id = module_id + ctx->mod[i].start_idx;
+		const struct sof_man_module *mod = lib_manager_get_module_manifest(mod_id);
+		int ret;
+
+		if (mod->type.load_type != SOF_MAN_MOD_TYPE_LLEXT)
+			continue;
+
+		ret = llext_manager_prefetch(mod_id, desc, ctx);
+		if (ret < 0) {
+			tr_warn(&lib_manager_tr, "module_id: %#x: prefetch failed: %d",
+				mod_id, ret);
+			break;
+		}
+	}
+#endif
+
 	return 0;
 }
 
+void llext_manager_get_stats(struct llext_manager_stats *stats)
+{
+	*stats = llext_stats;
+}
+
 bool comp_is_llext(struct comp_dev *comp)
 {
 	const uint32_t module_id = IPC4_MOD_ID(comp->ipc_config.id);
@@ -43,6 +43,9 @@ int llext_manager_store_to_dram(void)
 		return 0;
 	}
 
+	/* Unused modules aren't worth saving, drop them */
+	llext_manager_cache_flush();
+
 	/*
 	 * Count libraries, modules, instantiated extensions, sections and exported
 	 * symbols in them. Allocate a buffer of required size.
@@ -5,56 +5,228 @@
 // Author: Seppo Ingalsuo <seppo.ingalsuo@linux.intel.com>
 
 #include <sof/math/matrix.h>
+#include <sof/math/numbers.h>
 #include <errno.h>
 #include <stdint.h>
 
+/* Columns of c accumulated at a time, fits the accumulators in registers */
+#define MAT_BLOCK_COLUMNS	8
+
+/* Shifts accumulated products to the Q format of c, shift_minus_one -1 is for Q0 data */
+static inline int64_t mat_shift_rnd(int64_t s, int shift_minus_one)
+{
+	if (shift_minus_one == -1)
+		return s;
+
+	return ((s >> shift_minus_one) + 1) >> 1;
+}
+
+/*
+ * The matrix products below walk the rows of b contiguously for a block of c
+ * columns, so the inner loop vectorizes. A zero in a skips the whole row of b,
+ * that is common with filterbank outputs and sparse feature data.
+ */
 int mat_multiply(struct mat_matrix_16b *a, struct mat_matrix_16b *b, struct mat_matrix_16b *c)
 {
-	int64_t s;
+	int64_t s[MAT_BLOCK_COLUMNS];
 	int16_t *x;
 	int16_t *y;
-	int16_t *z = c->data;
-	int i, j, k;
-	int y_inc = b->columns;
+	int16_t *z;
+	int i, j, k, m, n;
 	const int shift_minus_one = a->fractions + b->fractions - c->fractions - 1;
 
 	if (a->columns != b->rows || a->rows != c->rows || b->columns != c->columns)
 		return -EINVAL;
 
-	/* If all data is Q0 */
-	if (shift_minus_one == -1) {
-		for (i = 0; i < a->rows; i++) {
-			for (j = 0; j < b->columns; j++) {
-				s = 0;
-				x = a->data + a->columns * i;
-				y = b->data + j;
-				for (k = 0; k < b->rows; k++) {
-					s += (int32_t)(*x) * (*y);
-					x++;
-					y += y_inc;
-				}
-				*z = (int16_t)s; /* For Q16.0 */
-				z++;
+	for (i = 0; i < a->rows; i++) {
+		x = a->data + a->columns * i;
+		z = c->data + c->columns * i;
+		for (j = 0; j < b->columns; j += MAT_BLOCK_COLUMNS) {
+			n = MIN(MAT_BLOCK_COLUMNS, b->columns - j);
+			for (m = 0; m < n; m++)
+				s[m] = 0;
+
+			for (k = 0; k < a->columns; k++) {
+				if (!x[k])
+					continue;
+
+				y = b->data + b->columns * k + j;
+				for (m = 0; m < n; m++)
+					s[m] += (int32_t)x[k] * y[m];
 			}
-		}
 
-		return 0;
+			for (m = 0; m < n; m++)
+				z[j + m] = (int16_t)mat_shift_rnd(s[m], shift_minus_one);
+		}
 	}
 
+	return 0;
+}
+
+int mat_multiply_32x16b(struct mat_matrix_32b *a, struct mat_matrix_16b *b,
+			struct mat_matrix_32b *c)
+{
+	int64_t s[MAT_BLOCK_COLUMNS];
+	int32_t *x;
+	int16_t *y;
+	int32_t *z;
+	int i, j, k, m, n;
+	const int shift_minus_one = a->fractions + b->fractions - c->fractions - 1;
+
+	if (a->columns != b->rows || a->rows != c->rows || b->columns != c->columns)
+		return -EINVAL;
+
 	for (i = 0; i < a->rows; i++) {
-		for (j = 0; j < b->columns; j++) {
-			s = 0;
-			x = a->data + a->columns * i;
-			y = b->data + j;
-			for (k = 0; k < b->rows; k++) {
-				s += (int32_t)(*x) * (*y);
-				x++;
-				y += y_inc;
+		x = a->data + a->columns * i;
+		z = c->data + c->columns * i;
+		for (j = 0; j < b->columns; j += MAT_BLOCK_COLUMNS) {
+			n = MIN(MAT_BLOCK_COLUMNS, b->columns - j);
+			for (m = 0; m < n; m++)
+				s[m] = 0;
+
+			for (k = 0; k < a->columns; k++) {
+				if (!x[k])
+					continue;
+
+				y = b->data + b->columns * k + j;
+				for (m = 0; m < n; m++)
+					s[m] += (int64_t)x[k] * y[m];
 			}
-			*z = (int16_t)(((s >> shift_minus_one) + 1) >> 1); /*Shift to Qx.y */
-			z++;
+
+			for (m = 0; m < n; m++)
+				z[j + m] = (int32_t)mat_shift_rnd(s[m], shift_minus_one);
 		}
 	}
+
+	return 0;
+}
+
+/* Finds the run of rows that contains the non-zero values of a column */
+static int mat_band_column_16b(struct mat_matrix_16b *mat, int col, int *first)
+{
+	int last = -1;
+	int i;
+
+	*first = 0;
+	for (i = 0; i < mat->rows; i++) {
+		if (!mat_get_scalar_16b(mat, i, col))
+			continue;
+
+		if (last < 0)
+			*first = i;
+
+		last = i;
+	}
+
+	return last < 0 ? 0 : last - *first + 1;
+}
+
+int mat_band_length_16b(struct mat_matrix_16b *mat)
+{
+	int length = 0;
+	int first;
+	int j;
+
+	for (j = 0; j < mat->columns; j++)
+		length += MAT_BAND_HEADER_LENGTH + mat_band_column_16b(mat, j, &first);
+
+	/* The column data indices are stored as int16_t */
+	if (length > INT16_MAX)
+		return -EINVAL;
+
+	return length;
+}
+
+int mat_band_from_matrix_16b(struct mat_band_16b *band, int length, struct mat_matrix_16b *mat)
+{
+	int16_t *coef;
+	int first;
+	int idx = 0;
+	int i, j, n;
+
+	for (j = 0; j < mat->columns; j++) {
+		n = mat_band_column_16b(mat, j, &first);
+		if (idx + MAT_BAND_HEADER_LENGTH + n > MIN(length, INT16_MAX))
+			return -EINVAL;
+
+		coef = &band->data[idx + MAT_BAND_HEADER_LENGTH];
+		for (i = 0; i < n; i++)
+			coef[i] = mat_get_scalar_16b(mat, first + i, j);
+
+		band->data[idx + 1] = first;
+		band->data[idx + 2] = n;
+		band->data[idx] = idx + MAT_BAND_HEADER_LENGTH + n; /* index to next */
+		idx = band->data[idx];
+	}
+
+	band->rows = mat->rows;
+	band->columns = mat->columns;
+	band->fractions = mat->fractions;
+	band->length = idx;
+	return 0;
+}
+
+int mat_multiply_band_16b(struct mat_matrix_16b *a, struct mat_band_16b *b,
+			  struct mat_matrix_16b *c)
+{
+	int64_t s;
+	int16_t *x;
+	int16_t *coef;
+	int i, j, k;
+	int first, n;
+	int idx = 0;
+	const int shift_minus_one = a->fractions + b->fractions - c->fractions - 1;
+
+	if (a->columns != b->rows || a->rows != c->rows || b->columns != c->columns)
+		return -EINVAL;
+
+	for (j = 0; j < b->columns; j++) {
+		first = b->data[idx + 1];
+		n = b->data[idx + 2];
+		coef = &b->data[idx + MAT_BAND_HEADER_LENGTH];
+		idx = b->data[idx];
+		for (i = 0; i < a->rows; i++) {
+			x = a->data + a->columns * i + first;
+			s = 0;
+			for (k = 0; k < n; k++)
+				s += (int32_t)x[k] * coef[k];
+
+			c->data[c->columns * i + j] = (int16_t)mat_shift_rnd(s, shift_minus_one);
+		}
+	}
+
+	return 0;
+}
+
+int mat_multiply_band_32x16b(struct mat_matrix_32b *a, struct mat_band_16b *b,
+			     struct mat_matrix_32b *c)
+{
+	int64_t s;
+	int32_t *x;
+	int16_t *coef;
+	int i, j, k;
+	int first, n;
+	int idx = 0;
+	const int shift_minus_one = a->fractions + b->fractions - c->fractions - 1;
+
+	if (a->columns != b->rows || a->rows != c->rows || b->columns != c->columns)
+		return -EINVAL;
+
+	for (j = 0; j < b->columns; j++) {
+		first = b->data[idx + 1];
+		n = b->data[idx + 2];
+		coef = &b->data[idx + MAT_BAND_HEADER_LENGTH];
+		idx = b->data[idx];
+		for (i = 0; i < a->rows; i++) {
+			x = a->data + a->columns * i + first;
+			s = 0;
+			for (k = 0; k < n; k++)
+				s += (int64_t)x[k] * coef[k];
+
+			c->data[c->columns * i + j] = (int32_t)mat_shift_rnd(s, shift_minus_one);
+		}
+	}
+
 	return 0;
 }
 
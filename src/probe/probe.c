@@ -21,6 +21,7 @@
 #include <sof/schedule/ll_schedule.h>
 #include <sof/schedule/schedule.h>
 #include <rtos/task.h>
+#include <rtos/spinlock.h>
 #include <rtos/string_macro.h>
 #if CONFIG_IPC_MAJOR_4
 #include <sof/audio/module_adapter/module/generic.h>
@@ -52,6 +53,7 @@ LOG_MODULE_REGISTER(probe, CONFIG_SOF_LOG_LEVEL);
 
 #define PROBE_BUFFER_LOCAL_SIZE	8192
 #define DMA_ELEM_SIZE		32
+#define PROBE_REDUCE_SIZE	2048
 
 /**
  * DMA buffer
@@ -76,6 +78,30 @@ struct probe_dma_ext {
 	struct dma_copy dc;		/**< DMA copy */
 };
 
+#if CONFIG_PROBE_EXTRACT_REDUCE
+/**
+ * Extraction options of a probe point
+ */
+struct probe_reduce {
+	uint32_t options;	/**< PROBE_MASK_EXT_xxx options, 0 for raw data */
+	uint32_t skip;		/**< frames to skip before the next extracted one */
+};
+#endif
+
+#if CONFIG_PROBE_EXTRACT_DEFERRED
+/**
+ * Extraction deferred to the probe task
+ */
+struct probe_deferred {
+	struct comp_buffer *buffer;	/**< probed buffer */
+	void *begin;			/**< transaction start address */
+	uint32_t amount;		/**< transaction size */
+	uint32_t point;			/**< probe point index, invalid once removed */
+	uint64_t end;			/**< bytes produced to the buffer after it */
+	uint64_t timestamp;		/**< transaction time */
+};
+#endif
+
 /**
  * Probe main struct
  */
@@ -85,6 +111,18 @@ struct probe_pdata {
 	struct probe_point probe_points[CONFIG_PROBE_POINTS_MAX]; /**< probe points */
 	struct probe_data_packet header;			  /**< data packet header */
 	struct task dmap_work;					  /**< probe task */
+#if CONFIG_PROBE_EXTRACT_REDUCE
+	struct probe_reduce reduce[CONFIG_PROBE_POINTS_MAX];	  /**< extraction options */
+	uint8_t reduce_data[PROBE_REDUCE_SIZE];			  /**< reduced packet data */
+#endif
+#if CONFIG_PROBE_EXTRACT_DEFERRED
+	struct probe_deferred deferred[CONFIG_PROBE_DEFERRED_MAX]; /**< pending extractions */
+	uint32_t deferred_first;				  /**< oldest pending one */
+	uint32_t deferred_count;				  /**< pending extractions */
+	uint64_t produced[CONFIG_PROBE_POINTS_MAX];		  /**< bytes per probe point */
+	uint32_t lost[CONFIG_PROBE_POINTS_MAX];			  /**< bytes not extracted */
+	struct k_spinlock lock;					  /**< pending extractions lock */
+#endif
 };
 
 /**
@@ -287,12 +325,19 @@ static int probe_dma_deinit(struct probe_dma_ext *dma)
  * Copy extraction probes data to host if available.
  * Return err if dma copy failed.
  */
+#if CONFIG_PROBE_EXTRACT_DEFERRED
+static void probe_deferred_copy(struct probe_pdata *_probe);
+#endif
+
 static enum task_state probe_task(void *data)
 {
 	struct probe_pdata *_probe = probe_get();
 	uint32_t copy_align, avail;
 	int err;
 
+#if CONFIG_PROBE_EXTRACT_DEFERRED
+	probe_deferred_copy(_probe);
+#endif
 	if (!_probe->ext_dma.dmapb.avail)
 		return SOF_TASK_STATE_RESCHEDULE;
 #if CONFIG_ZEPHYR_NATIVE_DRIVERS
@@ -396,6 +441,10 @@ int probe_init(const struct probe_dma *probe_dma)
 	for (i = 0; i < CONFIG_PROBE_POINTS_MAX; i++)
 		_probe->probe_points[i].stream_tag = PROBE_POINT_INVALID;
 
+#if CONFIG_PROBE_EXTRACT_DEFERRED
+	k_spinlock_init(&_probe->lock);
+#endif
+
 	/* setup extraction dma if requested */
 	if (probe_dma) {
 		tr_dbg(&pr_tr, "\tstream_tag = %u, dma_buffer_size = %u",
@@ -720,18 +769,18 @@ static int copy_from_pbuffer(struct probe_dma_buf *pbuf, void *data,
  * \param[in] buffer_id component buffer id
  * \param[in] size data size.
  * \param[in] format audio format.
+ * \param[in] timestamp time the data was produced.
  * \param[out] checksum.
  * \return 0 on success, error code otherwise.
  */
 static int probe_gen_header(uint32_t buffer_id, uint32_t size,
-			    uint32_t format, uint64_t *checksum)
+			    uint32_t format, uint64_t timestamp,
+			    uint64_t *checksum)
 {
 	struct probe_pdata *_probe = probe_get();
 	struct probe_data_packet *header;
-	uint64_t timestamp;
 
 	header = &_probe->header;
-	timestamp = sof_cycle_get_64();
 
 	header->sync_word = PROBE_EXTRACT_SYNC_WORD;
 	header->buffer_id = buffer_id;
@@ -866,6 +915,386 @@ static void kick_probe_task(struct probe_pdata *_probe)
 		reschedule_task(&_probe->dmap_work, 0);
 }
 
+#if CONFIG_PROBE_EXTRACT_REDUCE
+/**
+ * \brief Check if the samples of a stream can be reduced, only 16 and 32-bit
+ *	  containers are handled, S24_3LE is extracted as it is.
+ * \param[in] stream probed stream.
+ * \return true if reduction options can be applied.
+ */
+static inline bool probe_reduce_supported(const struct audio_stream *stream)
+{
+	uint32_t sample_bytes = audio_stream_sample_bytes(stream);
+
+	return sample_bytes == sizeof(int16_t) || sample_bytes == sizeof(int32_t);
+}
+
+/**
+ * \brief Read a sample of the probed buffer.
+ * \param[in] ptr sample pointer.
+ * \param[in] sample_bytes container size of the sample.
+ * \param[in] truncate keep the 16 most significant valid bits of a 32-bit
+ *		       sample, above an unused byte for S24_4LE.
+ * \param[in] unused_bits number of unused most significant bits.
+ * \return sample, 16-bit samples sign extended.
+ */
+static inline uint32_t probe_reduce_read(const void *ptr, uint32_t sample_bytes,
+					 bool truncate, uint32_t unused_bits)
+{
+	if (sample_bytes == sizeof(int16_t))
+		return *(const int16_t *)ptr;
+
+	if (truncate)
+		return (int32_t)(*(const uint32_t *)ptr << unused_bits) >> 16;
+
+	return *(const uint32_t *)ptr;
+}
+
+/**
+ * \brief Delta pack a sample as described by PROBE_MASK_PACKING.
+ * \param[out] out packed data pointer.
+ * \param[in] delta difference to the previous sample of the channel.
+ * \return packed data pointer after the sample.
+ */
+static inline uint8_t *probe_reduce_pack(uint8_t *out, uint32_t delta)
+{
+	uint32_t zigzag = (delta << 1) ^ (uint32_t)((int32_t)delta >> 31);
+
+	while (zigzag >= 0x80) {
+		*out++ = zigzag | 0x80;
+		zigzag >>= 7;
+	}
+	*out++ = zigzag;
+
+	return out;
+}
+
+/**
+ * \brief Send reduced data as a packet of the extraction stream.
+ * \param[in] buffer_id component buffer id.
+ * \param[in] format audio format.
+ * \param[in] size reduced data size.
+ * \param[in] timestamp time the data was produced.
+ * \return 0 on success, error code otherwise.
+ */
+static int probe_reduce_send(uint32_t buffer_id, uint32_t format, uint32_t size,
+			     uint64_t timestamp)
+{
+	struct probe_pdata *_probe = probe_get();
+	uint64_t checksum;
+	int ret;
+
+	ret = probe_gen_header(buffer_id, size, format, timestamp, &checksum);
+	if (ret < 0)
+		return ret;
+
+	ret = copy_to_pbuffer(&_probe->ext_dma.dmapb, _probe->reduce_data, size);
+	if (ret < 0)
+		return ret;
+
+	return copy_to_pbuffer(&_probe->ext_dma.dmapb, &checksum, sizeof(checksum));
+}
+
+/**
+ * \brief Extract a transaction with the options of the probe point: every
+ *	  frame but one of the decimation factor is skipped, the selected
+ *	  channels are truncated and packed if asked. Packets are sent each
+ *	  time the reduced data buffer could not hold another frame, the
+ *	  delta packing starts over in each of them.
+ * \param[in] point probe point index.
+ * \param[in] buffer probed buffer.
+ * \param[in] cb_data produced transaction.
+ * \param[in] timestamp time the data was produced.
+ * \return 0 on success, error code otherwise.
+ */
+static int probe_reduce_extract(uint32_t point, struct comp_buffer *buffer,
+				struct buffer_cb_transact *cb_data, uint64_t timestamp)
+{
+	struct probe_pdata *_probe = probe_get();
+	struct probe_reduce *reduce = &_probe->reduce[point];
+	struct audio_stream *stream = &buffer->stream;
+	uint32_t buffer_id = _probe->probe_points[point].buffer_id.full_id;
+	uint32_t frame_fmt = audio_stream_get_frm_fmt(stream);
+	uint32_t channels = audio_stream_get_channels(stream);
+	uint32_t sample_bytes = audio_stream_sample_bytes(stream);
+	uint32_t frame_bytes = audio_stream_frame_bytes(stream);
+	uint32_t frames = cb_data->transaction_amount / frame_bytes;
+	uint32_t decimation = ((reduce->options & PROBE_MASK_EXT_DECIMATION) >>
+			       PROBE_SHIFT_EXT_DECIMATION) + 1;
+	uint32_t ch_mask = (reduce->options & PROBE_MASK_EXT_CHANNELS) >>
+			   PROBE_SHIFT_EXT_CHANNELS;
+	bool pack = reduce->options & PROBE_MASK_EXT_PACKING;
+	bool truncate = (reduce->options & PROBE_MASK_EXT_TRUNCATE) &&
+			sample_bytes == sizeof(int32_t) && frame_fmt != SOF_IPC_FRAME_FLOAT;
+	uint32_t unused_bits = frame_fmt == SOF_IPC_FRAME_S24_4LE ? 8 : 0;
+	uint32_t prev[PLATFORM_MAX_CHANNELS];
+	uint8_t *start = _probe->reduce_data;
+	uint8_t *out = start;
+	uint8_t *ptr = cb_data->transaction_begin_address;
+	uint32_t frame_max;
+	uint32_t format;
+	uint32_t sample;
+	uint32_t ch, k;
+	uint32_t i;
+	int ret;
+
+	if (channels > PLATFORM_MAX_CHANNELS)
+		return -EINVAL;
+
+	/* no channel of the mask in the stream extracts all of them */
+	ch_mask &= MASK(channels - 1, 0);
+	if (!ch_mask)
+		ch_mask = MASK(channels - 1, 0);
+
+	format = probe_gen_format(truncate ? SOF_IPC_FRAME_S16_LE : frame_fmt,
+				  audio_stream_get_rate(stream), popcount(ch_mask));
+	format |= ((decimation - 1) << PROBE_SHIFT_DECIMATION) & PROBE_MASK_DECIMATION;
+	if (pack)
+		format |= PROBE_MASK_PACKING;
+
+	frame_max = popcount(ch_mask) * (pack ? PROBE_PACKED_SAMPLE_MAX :
+					 truncate ? sizeof(int16_t) : sample_bytes);
+	if (frame_max > PROBE_REDUCE_SIZE)
+		return -EINVAL;
+
+	for (i = 0; i < frames; i++) {
+		if (reduce->skip) {
+			reduce->skip--;
+			ptr = audio_stream_wrap(stream, ptr + frame_bytes);
+			continue;
+		}
+		reduce->skip = decimation - 1;
+
+		if (out == start)
+			memset(prev, 0, sizeof(prev));
+
+		for (ch = 0, k = 0; ch < channels; ch++) {
+			if (ch_mask & BIT(ch)) {
+				sample = probe_reduce_read(ptr, sample_bytes, truncate,
+							   unused_bits);
+				if (pack) {
+					out = probe_reduce_pack(out, sample - prev[k]);
+					prev[k++] = sample;
+				} else if (truncate || sample_bytes == sizeof(int16_t)) {
+					*(int16_t *)out = sample;
+					out += sizeof(int16_t);
+				} else {
+					*(uint32_t *)out = sample;
+					out += sizeof(uint32_t);
+				}
+			}
+			ptr = audio_stream_wrap(stream, ptr + sample_bytes);
+		}
+
+		if (out - start > PROBE_REDUCE_SIZE - frame_max) {
+			ret = probe_reduce_send(buffer_id, format, out - start, timestamp);
+			if (ret < 0)
+				return ret;
+			out = start;
+		}
+	}
+
+	if (out == start)
+		return 0;
+
+	return probe_reduce_send(buffer_id, format, out - start, timestamp);
+}
+#endif
+
+/**
+ * \brief Generate format, header and copy a produced transaction of an
+ *	  extraction probe point to probe buffer.
+ * \param[in] point probe point index.
+ * \param[in] buffer probed buffer.
+ * \param[in] cb_data produced transaction.
+ * \param[in] timestamp time the data was produced.
+ * \return 0 on success, error code otherwise.
+ */
+static int probe_extract(uint32_t point, struct comp_buffer *buffer,
+			 struct buffer_cb_transact *cb_data, uint64_t timestamp)
+{
+	struct probe_pdata *_probe = probe_get();
+	uint32_t buffer_id = _probe->probe_points[point].buffer_id.full_id;
+	uint32_t head, tail;
+	uint32_t format;
+	uint64_t checksum;
+	int ret;
+
+#if CONFIG_PROBE_EXTRACT_REDUCE
+	/* a stream format set after the probe point was added may not be reducible */
+	if (_probe->reduce[point].options && probe_reduce_supported(&buffer->stream))
+		return probe_reduce_extract(point, buffer, cb_data, timestamp);
+#endif
+	format = probe_gen_format(audio_stream_get_frm_fmt(&buffer->stream),
+				  audio_stream_get_rate(&buffer->stream),
+				  audio_stream_get_channels(&buffer->stream));
+	ret = probe_gen_header(buffer_id,
+			       cb_data->transaction_amount,
+			       format, timestamp, &checksum);
+	if (ret < 0)
+		return ret;
+
+	/* check if transaction amount exceeds component buffer end addr */
+	/* if yes: divide copying into two stages, head and tail */
+	if ((char *)cb_data->transaction_begin_address + cb_data->transaction_amount >
+	    (char *)audio_stream_get_end_addr(&buffer->stream)) {
+		head = (uintptr_t)audio_stream_get_end_addr(&buffer->stream) -
+		       (uintptr_t)cb_data->transaction_begin_address;
+		tail = (uintptr_t)cb_data->transaction_amount - head;
+		ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
+				      cb_data->transaction_begin_address,
+				      head);
+		if (ret < 0)
+			return ret;
+
+		ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
+				      audio_stream_get_addr(&buffer->stream), tail);
+		if (ret < 0)
+			return ret;
+	} else {
+		ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
+				      cb_data->transaction_begin_address,
+				      cb_data->transaction_amount);
+		if (ret < 0)
+			return ret;
+	}
+
+	return copy_to_pbuffer(&_probe->ext_dma.dmapb,
+			       &checksum, sizeof(checksum));
+}
+
+#if CONFIG_PROBE_EXTRACT_DEFERRED
+/**
+ * \brief Record a produced transaction of an extraction probe point, the
+ *	  probe task copies it later. Nothing is copied here, so the probe
+ *	  costs the pipeline task only this bookkeeping.
+ * \param[in] point probe point index.
+ * \param[in] buffer probed buffer.
+ * \param[in] cb_data produced transaction.
+ */
+static void probe_defer(uint32_t point, struct comp_buffer *buffer,
+			struct buffer_cb_transact *cb_data)
+{
+	struct probe_pdata *_probe = probe_get();
+	struct probe_deferred *deferred;
+	k_spinlock_key_t key;
+	uint32_t pending;
+
+	key = k_spin_lock(&_probe->lock);
+
+	_probe->produced[point] += cb_data->transaction_amount;
+
+	pending = _probe->deferred_count;
+	if (pending == CONFIG_PROBE_DEFERRED_MAX) {
+		_probe->lost[point] += cb_data->transaction_amount;
+	} else {
+		deferred = &_probe->deferred[(_probe->deferred_first + pending) %
+					     CONFIG_PROBE_DEFERRED_MAX];
+		deferred->buffer = buffer;
+		deferred->begin = cb_data->transaction_begin_address;
+		deferred->amount = cb_data->transaction_amount;
+		deferred->point = point;
+		deferred->end = _probe->produced[point];
+		deferred->timestamp = sof_cycle_get_64();
+		_probe->deferred_count = ++pending;
+	}
+
+	k_spin_unlock(&_probe->lock, key);
+
+	/* same as kick_probe_task(), when 75% of the records are used */
+	if (pending > CONFIG_PROBE_DEFERRED_MAX - (CONFIG_PROBE_DEFERRED_MAX >> 2))
+		reschedule_task(&_probe->dmap_work, 0);
+}
+
+/**
+ * \brief Copy the recorded transactions to probe buffer, in the order they
+ *	  were produced. A transaction the producer has wrapped over since
+ *	  or that doesn't fit in probe buffer is counted as lost and the
+ *	  losses are reported per probe point.
+ * \param[in] _probe probes.
+ */
+static void probe_deferred_copy(struct probe_pdata *_probe)
+{
+	struct probe_deferred deferred;
+	struct buffer_cb_transact cb_data;
+	k_spinlock_key_t key;
+	bool overwritten;
+	uint32_t lost;
+	uint32_t i;
+
+	for (;;) {
+		key = k_spin_lock(&_probe->lock);
+		if (!_probe->deferred_count) {
+			k_spin_unlock(&_probe->lock, key);
+			break;
+		}
+
+		deferred = _probe->deferred[_probe->deferred_first];
+		_probe->deferred_first = (_probe->deferred_first + 1) % CONFIG_PROBE_DEFERRED_MAX;
+		_probe->deferred_count--;
+
+		/* removed probe point, its buffer may be gone too */
+		if (deferred.point == PROBE_POINT_INVALID) {
+			k_spin_unlock(&_probe->lock, key);
+			continue;
+		}
+
+		overwritten = _probe->produced[deferred.point] - deferred.end + deferred.amount >
+			      audio_stream_get_size(&deferred.buffer->stream);
+		k_spin_unlock(&_probe->lock, key);
+
+		if (!overwritten) {
+			cb_data.buffer = deferred.buffer;
+			cb_data.transaction_begin_address = deferred.begin;
+			cb_data.transaction_amount = deferred.amount;
+
+			if (probe_extract(deferred.point, deferred.buffer, &cb_data,
+					  deferred.timestamp) >= 0)
+				continue;
+		}
+
+		key = k_spin_lock(&_probe->lock);
+		_probe->lost[deferred.point] += deferred.amount;
+		k_spin_unlock(&_probe->lock, key);
+	}
+
+	for (i = 0; i < CONFIG_PROBE_POINTS_MAX; i++) {
+		if (!_probe->lost[i])
+			continue;
+
+		key = k_spin_lock(&_probe->lock);
+		lost = _probe->lost[i];
+		_probe->lost[i] = 0;
+		k_spin_unlock(&_probe->lock, key);
+
+		tr_warn(&pr_tr, "probe_task(): %u bytes of buffer %u lost", lost,
+			_probe->probe_points[i].buffer_id.full_id);
+	}
+}
+
+/**
+ * \brief Forget the recorded transactions of a removed probe point.
+ * \param[in] _probe probes.
+ * \param[in] point probe point index.
+ */
+static void probe_deferred_remove(struct probe_pdata *_probe, uint32_t point)
+{
+	k_spinlock_key_t key;
+	uint32_t i;
+
+	key = k_spin_lock(&_probe->lock);
+
+	for (i = 0; i < CONFIG_PROBE_DEFERRED_MAX; i++)
+		if (_probe->deferred[i].point == point)
+			_probe->deferred[i].point = PROBE_POINT_INVALID;
+
+	_probe->produced[point] = 0;
+	_probe->lost[point] = 0;
+
+	k_spin_unlock(&_probe->lock, key);
+}
+#endif
+
 #if CONFIG_LOG_BACKEND_SOF_PROBE
 static ssize_t probe_logging_hook(uint8_t *buffer, size_t length)
 {
@@ -877,7 +1306,8 @@ static ssize_t probe_logging_hook(uint8_t *buffer, size_t length)
 	max_len = _probe->ext_dma.dmapb.avail - sizeof(struct probe_data_packet) - sizeof(checksum);
 	length = MIN(max_len, length);
 
-	ret = probe_gen_header(PROBE_LOGGING_BUFFER_ID, length, 0, &checksum);
+	ret = probe_gen_header(PROBE_LOGGING_BUFFER_ID, length, 0, sof_cycle_get_64(),
+			       &checksum);
 	if (ret < 0)
 		return ret;
 
@@ -899,7 +1329,8 @@ static ssize_t probe_logging_hook(uint8_t *buffer, size_t length)
 /**
  * \brief General extraction probe callback, called from buffer produce.
  *	  It will search for probe point connected to this buffer.
- *	  Extraction probe: generate format, header and copy data to probe buffer.
+ *	  Extraction probe: generate format, header and copy data to probe buffer,
+ *	  or with CONFIG_PROBE_EXTRACT_DEFERRED leave that to the probe task.
  *	  Injection probe: find corresponding DMA, check avail data, copy data,
  *	  update pointers and request more data from host if needed.
  * \param[in] arg pointer (not used).
@@ -918,8 +1349,6 @@ static void probe_cb_produce(void *arg, enum notify_id type, void *data)
 	int32_t copy_bytes = 0;
 	int ret;
 	uint32_t i, j;
-	uint32_t format;
-	uint64_t checksum;
 
 	buffer_id = *(int *)arg;
 
@@ -935,42 +1364,14 @@ static void probe_cb_produce(void *arg, enum notify_id type, void *data)
 	}
 
 	if (_probe->probe_points[i].purpose == PROBE_PURPOSE_EXTRACTION) {
-		format = probe_gen_format(audio_stream_get_frm_fmt(&buffer->stream),
-					  audio_stream_get_rate(&buffer->stream),
-					  audio_stream_get_channels(&buffer->stream));
-		ret = probe_gen_header(buffer_id,
-				       cb_data->transaction_amount,
-				       format, &checksum);
-		if (ret < 0)
-			goto err;
-
-		/* check if transaction amount exceeds component buffer end addr */
-		/* if yes: divide copying into two stages, head and tail */
-		if ((char *)cb_data->transaction_begin_address + cb_data->transaction_amount >
-		    (char *)audio_stream_get_end_addr(&buffer->stream)) {
-			head = (uintptr_t)audio_stream_get_end_addr(&buffer->stream) -
-			       (uintptr_t)cb_data->transaction_begin_address;
-			tail = (uintptr_t)cb_data->transaction_amount - head;
-			ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
-					      cb_data->transaction_begin_address,
-					      head);
-			if (ret < 0)
-				goto err;
-
-			ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
-					      audio_stream_get_addr(&buffer->stream), tail);
-			if (ret < 0)
-				goto err;
-		} else {
-			ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
-					      cb_data->transaction_begin_address,
-					      cb_data->transaction_amount);
-			if (ret < 0)
-				goto err;
+#if CONFIG_PROBE_EXTRACT_DEFERRED
+		/* the probe task copies on its own core only */
+		if (cpu_get_id() == _probe->dmap_work.core) {
+			probe_defer(i, buffer, cb_data);
+			return;
 		}
-
-		ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
-				      &checksum, sizeof(checksum));
+#endif
+		ret = probe_extract(i, buffer, cb_data, sof_cycle_get_64());
 		if (ret < 0)
 			goto err;
 
@@ -1154,6 +1555,9 @@ int probe_point_add(uint32_t count, const struct probe_point *probe)
 	struct ipc_comp_dev *dev = NULL;
 #if CONFIG_IPC_MAJOR_4
 	struct comp_buffer *buf = NULL;
+#endif
+#if CONFIG_PROBE_EXTRACT_REDUCE
+	struct audio_stream *stream;
 #endif
 	tr_dbg(&pr_tr, "probe_point_add() count = %u", count);
 
@@ -1166,27 +1570,38 @@ int probe_point_add(uint32_t count, const struct probe_point *probe)
 	/* add all probe points if they are corresponding to valid component and DMA */
 	for (i = 0; i < count; i++) {
 		const probe_point_id_t *buf_id = &probe[i].buffer_id;
+		uint32_t purpose = probe[i].purpose & PROBE_MASK_PURPOSE;
+		uint32_t options = probe[i].purpose & ~PROBE_MASK_PURPOSE;
 		uint32_t stream_tag;
 
 		tr_dbg(&pr_tr, "\tprobe[%u] buffer_id = %u, purpose = %u, stream_tag = %u",
 		       i, buf_id->full_id, probe[i].purpose,
 		       probe[i].stream_tag);
 
-		if (!verify_purpose(probe[i].purpose)) {
+		if (!verify_purpose(purpose)) {
 			tr_err(&pr_tr, "probe_point_add() error: invalid purpose %d",
-			       probe[i].purpose);
+			       purpose);
 
 			return -EINVAL;
 		}
 
 		if (_probe->ext_dma.stream_tag == PROBE_DMA_INVALID &&
-		    probe_purpose_needs_ext_dma(probe[i].purpose)) {
+		    probe_purpose_needs_ext_dma(purpose)) {
 			tr_err(&pr_tr, "probe_point_add(): extraction DMA not enabled.");
 			return -EINVAL;
 		}
 
 		fw_logs = enable_logs(&probe[i]);
 
+		/* only extraction of a buffer can be reduced */
+		if (options && (!IS_ENABLED(CONFIG_PROBE_EXTRACT_REDUCE) ||
+				purpose != PROBE_PURPOSE_EXTRACTION || fw_logs)) {
+			tr_err(&pr_tr, "probe_point_add(): invalid extraction options 0x%x",
+			       options);
+
+			return -EINVAL;
+		}
+
 		if (!fw_logs) {
 #if CONFIG_IPC_MAJOR_4
 			dev = ipc_get_comp_by_id(ipc_get(),
@@ -1218,6 +1633,19 @@ int probe_point_add(uint32_t count, const struct probe_point *probe)
 				return -EINVAL;
 			}
 #endif
+#if CONFIG_PROBE_EXTRACT_REDUCE
+#if CONFIG_IPC_MAJOR_4
+			stream = &buf->stream;
+#else
+			stream = &dev->cb->stream;
+#endif
+			if (options && !probe_reduce_supported(stream)) {
+				tr_err(&pr_tr, "probe_point_add(): buffer %u samples can't be reduced",
+				       buf_id->full_id);
+
+				return -EINVAL;
+			}
+#endif
 		}
 
 		first_free = CONFIG_PROBE_POINTS_MAX;
@@ -1234,11 +1662,9 @@ int probe_point_add(uint32_t count, const struct probe_point *probe)
 			/* and check if probe is already attached */
 			buffer_id = _probe->probe_points[j].buffer_id.full_id;
 			if (buffer_id == buf_id->full_id) {
-				if (_probe->probe_points[j].purpose ==
-				    probe[i].purpose) {
+				if (_probe->probe_points[j].purpose == purpose) {
 					tr_err(&pr_tr, "probe_point_add(): Probe already attached to buffer %u with purpose %u",
-					       buffer_id,
-					       probe[i].purpose);
+					       buffer_id, purpose);
 
 					return -EINVAL;
 				}
@@ -1253,7 +1679,7 @@ int probe_point_add(uint32_t count, const struct probe_point *probe)
 		}
 
 		/* if connecting injection probe, check for associated DMA */
-		if (probe[i].purpose == PROBE_PURPOSE_INJECTION) {
+		if (purpose == PROBE_PURPOSE_INJECTION) {
 			dma_found = 0;
 
 			for (j = 0; j < CONFIG_PROBE_DMA_MAX; j++) {
@@ -1302,8 +1728,12 @@ int probe_point_add(uint32_t count, const struct probe_point *probe)
 
 		/* probe point valid, save it */
 		_probe->probe_points[first_free].buffer_id = *buf_id;
-		_probe->probe_points[first_free].purpose = probe[i].purpose;
+		_probe->probe_points[first_free].purpose = purpose;
 		_probe->probe_points[first_free].stream_tag = stream_tag;
+#if CONFIG_PROBE_EXTRACT_REDUCE
+		_probe->reduce[first_free].options = options;
+		_probe->reduce[first_free].skip = 0;
+#endif
 
 		if (fw_logs) {
 #if CONFIG_LOG_BACKEND_SOF_PROBE
@@ -1458,6 +1888,9 @@ int probe_point_remove(uint32_t count, const uint32_t *buffer_id)
 					notifier_unregister(&buf_id->full_id, dev->cb,
 							    NOTIFIER_ID_BUFFER_FREE);
 				}
+#endif
+#if CONFIG_PROBE_EXTRACT_DEFERRED
+				probe_deferred_remove(_probe, j);
 #endif
 				_probe->probe_points[j].stream_tag =
 					PROBE_POINT_INVALID;
@@ -38,6 +38,10 @@ LOG_MODULE_DECLARE(ll_schedule, CONFIG_SOF_LOG_LEVEL);
 
 #define ZEPHYR_LL_STACK_SIZE	8192
 
+/* the LL watchdog has to be fed on every tick, so wake-ups can't be skipped */
+#define ZEPHYR_DOMAIN_MULTI_RATE \
+	(IS_ENABLED(CONFIG_SCHEDULE_LL_MULTI_RATE) && !IS_ENABLED(CONFIG_LL_WATCHDOG))
+
 K_KERNEL_STACK_ARRAY_DEFINE(ll_sched_stack, CONFIG_CORE_COUNT, ZEPHYR_LL_STACK_SIZE);
 
 struct zephyr_domain_thread {
@@ -45,6 +49,10 @@ struct zephyr_domain_thread {
 	struct k_sem sem;
 	void (*handler)(void *arg);
 	void *arg;
+#if ZEPHYR_DOMAIN_MULTI_RATE
+	uint32_t wake_period;	/* timer ticks between thread wake-ups */
+	uint32_t ticks;		/* timer ticks since the last wake-up */
+#endif
 };
 
 struct zephyr_domain {
@@ -121,7 +129,12 @@ static void zephyr_domain_thread_fn(void *p1, void *p2, void *p3)
 		diff = cycles1 - cycles0;
 
 		timer_fired = k_timer_status_get(&zephyr_domain->timer);
+#if ZEPHYR_DOMAIN_MULTI_RATE
+		/* the timer is expected to fire wake_period times per run */
+		if (timer_fired > dt->wake_period)
+#else
 		if (timer_fired > 1)
+#endif
 			overruns++;
 
 		cycles_sum += diff;
@@ -162,8 +175,17 @@ static void zephyr_domain_timer_fn(struct k_timer *timer)
 	for (core = 0; core < CONFIG_CORE_COUNT; core++) {
 		struct zephyr_domain_thread *dt = zephyr_domain->domain_thread + core;
 
-		if (dt->handler)
-			k_sem_give(&dt->sem);
+		if (!dt->handler)
+			continue;
+
+#if ZEPHYR_DOMAIN_MULTI_RATE
+		/* no task on this core is due before its wake period */
+		if (++dt->ticks < dt->wake_period)
+			continue;
+
+		dt->ticks = 0;
+#endif
+		k_sem_give(&dt->sem);
 	}
 }
 
@@ -186,6 +208,10 @@ static int zephyr_domain_register(struct ll_schedule_domain *domain,
 
 	dt->handler = handler;
 	dt->arg = arg;
+#if ZEPHYR_DOMAIN_MULTI_RATE
+	dt->wake_period = 1;
+	dt->ticks = 0;
+#endif
 
 	/* 10 is rather random, we better not accumulate 10 missed timer interrupts */
 	k_sem_init(&dt->sem, 0, 10);
@@ -290,6 +316,19 @@ static void zephyr_domain_unblock(struct ll_schedule_domain *domain)
 }
 #endif
 
+#if ZEPHYR_DOMAIN_MULTI_RATE
+static void zephyr_domain_set_wake_period(struct ll_schedule_domain *domain, int core,
+					  uint32_t ticks)
+{
+	struct zephyr_domain *zephyr_domain = ll_sch_domain_get_pdata(domain);
+
+	/* picked up by the timer callback on its next tick */
+	zephyr_domain->domain_thread[core].wake_period = ticks;
+
+	tr_dbg(&ll_tr, "core %d wake period %u ticks", core, ticks);
+}
+#endif
+
 static const struct ll_schedule_domain_ops zephyr_domain_ops = {
 	.domain_register	= zephyr_domain_register,
 	.domain_unregister	= zephyr_domain_unregister,
@@ -297,6 +336,9 @@ static const struct ll_schedule_domain_ops zephyr_domain_ops = {
 	.domain_block		= zephyr_domain_block,
 	.domain_unblock		= zephyr_domain_unblock,
 #endif
+#if ZEPHYR_DOMAIN_MULTI_RATE
+	.domain_set_wake_period	= zephyr_domain_set_wake_period,
+#endif
 };
 
 struct ll_schedule_domain *zephyr_domain_init(int clk)
@@ -288,10 +288,7 @@ void scheduler_dp_ll_tick(void *receiver_data, enum notify_id event_type, void *
 		if (curr_task->state == SOF_TASK_STATE_QUEUED) {
 			bool mod_ready;
 
-			mod_ready = module_is_ready_to_process(mod, mod->sources,
-							       mod->num_of_sources,
-							       mod->sinks,
-							       mod->num_of_sinks);
+			mod_ready = module_is_ready_to_process_batch(mod);
 			if (mod_ready) {
 				/* set a deadline for given num of ticks, starting now */
 				k_thread_deadline_set(pdata->thread_id,
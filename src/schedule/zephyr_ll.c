@@ -14,6 +14,7 @@
 #include <sof/schedule/schedule.h>
 #include <rtos/task.h>
 #include <sof/lib/perf_cnt.h>
+#include <sof/math/numbers.h>
 #include <zephyr/kernel.h>
 #include <ipc4/base_fw.h>
 #include <sof/debug/telemetry/telemetry.h>
@@ -30,6 +31,10 @@ struct zephyr_ll {
 	unsigned int n_tasks;			/* task counter */
 	struct ll_schedule_domain *ll_domain;	/* scheduling domain */
 	unsigned int core;			/* core ID of this instance */
+#if CONFIG_SCHEDULE_LL_MULTI_RATE
+	uint32_t tick;				/* ticks since the scheduler start */
+	uint32_t wake_period;			/* ticks between domain wake-ups */
+#endif
 };
 
 /* per-task scheduler data */
@@ -37,6 +42,9 @@ struct zephyr_ll_pdata {
 	bool run;
 	bool freeing;
 	struct k_sem sem;
+#if CONFIG_SCHEDULE_LL_MULTI_RATE
+	uint32_t period_ticks;			/* task runs every period_ticks ticks */
+#endif
 };
 
 static void zephyr_ll_lock(struct zephyr_ll *sch, uint32_t *flags)
@@ -54,6 +62,115 @@ static void zephyr_ll_assert_core(const struct zephyr_ll *sch)
 	assert(CONFIG_CORE_COUNT == 1 || sch->core == cpu_get_id());
 }
 
+#if CONFIG_SCHEDULE_LL_MULTI_RATE
+static uint32_t zephyr_ll_period_ticks(uint64_t period)
+{
+	/* periods, which aren't a multiple of the tick, run on every tick */
+	if (period < LL_TIMER_PERIOD_US || period % LL_TIMER_PERIOD_US)
+		return 1;
+
+	return period / LL_TIMER_PERIOD_US;
+}
+
+/*
+ * Tasks with the same period all run on the same tick, so that a long-period
+ * pipeline always sees full periods of data from 1ms pipelines sharing its
+ * buffers.
+ */
+static bool zephyr_ll_task_is_due(const struct zephyr_ll_pdata *pdata, uint32_t tick)
+{
+	return !(tick % pdata->period_ticks);
+}
+
+/*
+ * sch->tick holds the tick of the next wake-up and then advances by the wake
+ * period. Move it to a multiple of the new wake period, otherwise it could
+ * keep missing the multiples of a task period, e.g. ticks 1, 5, 9 with a wake
+ * period of 4 would never run a task with that period. The caller must hold
+ * the lock.
+ */
+static void zephyr_ll_set_wake_period(struct zephyr_ll *sch, uint32_t wake_period)
+{
+	uint32_t rem;
+
+	sch->wake_period = domain_set_wake_period(sch->ll_domain, wake_period);
+
+	rem = sch->tick % sch->wake_period;
+	if (rem)
+		sch->tick += sch->wake_period - rem;
+}
+
+/*
+ * The domain only has to wake us on ticks, on which at least one task can be
+ * due, that is every GCD of all task periods. Tasks, that are being run, are
+ * on a temporary list, so this should only be called with all tasks on
+ * sch->tasks. The caller must hold the lock.
+ */
+static void zephyr_ll_update_wake_period(struct zephyr_ll *sch)
+{
+	struct zephyr_ll_pdata *pdata;
+	struct list_item *list;
+	struct task *task;
+	uint32_t wake_period = 0;
+
+	list_for_item(list, &sch->tasks) {
+		task = container_of(list, struct task, list);
+		pdata = task->priv_data;
+		wake_period = gcd(wake_period, pdata->period_ticks);
+	}
+
+	if (!wake_period)
+		wake_period = 1;
+
+	if (wake_period != sch->wake_period)
+		zephyr_ll_set_wake_period(sch, wake_period);
+}
+
+/*
+ * Called when the last task is gone and the domain is about to be
+ * unregistered. The LL thread is aborted before it can update the wake period
+ * at the end of zephyr_ll_run() and zephyr_domain_register() restarts the
+ * domain with a wake period of 1, so start over from there. The caller must
+ * hold the lock.
+ */
+static void zephyr_ll_wake_period_reset(struct zephyr_ll *sch)
+{
+	sch->wake_period = 1;
+	sch->tick = 0;
+}
+
+/*
+ * A new task can only shorten the wake period, this is safe to call while the
+ * scheduler is running tasks. The caller must hold the lock.
+ */
+static void zephyr_ll_wake_period_add(struct zephyr_ll *sch,
+				      const struct zephyr_ll_pdata *pdata)
+{
+	uint32_t wake_period = gcd(sch->wake_period, pdata->period_ticks);
+
+	if (wake_period != sch->wake_period)
+		zephyr_ll_set_wake_period(sch, wake_period);
+}
+#else
+static inline bool zephyr_ll_task_is_due(const struct zephyr_ll_pdata *pdata, uint32_t tick)
+{
+	return true;
+}
+
+static inline void zephyr_ll_update_wake_period(struct zephyr_ll *sch)
+{
+}
+
+static inline void zephyr_ll_wake_period_reset(struct zephyr_ll *sch)
+{
+}
+
+static inline void zephyr_ll_wake_period_add(struct zephyr_ll *sch,
+					     const struct zephyr_ll_pdata *pdata)
+{
+}
+#endif
+
 /* Locking: caller should hold the domain lock */
 static void zephyr_ll_task_done(struct zephyr_ll *sch,
 				struct task *task)
@@ -80,6 +197,9 @@ static void zephyr_ll_task_done(struct zephyr_ll *sch,
 	tr_info(&ll_tr, "num_tasks %d total_num_tasks %ld",
 		sch->n_tasks, atomic_read(&sch->ll_domain->total_num_tasks));
 
+	if (sch->n_tasks == 1)
+		zephyr_ll_wake_period_reset(sch);
+
 	/*
 	 * If this is the last task, domain_unregister() won't return. It is
 	 * important to decrement the task counter last before aborting the
@@ -175,9 +295,16 @@ static void zephyr_ll_run(void *data)
 	struct task *task;
 	struct list_item *list, *tmp, task_head = LIST_INIT(task_head);
 	uint32_t flags;
+	uint32_t tick = 0;
 
 	zephyr_ll_lock(sch, &flags);
 
+#if CONFIG_SCHEDULE_LL_MULTI_RATE
+	/* the domain only wakes us every wake_period ticks */
+	tick = sch->tick;
+	sch->tick += sch->wake_period;
+#endif
+
 	/*
 	 * We drop the lock while executing tasks, at that time tasks can be
 	 * removed from or added to the list, including the task that was
@@ -199,6 +326,13 @@ static void zephyr_ll_run(void *data)
 			continue;
 		}
 
+		if (!zephyr_ll_task_is_due(pdata, tick)) {
+			/* not this tick, move on to the next task */
+			list_item_del(list);
+			list_item_append(list, &task_head);
+			continue;
+		}
+
 		pdata->run = true;
 		task->state = SOF_TASK_STATE_RUNNING;
 
@@ -246,6 +380,8 @@ static void zephyr_ll_run(void *data)
 		list_item_append(list, &sch->tasks);
 	}
 
+	zephyr_ll_update_wake_period(sch);
+
 	zephyr_ll_unlock(sch, &flags);
 
 	notifier_event(sch, NOTIFIER_ID_LL_POST_RUN,
@@ -269,9 +405,10 @@ static void schedule_ll_callback(void *data)
  * Called once for periodic tasks or multiple times for one-shot tasks
  * TODO: start should be ignored in Zephyr LL scheduler implementation. Tasks
  * are scheduled to start on the following tick and run on each subsequent timer
- * event. In the future we shall add support for long-period tasks with periods
- * equal to a multiple of the scheduler tick time. Ignoring start will eliminate
- * the use of task::start and ll_schedule_domain::next in this scheduler.
+ * event, or with CONFIG_SCHEDULE_LL_MULTI_RATE on each tick, that is a multiple
+ * of their period, when the period is a multiple of the scheduler tick time.
+ * Ignoring start will eliminate the use of task::start and
+ * ll_schedule_domain::next in this scheduler.
  */
 static int zephyr_ll_task_schedule_common(struct zephyr_ll *sch, struct task *task,
 					  uint64_t start, uint64_t period,
@@ -329,6 +466,10 @@ static int zephyr_ll_task_schedule_common(struct zephyr_ll *sch, struct task *ta
 		return 0;
 	}
 
+#if CONFIG_SCHEDULE_LL_MULTI_RATE
+	pdata->period_ticks = zephyr_ll_period_ticks(period);
+#endif
+
 	if (!reference)
 		zephyr_ll_task_insert_unlocked(sch, task);
 	else if (before)
@@ -338,6 +479,8 @@ static int zephyr_ll_task_schedule_common(struct zephyr_ll *sch, struct task *ta
 
 	sch->n_tasks++;
 
+	zephyr_ll_wake_period_add(sch, pdata);
+
 	zephyr_ll_unlock(sch, &flags);
 
 	ret = domain_register(sch->ll_domain, task, &schedule_ll_callback, sch);
@@ -540,6 +683,9 @@ int zephyr_ll_scheduler_init(struct ll_schedule_domain *domain)
 	sch->ll_domain = domain;
 	sch->core = cpu_get_id();
 	sch->n_tasks = 0;
+#if CONFIG_SCHEDULE_LL_MULTI_RATE
+	sch->wake_period = 1;
+#endif
 
 	scheduler_init(domain->type, &zephyr_ll_ops, sch);
 
@@ -6,6 +6,7 @@
 
 #include <sof/audio/buffer.h>
 #include <sof/common.h>
+#include <rtos/interrupt.h>
 #include <rtos/panic.h>
 #include <sof/ipc/msg.h>
 #include <rtos/alloc.h>
@@ -27,6 +28,7 @@
 #include <ipc/trace.h>
 #include <kernel/abi.h>
 #include <user/abi_dbg.h>
+#include <user/trace.h>
 #include <sof_versions.h>
 
 #ifdef __ZEPHYR__
@@ -49,12 +51,183 @@ static int dma_trace_get_avail_data(struct dma_trace_data *d,
 				    struct dma_trace_buf *buffer,
 				    int avail);
 
-/** Periodically runs and starts the DMA even when the buffer is not
- * full.
+#if CONFIG_TRACE_PER_CORE
+/* ring record length of the padding up to the ring end */
+#define DTRACE_CORE_PAD		0xffffffff
+
+/* merge and copy rounds of trace_work while a ring stays over 1/4 full */
+#define DTRACE_CORE_ROUNDS	4
+
+/* ring offsets are masked out of the free running read and write counters */
+STATIC_ASSERT(is_power_of_2(CONFIG_TRACE_CORE_BUFFER_SIZE),
+	      trace_core_buffer_size_not_power_of_2);
+
+static void dtrace_add_event(const char *e, uint32_t length);
+static int dtrace_calc_buf_overflow(struct dma_trace_buf *buffer,
+				    uint32_t length);
+
+/** Moves ring records to the DMA trace buffer, oldest timestamp first,
+ * until the rings are empty or the next record doesn't fit. Returns
+ * the highest fill level of a ring before the merge. The caller holds
+ * the trace lock, unless it is flushing in an emergency.
  */
-static enum task_state trace_work(void *data)
+static uint32_t dtrace_core_merge_unlocked(struct dma_trace_data *d)
+{
+	struct dma_trace_core_buf *ring;
+	struct dma_trace_core_buf *oldest;
+	const uint32_t mask = CONFIG_TRACE_CORE_BUFFER_SIZE - 1;
+	uint32_t oldest_length = 0;
+	uint64_t oldest_ts = 0;
+	uint64_t timestamp;
+	uint32_t max_fill = 0;
+	uint32_t length;
+	uint32_t offset;
+	uint32_t r;
+	int core;
+
+	for (core = 0; core < CONFIG_CORE_COUNT; core++) {
+		ring = &d->core_buf[core];
+		max_fill = MAX(max_fill, (uint32_t)(atomic_read(&ring->w) -
+						    atomic_read(&ring->r)));
+	}
+
+	for (;;) {
+		oldest = NULL;
+
+		for (core = 0; core < CONFIG_CORE_COUNT; core++) {
+			ring = &d->core_buf[core];
+			r = atomic_read(&ring->r);
+			if (r == (uint32_t)atomic_read(&ring->w))
+				continue;
+
+			offset = r & mask;
+			memcpy_s(&length, sizeof(length), ring->addr + offset, sizeof(length));
+			if (length == DTRACE_CORE_PAD) {
+				atomic_set(&ring->r, r + CONFIG_TRACE_CORE_BUFFER_SIZE - offset);
+				/* look at the same ring again */
+				core--;
+				continue;
+			}
+
+			timestamp = 0;
+			if (length >= sizeof(struct log_entry_header))
+				memcpy_s(&timestamp, sizeof(timestamp),
+					 ring->addr + offset + sizeof(length) +
+					 offsetof(struct log_entry_header, timestamp),
+					 sizeof(timestamp));
+
+			if (!oldest || timestamp < oldest_ts) {
+				oldest = ring;
+				oldest_ts = timestamp;
+				oldest_length = length;
+			}
+		}
+
+		if (!oldest || dtrace_calc_buf_overflow(&d->dmatb, oldest_length))
+			break;
+
+		r = atomic_read(&oldest->r);
+		dtrace_add_event(oldest->addr + (r & mask) + sizeof(uint32_t), oldest_length);
+		atomic_set(&oldest->r, r + ALIGN_UP(sizeof(uint32_t) + oldest_length,
+						    sizeof(uint32_t)));
+	}
+
+	return max_fill;
+}
+
+static uint32_t dtrace_core_merge(struct dma_trace_data *d)
+{
+	k_spinlock_key_t key;
+	uint32_t max_fill;
+
+	key = k_spin_lock(&d->lock);
+	max_fill = dtrace_core_merge_unlocked(d);
+	k_spin_unlock(&d->lock, key);
+
+	return max_fill;
+}
+
+/** Appends a record to the ring of the current core, the entry is
+ * dropped when there is no room. Only local interrupts are disabled,
+ * no other core is waited for. Returns the ring fill level.
+ */
+static uint32_t dtrace_core_add_event(struct dma_trace_data *d,
+				      const char *e, uint32_t length)
+{
+	struct dma_trace_core_buf *ring = &d->core_buf[cpu_get_id()];
+	uint32_t record = ALIGN_UP(sizeof(length) + length, sizeof(uint32_t));
+	uint32_t pad = 0;
+	uint32_t offset;
+	uint32_t flags;
+	uint32_t fill;
+	uint32_t w;
+	int ret;
+
+	irq_local_disable(flags);
+
+	/* dma_trace_buffer_free() waits for writers before freeing the rings */
+	atomic_add(&d->core_writers, 1);
+	if (!ring->addr) {
+		atomic_sub(&d->core_writers, 1);
+		irq_local_enable(flags);
+		return 0;
+	}
+
+	w = atomic_read(&ring->w);
+	fill = w - atomic_read(&ring->r);
+	offset = w & (CONFIG_TRACE_CORE_BUFFER_SIZE - 1);
+
+	/* records are contiguous, skip the end of the ring if needed */
+	if (offset + record > CONFIG_TRACE_CORE_BUFFER_SIZE)
+		pad = CONFIG_TRACE_CORE_BUFFER_SIZE - offset;
+
+	if (CONFIG_TRACE_CORE_BUFFER_SIZE - fill < pad + record) {
+		atomic_add(&ring->dropped, 1);
+		atomic_sub(&d->core_writers, 1);
+		irq_local_enable(flags);
+		return fill;
+	}
+
+	if (pad) {
+		*(uint32_t *)(ring->addr + offset) = DTRACE_CORE_PAD;
+		offset = 0;
+	}
+
+	*(uint32_t *)(ring->addr + offset) = length;
+	ret = memcpy_s(ring->addr + offset + sizeof(length),
+		       CONFIG_TRACE_CORE_BUFFER_SIZE - offset - sizeof(length), e, length);
+	assert(!ret);
+
+	/* publish the record to trace_work */
+	atomic_set(&ring->w, w + pad + record);
+
+	atomic_sub(&d->core_writers, 1);
+	irq_local_enable(flags);
+
+	return fill + pad + record;
+}
+
+/** Reports the entries each core dropped since the last report */
+static void dtrace_core_report_drops(struct dma_trace_data *d)
+{
+	int32_t dropped;
+	int core;
+
+	for (core = 0; core < CONFIG_CORE_COUNT; core++) {
+		dropped = atomic_read(&d->core_buf[core].dropped);
+		if (!dropped)
+			continue;
+
+		atomic_sub(&d->core_buf[core].dropped, dropped);
+		tr_warn(&dt_tr, "trace_work(): core %d number of dropped logs = %d",
+			core, dropped);
+	}
+}
+#endif
+
+/** Copies a chunk of the DMA trace buffer to the host */
+static int trace_copy(struct dma_trace_data *d)
 {
-	struct dma_trace_data *d = data;
 	struct dma_trace_buf *buffer = &d->dmatb;
 	struct dma_sg_config *config = &d->config;
 	k_spinlock_key_t key;
@@ -64,10 +237,10 @@ static enum task_state trace_work(void *data)
 
 	/* The host DMA channel is not available */
 	if (!d->dc.chan)
-		return SOF_TASK_STATE_RESCHEDULE;
+		return 0;
 
 	if (!ipc_trigger_trace_xfer(avail))
-		return SOF_TASK_STATE_RESCHEDULE;
+		return 0;
 
 	/* make sure we don't write more than buffer */
 	if (avail > DMA_TRACE_LOCAL_SIZE) {
@@ -84,7 +257,7 @@ static enum task_state trace_work(void *data)
 
 	/* any data to copy ? */
 	if (size == 0) {
-		return SOF_TASK_STATE_RESCHEDULE;
+		return 0;
 	}
 
 	d->posn.overflow = overflow;
@@ -128,6 +301,32 @@ out:
 
 	k_spin_unlock(&d->lock, key);
 
+	return size;
+}
+
+/** Periodically runs and starts the DMA even when the buffer is not
+ * full.
+ */
+static enum task_state trace_work(void *data)
+{
+	struct dma_trace_data *d = data;
+#if CONFIG_TRACE_PER_CORE
+	uint32_t fill;
+	int round = 0;
+
+	d->flush_request = 0;
+
+	/* more rounds while the rings fill up faster than a period drains */
+	do {
+		fill = dtrace_core_merge(d);
+	} while (trace_copy(d) > 0 && fill > CONFIG_TRACE_CORE_BUFFER_SIZE / 4 &&
+		 ++round < DTRACE_CORE_ROUNDS);
+
+	dtrace_core_report_drops(d);
+#else
+	trace_copy(d);
+#endif
+
 	/* reschedule the trace copying work */
 	return SOF_TASK_STATE_RESCHEDULE;
 }
@@ -238,12 +437,32 @@ static void dma_trace_buffer_free(struct dma_trace_data *d)
 {
 	struct dma_trace_buf *buffer = &d->dmatb;
 	k_spinlock_key_t key;
+#if CONFIG_TRACE_PER_CORE
+	char *core_buf;
+	int i;
+#endif
 
 	key = k_spin_lock(&d->lock);
 
 	rfree(buffer->addr);
 	memset(buffer, 0, sizeof(*buffer));
 
+#if CONFIG_TRACE_PER_CORE
+	/*
+	 * Other cores write their rings without the lock: unpublish the rings
+	 * and wait for the writers, that may have seen them, to finish.
+	 */
+	core_buf = d->core_buf[0].addr;
+	for (i = 0; i < CONFIG_CORE_COUNT; i++)
+		d->core_buf[i].addr = NULL;
+
+	while (atomic_read(&d->core_writers))
+		;
+
+	rfree(core_buf);
+	memset(d->core_buf, 0, sizeof(d->core_buf));
+#endif
+
 	k_spin_unlock(&d->lock, key);
 }
 
@@ -254,6 +473,10 @@ static int dma_trace_buffer_init(struct dma_trace_data *d)
 	k_spinlock_key_t key;
 	uint32_t addr_align;
 	int err;
+#if CONFIG_TRACE_PER_CORE
+	char *core_buf;
+	int i;
+#endif
 
 	/*
 	 * Keep the existing dtrace buffer to avoid memory leak, unlikely to
@@ -292,9 +515,29 @@ static int dma_trace_buffer_init(struct dma_trace_data *d)
 	bzero(buf, DMA_TRACE_LOCAL_SIZE);
 	dcache_writeback_region((__sparse_force void __sparse_cache *)buf, DMA_TRACE_LOCAL_SIZE);
 
+#if CONFIG_TRACE_PER_CORE
+	/* rings are shared by all cores, uncached */
+	core_buf = rzalloc(SOF_MEM_FLAG_USER | SOF_MEM_FLAG_COHERENT,
+			   CONFIG_CORE_COUNT * CONFIG_TRACE_CORE_BUFFER_SIZE);
+	if (!core_buf) {
+		mtrace_printf(LOG_LEVEL_ERROR, "dma_trace_buffer_init(): core alloc failed");
+		rfree(buf);
+		return -ENOMEM;
+	}
+#endif
+
 	/* initialise the DMA buffer, whole sequence in section */
 	key = k_spin_lock(&d->lock);
 
+#if CONFIG_TRACE_PER_CORE
+	for (i = 0; i < CONFIG_CORE_COUNT; i++) {
+		d->core_buf[i].addr = core_buf + i * CONFIG_TRACE_CORE_BUFFER_SIZE;
+		atomic_init(&d->core_buf[i].w, 0);
+		atomic_init(&d->core_buf[i].r, 0);
+		atomic_init(&d->core_buf[i].dropped, 0);
+	}
+#endif
+
 	buffer->addr  = buf;
 	buffer->size = DMA_TRACE_LOCAL_SIZE;
 	buffer->w_ptr = buffer->addr;
@@ -426,6 +669,11 @@ void dma_trace_flush(void *t)
 	if (!dma_trace_initialized(trace_data))
 		return;
 
+#if CONFIG_TRACE_PER_CORE
+	/* best effort, the lock may be held by whoever ran into the emergency */
+	dtrace_core_merge_unlocked(trace_data);
+#endif
+
 	buffer = &trace_data->dmatb;
 	avail = buffer->avail;
 
@@ -604,6 +852,26 @@ void dtrace_event(const char *e, uint32_t length)
 
 	buffer = &trace_data->dmatb;
 
+#if CONFIG_TRACE_PER_CORE
+	/* schedule copy now if the ring is half full, on primary core only */
+	if (dtrace_core_add_event(trace_data, e, length) < CONFIG_TRACE_CORE_BUFFER_SIZE / 2 &&
+	    !trace_data->flush_request)
+		return;
+
+	if (cpu_get_id() != PLATFORM_PRIMARY_CORE_ID) {
+		trace_data->flush_request = 1;
+		return;
+	}
+
+	if (trace_data->enabled && !trace_data->copy_in_progress) {
+		trace_data->flush_request = 0;
+		reschedule_task(&trace_data->dmat_work, DMA_TRACE_RESCHEDULE_TIME);
+		trace_data->copy_in_progress = 1;
+	}
+
+	return;
+#endif
+
 	key = k_spin_lock(&trace_data->lock);
 	dtrace_add_event(e, length);
 
@@ -640,5 +908,9 @@ void dtrace_event_atomic(const char *e, uint32_t length)
 		return;
 	}
 
+#if CONFIG_TRACE_PER_CORE
+	dtrace_core_add_event(trace_data, e, length);
+#else
 	dtrace_add_event(e, length);
+#endif
 }
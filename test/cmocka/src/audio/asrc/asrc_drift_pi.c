@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2026 Intel Corporation. All rights reserved.
+//
+
+#include <sof/audio/format.h>
+#include <sof/math/numbers.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmocka.h>
+
+#include "asrc/asrc.h"
+
+#define SKEW_ONE	Q_CONVERT_FLOAT(1.0, 30)
+#define SKEW_PPM	(SKEW_ONE / 1000000)
+
+/* blocks run for a step of the drift to settle within 2 % */
+#define SETTLE_BLOCKS	100
+
+static void test_drift_init(struct comp_data *cd, int32_t skew)
+{
+	memset(cd, 0, sizeof(*cd));
+	cd->skew = skew;
+}
+
+static void test_drift_update(struct comp_data *cd, int32_t measured)
+{
+	cd->skew = asrc_drift_pi(cd, measured);
+}
+
+static void test_step(int32_t target)
+{
+	struct comp_data cd;
+	int32_t step = target - SKEW_ONE;
+	int32_t prev_err = step;
+	int32_t err;
+	int overshoot = 0;
+	int i;
+
+	test_drift_init(&cd, SKEW_ONE);
+
+	for (i = 0; i < SETTLE_BLOCKS; i++) {
+		test_drift_update(&cd, target);
+		err = target - cd.skew;
+
+		/* the output only moves towards the target until it crosses it */
+		if ((int64_t)err * step > 0) {
+			assert_true(abs(err) < abs(prev_err));
+			assert_int_equal(overshoot, 0);
+		} else {
+			overshoot = MAX(overshoot, abs(err));
+		}
+
+		prev_err = err;
+	}
+
+	/* the integral part overshoots once by some 14 % of the step */
+	assert_true(overshoot > 0);
+	assert_true(overshoot < abs(step) / 5);
+	assert_true(abs(err) < abs(step) / 50);
+}
+
+static void test_asrc_drift_pi_step(void **state)
+{
+	struct comp_data cd;
+	int32_t step = 100 * SKEW_PPM;
+	int32_t first;
+
+	(void)state;
+
+	/* the first update moves by both gains */
+	test_drift_init(&cd, SKEW_ONE);
+	test_drift_update(&cd, SKEW_ONE + step);
+	first = Q_MULTSR_32X32((int64_t)step, ASRC_DRIFT_KP, 30, 30, 30) +
+		Q_MULTSR_32X32((int64_t)step, ASRC_DRIFT_KI, 30, 30, 30);
+	assert_int_equal(cd.skew, SKEW_ONE + first);
+
+	test_step(SKEW_ONE + step);
+	test_step(SKEW_ONE - step);
+	test_step(SKEW_ONE + 20 * SKEW_PPM);
+}
+
+static void test_asrc_drift_pi_converge(void **state)
+{
+	struct comp_data cd;
+	int32_t measured = SKEW_ONE + 100 * SKEW_PPM;
+	int i;
+
+	(void)state;
+
+	/* a constant drift is tracked without error */
+	test_drift_init(&cd, SKEW_ONE);
+	for (i = 0; i < 4 * SETTLE_BLOCKS; i++) {
+		test_drift_update(&cd, measured);
+		if (i >= 2 * SETTLE_BLOCKS)
+			assert_true(abs(measured - cd.skew) < SKEW_PPM);
+	}
+
+	/* so is a drift that keeps changing, e.g. with temperature */
+	test_drift_init(&cd, SKEW_ONE);
+	for (i = 0; i < 4 * SETTLE_BLOCKS; i++) {
+		measured = SKEW_ONE + 50 * SKEW_PPM + i * 5;
+		test_drift_update(&cd, measured);
+		if (i >= 2 * SETTLE_BLOCKS)
+			assert_true(abs(measured - cd.skew) < SKEW_PPM);
+	}
+}
+
+static void test_asrc_drift_pi_clamp(void **state)
+{
+	struct comp_data cd;
+	int32_t measured = Q_CONVERT_FLOAT(1.1, 30);
+	int32_t prev;
+	int i;
+
+	(void)state;
+
+	/*
+	 * A large step clamps the integral part, which limits the rate until
+	 * the output gets close to the target, and it still settles.
+	 */
+	test_drift_init(&cd, SKEW_ONE);
+	for (i = 0; i < 4 * SETTLE_BLOCKS; i++) {
+		prev = cd.skew;
+		test_drift_update(&cd, measured);
+
+		assert_true(cd.skew_integ <= ASRC_DRIFT_INTEG_MAX);
+		assert_true(cd.skew - prev <= Q_MULTSR_32X32((int64_t)(measured - prev),
+							     ASRC_DRIFT_KP, 30, 30, 30) +
+					      ASRC_DRIFT_INTEG_MAX);
+		if (i == SETTLE_BLOCKS / 4)
+			assert_int_equal(cd.skew_integ, ASRC_DRIFT_INTEG_MAX);
+	}
+	assert_true(abs(measured - cd.skew) < SKEW_PPM);
+
+	test_drift_init(&cd, measured);
+	for (i = 0; i < SETTLE_BLOCKS / 4; i++) {
+		test_drift_update(&cd, SKEW_ONE);
+		assert_true(cd.skew_integ >= -ASRC_DRIFT_INTEG_MAX);
+	}
+	assert_int_equal(cd.skew_integ, -ASRC_DRIFT_INTEG_MAX);
+
+	/* the skew saturates instead of wrapping */
+	test_drift_init(&cd, INT32_MAX - SKEW_PPM);
+	for (i = 0; i < SETTLE_BLOCKS; i++) {
+		test_drift_update(&cd, INT32_MAX);
+		assert_true(cd.skew >= INT32_MAX - SKEW_PPM);
+	}
+	assert_int_equal(cd.skew, INT32_MAX);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_asrc_drift_pi_step),
+		cmocka_unit_test(test_asrc_drift_pi_converge),
+		cmocka_unit_test(test_asrc_drift_pi_clamp),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
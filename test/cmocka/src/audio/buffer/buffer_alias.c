@@ -0,0 +1,295 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2026 Intel Corporation. All rights reserved.
+//
+
+#include <sof/audio/component.h>
+#include <sof/audio/buffer.h>
+#include <rtos/alloc.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmocka.h>
+
+#define TEST_BUFFER_SIZE	256
+#define TEST_PERIOD_BYTES	48	/* doesn't divide the size, periods wrap */
+#define TEST_PERIODS		20
+#define TEST_FREED_MAX		16
+
+static void *freed[TEST_FREED_MAX];
+static int num_freed;
+
+/* records what is freed, to tell which buffer released the stream memory */
+void rfree(void *ptr)
+{
+	if (ptr && num_freed < TEST_FREED_MAX)
+		freed[num_freed++] = ptr;
+
+	free(ptr);
+}
+
+static bool was_freed(void *ptr)
+{
+	int i;
+
+	for (i = 0; i < num_freed; i++)
+		if (freed[i] == ptr)
+			return true;
+
+	return false;
+}
+
+static struct comp_buffer *test_buffer(size_t size)
+{
+	struct comp_buffer *buffer = buffer_alloc(size, 0, 0, false);
+
+	assert_non_null(buffer);
+
+	return buffer;
+}
+
+static uint32_t test_chain_avail(struct comp_buffer **chain, int n)
+{
+	uint32_t avail = 0;
+	int i;
+
+	for (i = 0; i < n; i++)
+		avail += audio_stream_get_avail_bytes(&chain[i]->stream);
+
+	return avail;
+}
+
+/*
+ * Moves bytes from one stream of the chain to the next one in place, adding
+ * one to each of them like a processing module would.
+ */
+static void test_process(struct audio_stream *in, struct audio_stream *out, uint32_t bytes)
+{
+	uint8_t *x = audio_stream_get_rptr(in);
+	uint8_t *y = audio_stream_get_wptr(out);
+	uint32_t i;
+
+	assert_true(audio_stream_get_avail_bytes(in) >= bytes);
+	assert_true(audio_stream_get_free_bytes(out) >= bytes);
+	assert_ptr_equal(x, y);
+
+	for (i = 0; i < bytes; i++) {
+		*y = *x + 1;
+		x = audio_stream_wrap(in, x + 1);
+		y = audio_stream_wrap(out, y + 1);
+	}
+
+	audio_stream_consume(in, bytes);
+	audio_stream_produce(out, bytes);
+}
+
+static void test_buffer_alias_chain(void **state)
+{
+	struct comp_buffer *chain[3];
+	struct audio_stream *first, *last;
+	uint8_t *ptr;
+	uint8_t n = 0, expect = 2;
+	int period, i;
+
+	(void)state;
+
+	for (i = 0; i < ARRAY_SIZE(chain); i++)
+		chain[i] = test_buffer(TEST_BUFFER_SIZE);
+
+	assert_int_equal(buffer_alias(chain[0], chain[1]), 0);
+	assert_int_equal(buffer_alias(chain[1], chain[2]), 0);
+
+	first = &chain[0]->stream;
+	last = &chain[2]->stream;
+	assert_ptr_equal(audio_stream_get_addr(&chain[1]->stream), audio_stream_get_addr(first));
+	assert_ptr_equal(audio_stream_get_addr(last), audio_stream_get_addr(first));
+
+	/* nothing to write over yet behind the first stream */
+	assert_int_equal(audio_stream_get_free_bytes(first), TEST_BUFFER_SIZE);
+	assert_int_equal(audio_stream_get_free_bytes(&chain[1]->stream), 0);
+	assert_int_equal(audio_stream_get_free_bytes(last), 0);
+
+	for (period = 0; period < TEST_PERIODS; period++) {
+		assert_true(audio_stream_get_free_bytes(first) >= TEST_PERIOD_BYTES);
+		ptr = audio_stream_get_wptr(first);
+		for (i = 0; i < TEST_PERIOD_BYTES; i++) {
+			*ptr = n++;
+			ptr = audio_stream_wrap(first, ptr + 1);
+		}
+		audio_stream_produce(first, TEST_PERIOD_BYTES);
+
+		/* the first stream never gets free space over data of the chain */
+		assert_int_equal(audio_stream_get_free_bytes(first) +
+				 test_chain_avail(chain, ARRAY_SIZE(chain)), TEST_BUFFER_SIZE);
+
+		test_process(first, &chain[1]->stream, TEST_PERIOD_BYTES);
+		test_process(&chain[1]->stream, last, TEST_PERIOD_BYTES);
+
+		ptr = audio_stream_get_rptr(last);
+		for (i = 0; i < TEST_PERIOD_BYTES; i++) {
+			assert_int_equal(*ptr, expect++);
+			ptr = audio_stream_wrap(last, ptr + 1);
+		}
+		audio_stream_consume(last, TEST_PERIOD_BYTES);
+
+		assert_int_equal(audio_stream_get_free_bytes(first), TEST_BUFFER_SIZE);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(chain); i++)
+		buffer_free(chain[i]);
+}
+
+static void test_buffer_alias_reset(void **state)
+{
+	struct comp_buffer *source = test_buffer(TEST_BUFFER_SIZE);
+	struct comp_buffer *sink = test_buffer(TEST_BUFFER_SIZE);
+	struct audio_stream *in = &source->stream;
+	struct audio_stream *out = &sink->stream;
+
+	(void)state;
+
+	assert_int_equal(buffer_alias(source, sink), 0);
+
+	audio_stream_produce(in, 2 * TEST_PERIOD_BYTES);
+	test_process(in, out, TEST_PERIOD_BYTES);
+	assert_int_equal(audio_stream_get_free_bytes(in),
+			 TEST_BUFFER_SIZE - 2 * TEST_PERIOD_BYTES);
+
+	/* resetting the sink alone gives its data back to the source */
+	audio_buffer_reset(&sink->audio_buffer);
+	assert_int_equal(audio_stream_get_avail_bytes(out), 0);
+	assert_ptr_equal(audio_stream_get_wptr(out), audio_stream_get_addr(out));
+	assert_int_equal(audio_stream_get_free_bytes(in), TEST_BUFFER_SIZE - TEST_PERIOD_BYTES);
+
+	audio_buffer_reset(&source->audio_buffer);
+	assert_int_equal(audio_stream_get_free_bytes(in), TEST_BUFFER_SIZE);
+	assert_int_equal(audio_stream_get_free_bytes(out), 0);
+
+	/* the buffers stay aliased and work as before */
+	audio_stream_produce(in, TEST_PERIOD_BYTES);
+	test_process(in, out, TEST_PERIOD_BYTES);
+
+	buffer_free(sink);
+	buffer_free(source);
+}
+
+static void test_buffer_unalias(void **state)
+{
+	struct comp_buffer *source = test_buffer(TEST_BUFFER_SIZE);
+	struct comp_buffer *sink = test_buffer(TEST_BUFFER_SIZE);
+	struct audio_stream *out = &sink->stream;
+	void *sink_addr = audio_stream_get_addr(out);
+	void *shared;
+
+	(void)state;
+
+	num_freed = 0;
+
+	/* aliasing releases the sink memory */
+	assert_int_equal(buffer_alias(source, sink), 0);
+	assert_true(was_freed(sink_addr));
+	shared = audio_stream_get_addr(&source->stream);
+
+	audio_stream_produce(&source->stream, TEST_PERIOD_BYTES);
+	test_process(&source->stream, out, TEST_PERIOD_BYTES);
+	assert_int_equal(audio_stream_get_free_bytes(&source->stream),
+			 TEST_BUFFER_SIZE - TEST_PERIOD_BYTES);
+
+	/* the sink starts over in its own memory, the source gets all space back */
+	assert_int_equal(buffer_unalias(sink), 0);
+	assert_int_equal(audio_stream_get_free_bytes(&source->stream), TEST_BUFFER_SIZE);
+	assert_ptr_not_equal(audio_stream_get_addr(out), shared);
+	assert_null(source->stream.alias_next);
+	assert_null(out->alias_prev);
+	assert_int_equal(audio_stream_get_size(out), TEST_BUFFER_SIZE);
+	assert_int_equal(audio_stream_get_free_bytes(out), TEST_BUFFER_SIZE);
+
+	/* a second unalias is a no-op */
+	sink_addr = audio_stream_get_addr(out);
+	assert_int_equal(buffer_unalias(sink), 0);
+	assert_ptr_equal(audio_stream_get_addr(out), sink_addr);
+
+	/* each buffer frees its own memory */
+	num_freed = 0;
+	buffer_free(sink);
+	assert_true(was_freed(sink_addr));
+	assert_false(was_freed(shared));
+
+	buffer_free(source);
+	assert_true(was_freed(shared));
+}
+
+static void test_buffer_alias_free_first(void **state)
+{
+	struct comp_buffer *source = test_buffer(TEST_BUFFER_SIZE);
+	struct comp_buffer *sink = test_buffer(TEST_BUFFER_SIZE);
+	struct audio_stream *out = &sink->stream;
+	void *shared;
+
+	(void)state;
+
+	assert_int_equal(buffer_alias(source, sink), 0);
+	shared = audio_stream_get_addr(out);
+
+	/* the sink takes over the memory of the freed source */
+	num_freed = 0;
+	buffer_free(source);
+	assert_false(was_freed(shared));
+	assert_null(out->alias_prev);
+
+	audio_stream_produce(out, TEST_PERIOD_BYTES);
+	assert_int_equal(audio_stream_get_avail_bytes(out), TEST_PERIOD_BYTES);
+
+	buffer_free(sink);
+	assert_true(was_freed(shared));
+}
+
+static void test_buffer_alias_invalid(void **state)
+{
+	struct comp_buffer *source = test_buffer(TEST_BUFFER_SIZE);
+	struct comp_buffer *sink = test_buffer(TEST_BUFFER_SIZE);
+	struct comp_buffer *big = test_buffer(2 * TEST_BUFFER_SIZE);
+	struct comp_buffer *other = test_buffer(TEST_BUFFER_SIZE);
+
+	(void)state;
+
+	/* the sink must fit into the source */
+	assert_int_equal(buffer_alias(source, big), -EINVAL);
+
+	audio_stream_set_channels(&other->stream, 4);
+	assert_int_equal(buffer_alias(source, other), -EINVAL);
+
+	assert_int_equal(buffer_alias(source, sink), 0);
+	assert_int_equal(buffer_alias(source, sink), 0);
+
+	/* a stream has only one alias on either side */
+	audio_stream_set_channels(&other->stream, audio_stream_get_channels(&source->stream));
+	assert_int_equal(buffer_alias(source, other), -EBUSY);
+	assert_int_equal(buffer_alias(big, sink), -EBUSY);
+
+	/* an aliased buffer can't be resized */
+	assert_true(buffer_set_size(sink, TEST_BUFFER_SIZE / 2, 0) < 0);
+
+	buffer_free(other);
+	buffer_free(big);
+	buffer_free(sink);
+	buffer_free(source);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_buffer_alias_chain),
+		cmocka_unit_test(test_buffer_alias_reset),
+		cmocka_unit_test(test_buffer_unalias),
+		cmocka_unit_test(test_buffer_alias_free_first),
+		cmocka_unit_test(test_buffer_alias_invalid),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2026 Intel Corporation. All rights reserved.
+//
+
+#include <sof/audio/component.h>
+#include <sof/audio/ring_buffer.h>
+#include <sof/audio/module_adapter/module/generic.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+/* 1 ms of 48 kHz stereo 32 bit audio */
+#define TEST_PERIOD_BYTES	384
+#define TEST_TICKS		48
+
+struct test_dp_module {
+	struct processing_module mod;
+	struct comp_dev dev;
+	struct comp_driver drv;
+	struct module_interface ops;
+	struct ring_buffer *in;
+	struct ring_buffer *out;
+};
+
+static void test_dp_module_init(struct test_dp_module *t, uint32_t batch_periods)
+{
+	memset(t, 0, sizeof(*t));
+
+	t->drv.adapter_ops = &t->ops;
+	t->dev.drv = &t->drv;
+	t->dev.mod = &t->mod;
+	t->dev.ipc_config.proc_domain = COMP_PROCESSING_DOMAIN_DP;
+	t->mod.dev = &t->dev;
+	t->mod.dp_batch_periods = batch_periods;
+
+	t->in = ring_buffer_create(&t->dev, TEST_PERIOD_BYTES, TEST_PERIOD_BYTES, false, 0);
+	t->out = ring_buffer_create(&t->dev, TEST_PERIOD_BYTES, TEST_PERIOD_BYTES, false, 1);
+	assert_non_null(t->in);
+	assert_non_null(t->out);
+
+	t->mod.sources[0] = audio_buffer_get_source(&t->in->audio_buffer);
+	t->mod.sinks[0] = audio_buffer_get_sink(&t->out->audio_buffer);
+	t->mod.num_of_sources = 1;
+	t->mod.num_of_sinks = 1;
+}
+
+static void test_dp_module_free(struct test_dp_module *t)
+{
+	audio_buffer_free(&t->in->audio_buffer);
+	audio_buffer_free(&t->out->audio_buffer);
+}
+
+static void test_produce_period(struct sof_sink *sink)
+{
+	void *ptr, *start;
+	size_t size;
+
+	assert_int_equal(sink_get_buffer(sink, TEST_PERIOD_BYTES, &ptr, &start, &size), 0);
+	assert_int_equal(sink_commit_buffer(sink, TEST_PERIOD_BYTES), 0);
+}
+
+static void test_consume_period(struct sof_source *source)
+{
+	void const *ptr, *start;
+	size_t size;
+
+	assert_int_equal(source_get_data(source, TEST_PERIOD_BYTES, &ptr, &start, &size), 0);
+	assert_int_equal(source_release_data(source, TEST_PERIOD_BYTES), 0);
+}
+
+/* one period moved by the DP module, called by module_process_batch() */
+int module_process_sink_src(struct processing_module *mod,
+			    struct sof_source **sources, int num_of_sources,
+			    struct sof_sink **sinks, int num_of_sinks)
+{
+	test_consume_period(sources[0]);
+	test_produce_period(sinks[0]);
+
+	return 0;
+}
+
+/*
+ * Runs TEST_TICKS LL ticks, each producing one period into the module input and
+ * consuming one period of its output once available, and wakes the module as the
+ * DP scheduler does. Returns the number of wake-ups.
+ */
+static int test_dp_run(struct test_dp_module *t)
+{
+	struct sof_sink *ll_sink = audio_buffer_get_sink(&t->in->audio_buffer);
+	struct sof_source *ll_source = audio_buffer_get_source(&t->out->audio_buffer);
+	uint32_t periods = MAX(t->mod.dp_batch_periods, 1);
+	uint32_t processed;
+	int wakeups = 0;
+	int tick;
+
+	for (tick = 0; tick < TEST_TICKS; tick++) {
+		/* LL side never overruns the module input */
+		assert_true(sink_get_free_size(ll_sink) >= TEST_PERIOD_BYTES);
+		test_produce_period(ll_sink);
+
+		if (source_get_data_available(ll_source) >= TEST_PERIOD_BYTES)
+			test_consume_period(ll_source);
+
+		if (!module_is_ready_to_process_batch(&t->mod))
+			continue;
+
+		/* as dp_task_run() does */
+		wakeups++;
+		assert_int_equal(module_process_batch(&t->mod, &processed), 0);
+
+		/* the whole batch is processed in a single wake-up */
+		assert_int_equal(processed, periods);
+	}
+
+	return wakeups;
+}
+
+static void test_ring_buffer_dp_single_period(void **state)
+{
+	struct test_dp_module t;
+
+	(void)state;
+
+	test_dp_module_init(&t, 0);
+
+	assert_int_equal(t.in->data_buffer_size, 3 * TEST_PERIOD_BYTES);
+	assert_int_equal(t.out->data_buffer_size, 3 * TEST_PERIOD_BYTES);
+	assert_int_equal(test_dp_run(&t), TEST_TICKS);
+
+	test_dp_module_free(&t);
+}
+
+static void test_ring_buffer_dp_batch(void **state)
+{
+	struct test_dp_module t;
+	uint32_t batch;
+
+	(void)state;
+
+	for (batch = 2; batch <= 8; batch *= 2) {
+		test_dp_module_init(&t, batch);
+
+		assert_int_equal(t.in->data_buffer_size, (batch + 2) * TEST_PERIOD_BYTES);
+		assert_int_equal(t.out->data_buffer_size, (batch + 2) * TEST_PERIOD_BYTES);
+		assert_int_equal(test_dp_run(&t), TEST_TICKS / batch);
+
+		test_dp_module_free(&t);
+	}
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_ring_buffer_dp_single_period),
+		cmocka_unit_test(test_ring_buffer_dp_batch),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
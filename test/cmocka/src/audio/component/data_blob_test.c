@@ -0,0 +1,340 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2026 Intel Corporation. All rights reserved.
+//
+
+#include <sof/audio/component.h>
+#include <sof/audio/data_blob.h>
+#include <ipc/control.h>
+#include <errno.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmocka.h>
+
+#define TEST_BLOB_SIZE		96
+#define TEST_FRAGMENT_SIZE	40
+
+struct test_stream_log {
+	uint8_t blob[TEST_BLOB_SIZE];
+	enum module_cfg_fragment_position pos[4];
+	uint32_t offset[4];
+	int calls;
+	int fail_call;		/* call to fail with -EIO, -1 for none */
+};
+
+static struct test_stream_log stream_log;
+
+static uint8_t test_blob[TEST_BLOB_SIZE];
+
+struct test_prepare_log {
+	int prepared;
+	int released;
+};
+
+static struct test_prepare_log prepare_log;
+
+/* The prepared state records the first byte of the blob it was made for */
+static int test_prepare(struct comp_dev *dev, const void *data, uint32_t data_size,
+			void **state)
+{
+	uint8_t *s = malloc(1);
+
+	assert_non_null(s);
+	*s = *(const uint8_t *)data;
+	*state = s;
+	prepare_log.prepared++;
+
+	return 0;
+}
+
+static void test_release(struct comp_dev *dev, void *state)
+{
+	assert_non_null(state);
+	free(state);
+	prepare_log.released++;
+}
+
+static const struct comp_data_blob_prepare_ops test_prepare_ops = {
+	.prepare = test_prepare,
+	.release = test_release,
+};
+
+static int test_stream(struct comp_dev *dev, enum module_cfg_fragment_position pos,
+		       uint32_t data_size, uint32_t offset,
+		       const uint8_t *fragment, size_t fragment_size)
+{
+	int call = stream_log.calls++;
+
+	assert_int_equal(data_size, TEST_BLOB_SIZE);
+	assert_true(offset + fragment_size <= data_size);
+
+	if (call == stream_log.fail_call)
+		return -EIO;
+
+	if (call < ARRAY_SIZE(stream_log.pos)) {
+		stream_log.pos[call] = pos;
+		stream_log.offset[call] = offset;
+	}
+
+	memcpy(stream_log.blob + offset, fragment, fragment_size);
+
+	return 0;
+}
+
+struct test_state {
+	struct comp_dev dev;
+	struct comp_data_blob_handler *handler;
+	struct sof_ipc_ctrl_data *cdata;
+};
+
+static int setup(void **state)
+{
+	struct test_state *ts = calloc(1, sizeof(*ts));
+	uint8_t init_blob[8] = { 0 };
+	int i;
+
+	assert_non_null(ts);
+
+	ts->dev.state = COMP_STATE_READY;
+	ts->handler = comp_data_blob_handler_new(&ts->dev);
+	assert_non_null(ts->handler);
+	assert_int_equal(comp_init_data_blob(ts->handler, sizeof(init_blob), init_blob), 0);
+
+	ts->cdata = calloc(1, sizeof(*ts->cdata) + sizeof(struct sof_abi_hdr) +
+			   TEST_BLOB_SIZE);
+	assert_non_null(ts->cdata);
+	ts->cdata->cmd = SOF_CTRL_CMD_BINARY;
+	ts->cdata->data->size = TEST_BLOB_SIZE;
+
+	for (i = 0; i < TEST_BLOB_SIZE; i++)
+		test_blob[i] = i * 7 + 3;
+
+	memset(&stream_log, 0, sizeof(stream_log));
+	stream_log.fail_call = -1;
+	memset(&prepare_log, 0, sizeof(prepare_log));
+
+	*state = ts;
+
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	struct test_state *ts = *state;
+
+	comp_data_blob_handler_free(ts->handler);
+	free(ts->cdata);
+	free(ts);
+
+	/* every prepared state has been released exactly once */
+	assert_int_equal(prepare_log.prepared, prepare_log.released);
+
+	return 0;
+}
+
+/* Sends fragment number msg_index of test_blob through the IPC3 control path */
+static int test_set_cmd(struct test_state *ts, uint32_t msg_index, uint32_t size)
+{
+	uint32_t offset = msg_index * TEST_FRAGMENT_SIZE;
+
+	ts->cdata->msg_index = msg_index;
+	ts->cdata->num_elems = size;
+	ts->cdata->elems_remaining = TEST_BLOB_SIZE - MIN(offset + size, TEST_BLOB_SIZE);
+	memcpy(ts->cdata->data->data, test_blob + offset, MIN(size, TEST_BLOB_SIZE - offset));
+
+	return comp_data_blob_set_cmd(ts->handler, ts->cdata);
+}
+
+/* Sends a fragment of test_blob through the module adapter path */
+static int test_set(struct test_state *ts, enum module_cfg_fragment_position pos,
+		    uint32_t offset, uint32_t size)
+{
+	memcpy(ts->cdata->data->data, test_blob + offset, size);
+	ts->cdata->num_elems = size;
+
+	return comp_data_blob_set(ts->handler, pos, TEST_BLOB_SIZE,
+				  (const uint8_t *)ts->cdata, size);
+}
+
+static void test_data_blob_stream_set_cmd(void **state)
+{
+	struct test_state *ts = *state;
+	size_t size;
+
+	comp_data_blob_set_stream(ts->handler, test_stream);
+
+	assert_int_equal(test_set_cmd(ts, 0, TEST_FRAGMENT_SIZE), 0);
+	assert_int_equal(test_set_cmd(ts, 1, TEST_FRAGMENT_SIZE), 0);
+	assert_int_equal(test_set_cmd(ts, 2, TEST_BLOB_SIZE - 2 * TEST_FRAGMENT_SIZE), 0);
+
+	assert_int_equal(stream_log.calls, 3);
+	assert_int_equal(stream_log.pos[0], MODULE_CFG_FRAGMENT_FIRST);
+	assert_int_equal(stream_log.pos[1], MODULE_CFG_FRAGMENT_MIDDLE);
+	assert_int_equal(stream_log.pos[2], MODULE_CFG_FRAGMENT_LAST);
+	assert_int_equal(stream_log.offset[1], TEST_FRAGMENT_SIZE);
+	assert_int_equal(stream_log.offset[2], 2 * TEST_FRAGMENT_SIZE);
+	assert_memory_equal(stream_log.blob, test_blob, TEST_BLOB_SIZE);
+
+	/* nothing was staged, the initial blob is still current */
+	assert_false(comp_is_new_data_blob_available(ts->handler));
+	comp_get_data_blob(ts->handler, &size, NULL);
+	assert_int_equal(size, 8);
+}
+
+static void test_data_blob_stream_single(void **state)
+{
+	struct test_state *ts = *state;
+
+	comp_data_blob_set_stream(ts->handler, test_stream);
+
+	assert_int_equal(test_set(ts, MODULE_CFG_FRAGMENT_SINGLE, 0, TEST_BLOB_SIZE), 0);
+	assert_int_equal(stream_log.calls, 1);
+	assert_int_equal(stream_log.pos[0], MODULE_CFG_FRAGMENT_SINGLE);
+	assert_memory_equal(stream_log.blob, test_blob, TEST_BLOB_SIZE);
+}
+
+static void test_data_blob_stream_overflow(void **state)
+{
+	struct test_state *ts = *state;
+
+	comp_data_blob_set_stream(ts->handler, test_stream);
+
+	assert_int_equal(test_set(ts, MODULE_CFG_FRAGMENT_FIRST, 0, TEST_FRAGMENT_SIZE), 0);
+	assert_int_equal(test_set(ts, MODULE_CFG_FRAGMENT_MIDDLE, TEST_FRAGMENT_SIZE,
+				  TEST_FRAGMENT_SIZE), 0);
+
+	/* one more full fragment doesn't fit, the transfer is aborted */
+	assert_int_equal(test_set(ts, MODULE_CFG_FRAGMENT_MIDDLE, 0, TEST_FRAGMENT_SIZE),
+			 -EINVAL);
+	assert_int_equal(test_set(ts, MODULE_CFG_FRAGMENT_LAST, 0, 1), -EINVAL);
+	assert_int_equal(stream_log.calls, 2);
+
+	/* a new transfer starts over */
+	assert_int_equal(test_set(ts, MODULE_CFG_FRAGMENT_SINGLE, 0, TEST_BLOB_SIZE), 0);
+	assert_int_equal(stream_log.calls, 3);
+	assert_memory_equal(stream_log.blob, test_blob, TEST_BLOB_SIZE);
+}
+
+static void test_data_blob_stream_error(void **state)
+{
+	struct test_state *ts = *state;
+
+	comp_data_blob_set_stream(ts->handler, test_stream);
+	stream_log.fail_call = 1;
+
+	assert_int_equal(test_set_cmd(ts, 0, TEST_FRAGMENT_SIZE), 0);
+	assert_int_equal(test_set_cmd(ts, 1, TEST_FRAGMENT_SIZE), -EIO);
+
+	/* the callback error aborted the transfer */
+	assert_int_equal(test_set_cmd(ts, 2, TEST_BLOB_SIZE - 2 * TEST_FRAGMENT_SIZE),
+			 -EINVAL);
+	assert_int_equal(stream_log.calls, 2);
+}
+
+/* Sends a whole blob starting with first_byte and returns its prepared state */
+static uint8_t *test_set_prepared(struct test_state *ts, uint8_t first_byte)
+{
+	test_blob[0] = first_byte;
+	assert_int_equal(test_set(ts, MODULE_CFG_FRAGMENT_SINGLE, 0, TEST_BLOB_SIZE), 0);
+	assert_true(comp_is_new_data_blob_available(ts->handler));
+
+	return comp_data_blob_get_state(ts->handler);
+}
+
+static void test_data_blob_lifecycle(void **state)
+{
+	struct test_state *ts = *state;
+	void *old_state;
+	uint8_t *s;
+
+	comp_data_blob_set_prepare_ops(ts->handler, &test_prepare_ops);
+	ts->dev.state = COMP_STATE_ACTIVE;
+
+	/* prepared in IPC context, the initial blob has no state */
+	test_set_prepared(ts, 1);
+	assert_int_equal(prepare_log.prepared, 1);
+	assert_null(comp_data_blob_get_state(ts->handler));
+
+	assert_true(comp_data_blob_swap(ts->handler, &old_state));
+	assert_null(old_state);
+	s = comp_data_blob_get_state(ts->handler);
+	assert_int_equal(*s, 1);
+
+	/* a period without a new blob ends the use of the retired one */
+	assert_false(comp_data_blob_swap(ts->handler, &old_state));
+	assert_null(old_state);
+
+	test_set_prepared(ts, 2);
+	assert_true(comp_data_blob_swap(ts->handler, &old_state));
+	assert_ptr_equal(old_state, s);
+	s = comp_data_blob_get_state(ts->handler);
+	assert_int_equal(*s, 2);
+
+	/* the retired state may still be in use, IPC leaves it alone */
+	test_set_prepared(ts, 3);
+	assert_int_equal(prepare_log.released, 0);
+
+	/* the audio thread releases it when the next blob comes in first */
+	assert_true(comp_data_blob_swap(ts->handler, &old_state));
+	assert_ptr_equal(old_state, s);
+	assert_int_equal(prepare_log.released, 1);
+	s = comp_data_blob_get_state(ts->handler);
+	assert_int_equal(*s, 3);
+
+	/* otherwise the next IPC reclaims it */
+	assert_false(comp_data_blob_swap(ts->handler, NULL));
+	test_set_prepared(ts, 4);
+	assert_int_equal(prepare_log.released, 2);
+	assert_int_equal(prepare_log.prepared, 4);
+}
+
+static void test_data_blob_replace_pending(void **state)
+{
+	struct test_state *ts = *state;
+	size_t size;
+	uint8_t *data;
+	uint8_t *s;
+
+	comp_data_blob_set_prepare_ops(ts->handler, &test_prepare_ops);
+	ts->dev.state = COMP_STATE_ACTIVE;
+
+	test_blob[0] = 1;
+	assert_int_equal(ipc4_comp_data_blob_set(ts->handler, true, true, TEST_BLOB_SIZE,
+						 (const char *)test_blob), 0);
+	assert_int_equal(prepare_log.prepared, 1);
+
+	/* a second blob overwrites the pending one before any period */
+	test_blob[0] = 2;
+	assert_int_equal(ipc4_comp_data_blob_set(ts->handler, true, true, TEST_BLOB_SIZE,
+						 (const char *)test_blob), 0);
+	assert_int_equal(prepare_log.prepared, 2);
+	assert_int_equal(prepare_log.released, 1);
+
+	assert_true(comp_data_blob_swap(ts->handler, NULL));
+	s = comp_data_blob_get_state(ts->handler);
+	assert_int_equal(*s, 2);
+
+	data = comp_get_data_blob(ts->handler, &size, NULL);
+	assert_int_equal(size, TEST_BLOB_SIZE);
+	assert_memory_equal(data, test_blob, TEST_BLOB_SIZE);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(test_data_blob_stream_set_cmd, setup, teardown),
+		cmocka_unit_test_setup_teardown(test_data_blob_stream_single, setup, teardown),
+		cmocka_unit_test_setup_teardown(test_data_blob_stream_overflow, setup, teardown),
+		cmocka_unit_test_setup_teardown(test_data_blob_stream_error, setup, teardown),
+		cmocka_unit_test_setup_teardown(test_data_blob_lifecycle, setup, teardown),
+		cmocka_unit_test_setup_teardown(test_data_blob_replace_pending, setup, teardown),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,272 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2026 Intel Corporation. All rights reserved.
+//
+
+#include "../../util.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <sof/audio/buffer.h>
+#include <sof/audio/channel_remix.h>
+#include <sof/audio/component.h>
+
+/* frames remixed per pass, the buffers hold one pass plus one sample */
+#define REMIX_TEST_FRAMES	7
+#define REMIX_TEST_PASSES	3
+
+typedef int16_t remix_test_coeffs[CHANNEL_REMIX_SINK_MAX][CHANNEL_REMIX_SOURCE_MAX];
+
+struct remix_test_parameters {
+	int sink_channels;
+	int source_channels;
+	uint32_t frame_fmt;
+	enum channel_remix_shape shape;
+	void (*fill_coeffs)(remix_test_coeffs c);
+};
+
+/* one sink channel from two source channels, the sum saturates */
+static void fill_downmix2(remix_test_coeffs c)
+{
+	c[0][1] = 700;
+	c[0][3] = 700;
+}
+
+static void fill_sparse(remix_test_coeffs c)
+{
+	c[0][0] = 300;
+	c[1][2] = 7000;
+	c[1][5] = -2000;
+	c[2][1] = CHANNEL_REMIX_UNITY;
+}
+
+/* exactly CHANNEL_REMIX_TAPS_MAX coefficients, still sparse */
+static void fill_sparse_max(remix_test_coeffs c)
+{
+	int i, j;
+
+	for (i = 0; i < 2; i++)
+		for (j = 0; j < 16; j++)
+			c[i][j] = (i + 1) * 64 - j * 9;
+}
+
+static void fill_dense(remix_test_coeffs c)
+{
+	int i, j;
+
+	for (i = 0; i < 8; i++)
+		for (j = 0; j < 8; j++)
+			c[i][j] = rand() % 3000 - 1500;
+}
+
+/* one coefficient over CHANNEL_REMIX_TAPS_MAX falls back to the matrix */
+static void fill_dense_fallback(remix_test_coeffs c)
+{
+	int i, j;
+
+	for (i = 0; i < 3; i++)
+		for (j = 0; j < 11; j++) {
+			c[i][j] = rand() % 2000 - 1000;
+			if (!c[i][j])
+				c[i][j] = 1;
+		}
+}
+
+static int32_t remix_test_ref(const int16_t *row, const int32_t *x, int source_channels,
+			      uint32_t frame_fmt)
+{
+	int64_t acc = 0;
+	int j;
+
+	for (j = 0; j < source_channels; j++)
+		acc += (int64_t)x[j] * row[j];
+
+	acc = (acc + (1 << (CHANNEL_REMIX_Q_SHIFT - 1))) >> CHANNEL_REMIX_Q_SHIFT;
+
+	switch (frame_fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		return MIN(MAX(acc, INT16_MIN), INT16_MAX);
+	case SOF_IPC_FRAME_S24_4LE:
+		return MIN(MAX(acc, -(1 << 23)), (1 << 23) - 1);
+	default:
+		return MIN(MAX(acc, INT32_MIN), INT32_MAX);
+	}
+}
+
+static int32_t remix_test_random_sample(uint32_t frame_fmt)
+{
+	int32_t s = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+
+	switch (frame_fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		return (int16_t)s;
+	case SOF_IPC_FRAME_S24_4LE:
+		return (s << 8) >> 8;
+	default:
+		return s;
+	}
+}
+
+static int32_t remix_test_get(struct audio_stream *stream, void *base, int idx)
+{
+	void *ptr;
+
+	if (audio_stream_get_frm_fmt(stream) == SOF_IPC_FRAME_S16_LE) {
+		ptr = audio_stream_wrap(stream, (int16_t *)base + idx);
+		return *(int16_t *)ptr;
+	}
+
+	ptr = audio_stream_wrap(stream, (int32_t *)base + idx);
+	return *(int32_t *)ptr;
+}
+
+static void remix_test_set(struct audio_stream *stream, void *base, int idx, int32_t s)
+{
+	void *ptr;
+
+	if (audio_stream_get_frm_fmt(stream) == SOF_IPC_FRAME_S16_LE) {
+		ptr = audio_stream_wrap(stream, (int16_t *)base + idx);
+		*(int16_t *)ptr = s;
+		return;
+	}
+
+	ptr = audio_stream_wrap(stream, (int32_t *)base + idx);
+	*(int32_t *)ptr = s;
+}
+
+static void remix_test_process(const struct channel_remix *remix, struct audio_stream *source,
+			       struct audio_stream *sink, uint32_t frames)
+{
+	switch (audio_stream_get_frm_fmt(source)) {
+	case SOF_IPC_FRAME_S16_LE:
+		channel_remix_s16(remix, source, sink, frames);
+		break;
+	case SOF_IPC_FRAME_S24_4LE:
+		channel_remix_s24(remix, source, sink, frames);
+		break;
+	default:
+		channel_remix_s32(remix, source, sink, frames);
+		break;
+	}
+}
+
+/*
+ * Runs a few passes of frames through the remix and compares every sink
+ * sample with a plain matrix multiplication. The buffers are one sample
+ * bigger than a pass, so from the second pass on a frame is split by the
+ * buffer wrap after its first sample and goes through the single frame path.
+ */
+static void test_channel_remix(void **state)
+{
+	struct remix_test_parameters *p = *state;
+	remix_test_coeffs coeffs;
+	struct channel_remix remix;
+	struct comp_buffer *source;
+	struct comp_buffer *sink;
+	struct comp_dev dev;
+	int32_t frame[CHANNEL_REMIX_SOURCE_MAX];
+	size_t sample_bytes = p->frame_fmt == SOF_IPC_FRAME_S16_LE ? 2 : 4;
+	size_t source_bytes = REMIX_TEST_FRAMES * p->source_channels * sample_bytes;
+	size_t sink_bytes = REMIX_TEST_FRAMES * p->sink_channels * sample_bytes;
+	size_t to_end;
+	void *x, *y;
+	int pass, i, ch;
+
+	list_init(&dev.bsink_list);
+	list_init(&dev.bsource_list);
+
+	source = create_test_source(&dev, 0, p->frame_fmt, p->source_channels,
+				    source_bytes + sample_bytes);
+	sink = create_test_sink(&dev, 0, p->frame_fmt, p->sink_channels,
+				sink_bytes + sample_bytes);
+
+	memset(coeffs, 0, sizeof(coeffs));
+	p->fill_coeffs(coeffs);
+	assert_int_equal(channel_remix_build(&remix, &coeffs[0][0], CHANNEL_REMIX_SOURCE_MAX,
+					     p->sink_channels, p->source_channels), 0);
+	assert_int_equal(remix.shape, p->shape);
+
+	for (pass = 0; pass < REMIX_TEST_PASSES; pass++) {
+		x = audio_stream_get_rptr(&source->stream);
+		y = audio_stream_get_wptr(&sink->stream);
+
+		if (pass == 1) {
+			/* the wrap falls after the first sample of a frame */
+			to_end = (char *)audio_stream_get_end_addr(&source->stream) - (char *)x;
+			assert_int_equal(to_end, sample_bytes);
+		}
+
+		for (i = 0; i < REMIX_TEST_FRAMES * p->source_channels; i++)
+			remix_test_set(&source->stream, x, i,
+				       remix_test_random_sample(p->frame_fmt));
+		audio_stream_produce(&source->stream, source_bytes);
+
+		remix_test_process(&remix, &source->stream, &sink->stream, REMIX_TEST_FRAMES);
+
+		for (i = 0; i < REMIX_TEST_FRAMES; i++) {
+			for (ch = 0; ch < p->source_channels; ch++)
+				frame[ch] = remix_test_get(&source->stream, x,
+							   i * p->source_channels + ch);
+
+			for (ch = 0; ch < p->sink_channels; ch++)
+				assert_int_equal(remix_test_get(&sink->stream, y,
+								i * p->sink_channels + ch),
+						 remix_test_ref(coeffs[ch], frame,
+								p->source_channels,
+								p->frame_fmt));
+		}
+
+		audio_stream_consume(&source->stream, source_bytes);
+		audio_stream_produce(&sink->stream, sink_bytes);
+		audio_stream_consume(&sink->stream, sink_bytes);
+	}
+
+	free_test_sink(sink);
+	free_test_source(source);
+}
+
+static struct remix_test_parameters parameters[] = {
+#if CONFIG_FORMAT_S16LE
+	{ 1, 4, SOF_IPC_FRAME_S16_LE, CHANNEL_REMIX_DOWNMIX2, fill_downmix2 },
+	{ 3, 6, SOF_IPC_FRAME_S16_LE, CHANNEL_REMIX_SPARSE, fill_sparse },
+	{ 2, 16, SOF_IPC_FRAME_S16_LE, CHANNEL_REMIX_SPARSE, fill_sparse_max },
+	{ 8, 8, SOF_IPC_FRAME_S16_LE, CHANNEL_REMIX_DENSE, fill_dense },
+	{ 3, 11, SOF_IPC_FRAME_S16_LE, CHANNEL_REMIX_DENSE, fill_dense_fallback },
+#endif /* CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_S24LE
+	{ 1, 4, SOF_IPC_FRAME_S24_4LE, CHANNEL_REMIX_DOWNMIX2, fill_downmix2 },
+	{ 3, 6, SOF_IPC_FRAME_S24_4LE, CHANNEL_REMIX_SPARSE, fill_sparse },
+	{ 2, 16, SOF_IPC_FRAME_S24_4LE, CHANNEL_REMIX_SPARSE, fill_sparse_max },
+	{ 8, 8, SOF_IPC_FRAME_S24_4LE, CHANNEL_REMIX_DENSE, fill_dense },
+	{ 3, 11, SOF_IPC_FRAME_S24_4LE, CHANNEL_REMIX_DENSE, fill_dense_fallback },
+#endif /* CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_S32LE
+	{ 1, 4, SOF_IPC_FRAME_S32_LE, CHANNEL_REMIX_DOWNMIX2, fill_downmix2 },
+	{ 3, 6, SOF_IPC_FRAME_S32_LE, CHANNEL_REMIX_SPARSE, fill_sparse },
+	{ 2, 16, SOF_IPC_FRAME_S32_LE, CHANNEL_REMIX_SPARSE, fill_sparse_max },
+	{ 8, 8, SOF_IPC_FRAME_S32_LE, CHANNEL_REMIX_DENSE, fill_dense },
+	{ 3, 11, SOF_IPC_FRAME_S32_LE, CHANNEL_REMIX_DENSE, fill_dense_fallback },
+#endif /* CONFIG_FORMAT_S32LE */
+};
+
+int main(void)
+{
+	int i;
+
+	struct CMUnitTest tests[ARRAY_SIZE(parameters)];
+
+	for (i = 0; i < ARRAY_SIZE(parameters); i++) {
+		tests[i].name = "test_channel_remix";
+		tests[i].test_func = test_channel_remix;
+		tests[i].setup_func = NULL;
+		tests[i].teardown_func = NULL;
+		tests[i].initial_state = &parameters[i];
+	}
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
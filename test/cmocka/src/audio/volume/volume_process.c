@@ -33,6 +33,7 @@
 
 struct vol_test_parameters {
 	int32_t volume;
+	bool shortcut;	/* use the unity or zero gain function if volume allows */
 	struct processing_module_test_parameters module_parameters;
 };
 
@@ -44,6 +45,16 @@ static void set_volume(int32_t *vol, int32_t value, uint32_t channels)
 		vol[i] = value;
 }
 
+static vol_scale_func get_scale_vol(struct processing_module_test_data *vol_state,
+				    struct vol_data *cd)
+{
+#if CONFIG_IPC_MAJOR_4
+	return vol_get_processing_function(vol_state->mod->dev, cd);
+#else
+	return vol_get_processing_function(vol_state->mod->dev, vol_state->sinks[0], cd);
+#endif
+}
+
 static int setup(void **state)
 {
 	struct vol_test_parameters *vol_parameters = *state;
@@ -62,7 +73,8 @@ static int setup(void **state)
 	cd = test_malloc(sizeof(*cd));
 	md = &vol_state->mod->priv;
 	md->private = cd;
-	cd->is_passthrough = false;
+	cd->is_passthrough = vol_parameters->shortcut && vol_parameters->volume == VOL_ZERO_DB;
+	cd->is_muted = vol_parameters->shortcut && !vol_parameters->volume;
 
 	/* malloc memory to store current volume 4 times to ensure the address
 	 * is 8-byte aligned for multi-way xtensa intrinsic operations.
@@ -72,11 +84,7 @@ static int setup(void **state)
 	cd->vol = test_malloc(vol_size);
 
 	/* set processing function and volume */
-#if CONFIG_IPC_MAJOR_4
-	cd->scale_vol = vol_get_processing_function(vol_state->mod->dev, cd);
-#else
-	cd->scale_vol = vol_get_processing_function(vol_state->mod->dev, vol_state->sinks[0], cd);
-#endif
+	cd->scale_vol = get_scale_vol(vol_state, cd);
 	set_volume(cd->volume, vol_parameters->volume, vol_state->parameters.channels);
 
 	/* assign test state */
@@ -293,6 +301,25 @@ static void test_audio_vol(void **state)
 		      mod->dev->frames, cd->attenuation);
 
 	vol_state->verify(mod, vol_state->sinks[0], vol_state->sources[0]);
+
+	/* Unity and zero gain functions must match gain multiplication bit exactly */
+	if (cd->is_passthrough || cd->is_muted) {
+		size_t bytes = vol_state->output_buffers[0]->size;
+		void *ref = test_malloc(bytes);
+
+		memcpy_s(ref, bytes, vol_state->sinks[0]->stream.w_ptr, bytes);
+
+		cd->is_passthrough = false;
+		cd->is_muted = false;
+		vol_state->input_buffers[0]->consumed = 0;
+		vol_state->output_buffers[0]->size = 0;
+		get_scale_vol(vol_state, cd)(mod, vol_state->input_buffers[0],
+					     vol_state->output_buffers[0], mod->dev->frames,
+					     cd->attenuation);
+
+		assert_memory_equal(vol_state->sinks[0]->stream.w_ptr, ref, bytes);
+		test_free(ref);
+	}
 }
 
 static struct processing_module_test_parameters test_parameters[] = {
@@ -313,15 +340,22 @@ static struct processing_module_test_parameters test_parameters[] = {
 int main(void)
 {
 	struct vol_test_parameters *parameters;
-	uint32_t volume_values[] = {VOL_MAX, VOL_ZERO_DB, VOL_MINUS_80DB};
+	struct vol_test_parameters volume_values[] = {
+		{ .volume = VOL_MAX },
+		{ .volume = VOL_ZERO_DB },
+		{ .volume = VOL_MINUS_80DB },
+		{ .volume = 0 },
+		{ .volume = VOL_ZERO_DB, .shortcut = true },
+		{ .volume = 0, .shortcut = true },
+	};
 	int num_tests = ARRAY_SIZE(test_parameters) * ARRAY_SIZE(volume_values);
 	int i, j;
 
 	parameters = test_calloc(num_tests, sizeof(struct vol_test_parameters));
 	for (i = 0; i < ARRAY_SIZE(test_parameters); i++) {
 		for (j = 0; j < ARRAY_SIZE(volume_values); j++) {
-			parameters[i * ARRAY_SIZE(test_parameters) + j].volume = volume_values[j];
-			parameters[i * ARRAY_SIZE(test_parameters) + j].module_parameters =
+			parameters[i * ARRAY_SIZE(volume_values) + j] = volume_values[j];
+			parameters[i * ARRAY_SIZE(volume_values) + j].module_parameters =
 				test_parameters[i];
 		}
 	}
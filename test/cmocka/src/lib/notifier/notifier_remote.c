@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2026 Intel Corporation. All rights reserved.
+//
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+/*
+ * The library platform stubs idc_send_msg() inline and the unit tests run on
+ * a single core, so skip the stub and build the notifier here to queue events
+ * for core 0 as if another core sent them.
+ */
+#define __PLATFORM_DRIVERS_IDC_H__
+
+struct idc_msg;
+
+static int idc_result;
+static int idc_sent;
+
+static int idc_send_msg(struct idc_msg *msg, uint32_t mode)
+{
+	(void)msg;
+	(void)mode;
+
+	idc_sent++;
+
+	return idc_result;
+}
+
+#include "notifier.c"
+
+#define TEST_EVENTS_MAX	(2 * NOTIFIER_REMOTE_QUEUE_SIZE)
+
+static struct notify *test_notify;
+
+struct notify **arch_notify_get(void)
+{
+	return &test_notify;
+}
+
+static int test_payload[TEST_EVENTS_MAX];
+static int *test_received[TEST_EVENTS_MAX];
+static int num_received;
+
+static void test_callback(void *arg, enum notify_id type, void *data)
+{
+	(void)arg;
+
+	assert_int_equal(type, NOTIFIER_ID_LL_POST_RUN);
+	assert_true(num_received < TEST_EVENTS_MAX);
+
+	test_received[num_received++] = data;
+}
+
+/* queues event n like notifier_event() does on another core */
+static void test_event(int n)
+{
+	struct idc_msg notify_msg = { IDC_MSG_NOTIFY, IDC_MSG_NOTIFY_EXT };
+
+	if (notifier_queue_remote(notify_data_get(), NULL, NOTIFIER_ID_LL_POST_RUN,
+				  &test_payload[n], sizeof(test_payload[n])))
+		notifier_kick_remote(notify_data_get(), &notify_msg);
+}
+
+static int setup(void **state)
+{
+	(void)state;
+
+	init_system_notify(sof_get());
+	memset(notify_data_get(), 0, sizeof(*notify_data_get()));
+	k_spinlock_init(&notify_data_get()->lock);
+
+	idc_result = 0;
+	idc_sent = 0;
+	num_received = 0;
+
+	return notifier_register(NULL, NULL, NOTIFIER_ID_LL_POST_RUN, test_callback, 0);
+}
+
+static int teardown(void **state)
+{
+	(void)state;
+
+	notifier_unregister_all(NULL, NULL);
+	rfree(test_notify);
+	test_notify = NULL;
+
+	return 0;
+}
+
+static void test_notifier_remote_batch(void **state)
+{
+	int i;
+
+	(void)state;
+
+	/* one IDC message runs all events queued behind the first one */
+	for (i = 0; i < 3; i++)
+		test_event(i);
+	assert_int_equal(idc_sent, 1);
+
+	notifier_notify_remote();
+	assert_int_equal(num_received, 3);
+	for (i = 0; i < 3; i++)
+		assert_ptr_equal(test_received[i], &test_payload[i]);
+
+	/* the drained queue needs a new message */
+	test_event(3);
+	assert_int_equal(idc_sent, 2);
+}
+
+static void test_notifier_remote_full(void **state)
+{
+	struct notify_data *notify_data = notify_data_get();
+	int i;
+
+	(void)state;
+
+	for (i = 0; i < NOTIFIER_REMOTE_QUEUE_SIZE + 2; i++)
+		test_event(i);
+	assert_int_equal(idc_sent, 1);
+	assert_int_equal(notify_data->count, NOTIFIER_REMOTE_QUEUE_SIZE);
+	assert_int_equal(notify_data->dropped, 2);
+
+	notifier_notify_remote();
+	assert_int_equal(num_received, NOTIFIER_REMOTE_QUEUE_SIZE);
+	for (i = 0; i < NOTIFIER_REMOTE_QUEUE_SIZE; i++)
+		assert_ptr_equal(test_received[i], &test_payload[i]);
+
+	test_event(0);
+	assert_int_equal(idc_sent, 2);
+}
+
+static void test_notifier_remote_send_failed(void **state)
+{
+	struct idc_msg notify_msg = { IDC_MSG_NOTIFY, IDC_MSG_NOTIFY_EXT };
+	struct notify_data *notify_data = notify_data_get();
+	int i;
+
+	(void)state;
+
+	/* events queued by other cores before the send fails go too */
+	idc_result = -EACCES;
+	assert_true(notifier_queue_remote(notify_data, NULL, NOTIFIER_ID_LL_POST_RUN,
+					  &test_payload[0], sizeof(test_payload[0])));
+	for (i = 1; i < NOTIFIER_REMOTE_QUEUE_SIZE; i++)
+		assert_false(notifier_queue_remote(notify_data, NULL, NOTIFIER_ID_LL_POST_RUN,
+						   &test_payload[i], sizeof(test_payload[i])));
+	notifier_kick_remote(notify_data, &notify_msg);
+
+	assert_int_equal(idc_sent, 1);
+	assert_int_equal(notify_data->count, 0);
+	assert_int_equal(notify_data->dropped, NOTIFIER_REMOTE_QUEUE_SIZE);
+
+	/* the next event isn't stuck behind the dropped ones */
+	idc_result = 0;
+	test_event(NOTIFIER_REMOTE_QUEUE_SIZE);
+	assert_int_equal(idc_sent, 2);
+
+	notifier_notify_remote();
+	assert_int_equal(num_received, 1);
+	assert_ptr_equal(test_received[0], &test_payload[NOTIFIER_REMOTE_QUEUE_SIZE]);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(test_notifier_remote_batch, setup, teardown),
+		cmocka_unit_test_setup_teardown(test_notifier_remote_full, setup, teardown),
+		cmocka_unit_test_setup_teardown(test_notifier_remote_send_failed, setup, teardown),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
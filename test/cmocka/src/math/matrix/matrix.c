@@ -12,6 +12,7 @@
 #include <stddef.h>
 #include <setjmp.h>
 #include <string.h>
+#include <time.h>
 #include <cmocka.h>
 #include <math.h>
 #include <sof/math/matrix.h>
@@ -161,6 +162,234 @@ static void test_matrix_mult_16_test4(void **state)
 			    MATRIX_MULT_16_TEST4_C_QXY_Y);
 }
 
+/* Straightforward products to check the blocked, sparse and band kernels against */
+static int64_t ref_shift(int64_t s, int shift_minus_one)
+{
+	return shift_minus_one == -1 ? s : ((s >> shift_minus_one) + 1) >> 1;
+}
+
+static void ref_multiply_16b(struct mat_matrix_16b *a, struct mat_matrix_16b *b,
+			     struct mat_matrix_16b *c)
+{
+	const int shift_minus_one = a->fractions + b->fractions - c->fractions - 1;
+	int64_t s;
+	int i, j, k;
+
+	for (i = 0; i < a->rows; i++) {
+		for (j = 0; j < b->columns; j++) {
+			s = 0;
+			for (k = 0; k < a->columns; k++)
+				s += (int32_t)mat_get_scalar_16b(a, i, k) *
+				     mat_get_scalar_16b(b, k, j);
+
+			mat_set_scalar_16b(c, i, j, (int16_t)ref_shift(s, shift_minus_one));
+		}
+	}
+}
+
+static void ref_multiply_32x16b(struct mat_matrix_32b *a, struct mat_matrix_16b *b,
+				struct mat_matrix_32b *c)
+{
+	const int shift_minus_one = a->fractions + b->fractions - c->fractions - 1;
+	int64_t s;
+	int i, j, k;
+
+	for (i = 0; i < a->rows; i++) {
+		for (j = 0; j < b->columns; j++) {
+			s = 0;
+			for (k = 0; k < a->columns; k++)
+				s += (int64_t)mat_get_scalar_32b(a, i, k) *
+				     mat_get_scalar_16b(b, k, j);
+
+			mat_set_scalar_32b(c, i, j, (int32_t)ref_shift(s, shift_minus_one));
+		}
+	}
+}
+
+/* Random data with about one zero in four values */
+static void fill_random_16b(struct mat_matrix_16b *mat)
+{
+	int i;
+
+	for (i = 0; i < mat->rows * mat->columns; i++)
+		mat->data[i] = rand() % 4 ? (int16_t)rand() : 0;
+}
+
+static void fill_random_32b(struct mat_matrix_32b *mat)
+{
+	int i;
+
+	for (i = 0; i < mat->rows * mat->columns; i++)
+		mat->data[i] = rand() % 4 ? (int32_t)((uint32_t)rand() << 16 ^ rand()) : 0;
+}
+
+/* Overlapping triangles like a Mel filterbank, rows are bins and columns are bands */
+static void fill_filterbank_16b(struct mat_matrix_16b *mat)
+{
+	int width = 2 * mat->rows / (mat->columns + 1);
+	int half = width / 2;
+	int i, j, d;
+
+	mat_set_all_16b(mat, 0);
+	for (j = 0; j < mat->columns; j++) {
+		for (i = 0; i <= width; i++) {
+			d = i < half ? half - i : i - half;
+			if (j * half + i < mat->rows)
+				mat_set_scalar_16b(mat, j * half + i, j,
+						   32767 - 32767 * d / (half + 1));
+		}
+	}
+}
+
+static void test_matrix_mult_16_blocked(void **state)
+{
+	struct mat_matrix_16b *a = mat_matrix_alloc_16b(5, 19, 15);
+	struct mat_matrix_16b *b = mat_matrix_alloc_16b(19, 13, 15);
+	struct mat_matrix_16b *c = mat_matrix_alloc_16b(5, 13, 12);
+	struct mat_matrix_16b *c_ref = mat_matrix_alloc_16b(5, 13, 12);
+
+	(void)state;
+
+	srand(1);
+	fill_random_16b(a);
+	fill_random_16b(b);
+	assert_int_equal(mat_multiply(a, b, c), 0);
+	ref_multiply_16b(a, b, c_ref);
+	assert_memory_equal(c->data, c_ref->data, sizeof(int16_t) * 5 * 13);
+
+	/* Q0 data */
+	a->fractions = 0;
+	b->fractions = 0;
+	c->fractions = 0;
+	c_ref->fractions = 0;
+	assert_int_equal(mat_multiply(a, b, c), 0);
+	ref_multiply_16b(a, b, c_ref);
+	assert_memory_equal(c->data, c_ref->data, sizeof(int16_t) * 5 * 13);
+
+	assert_int_equal(mat_multiply(b, a, c), -EINVAL);
+
+	free(a);
+	free(b);
+	free(c);
+	free(c_ref);
+}
+
+static void test_matrix_mult_32x16(void **state)
+{
+	struct mat_matrix_32b *a = mat_matrix_alloc_32b(3, 23, 27);
+	struct mat_matrix_16b *b = mat_matrix_alloc_16b(23, 17, 15);
+	struct mat_matrix_32b *c = mat_matrix_alloc_32b(3, 17, 23);
+	struct mat_matrix_32b *c_ref = mat_matrix_alloc_32b(3, 17, 23);
+
+	(void)state;
+
+	srand(2);
+	fill_random_32b(a);
+	fill_random_16b(b);
+	assert_int_equal(mat_multiply_32x16b(a, b, c), 0);
+	ref_multiply_32x16b(a, b, c_ref);
+	assert_memory_equal(c->data, c_ref->data, sizeof(int32_t) * 3 * 17);
+
+	free(a);
+	free(b);
+	free(c);
+	free(c_ref);
+}
+
+static void test_matrix_mult_band(void **state)
+{
+	struct mat_matrix_16b *fb = mat_matrix_alloc_16b(65, 16, 15);
+	struct mat_matrix_16b *a16 = mat_matrix_alloc_16b(2, 65, 15);
+	struct mat_matrix_16b *c16 = mat_matrix_alloc_16b(2, 16, 12);
+	struct mat_matrix_16b *c16_ref = mat_matrix_alloc_16b(2, 16, 12);
+	struct mat_matrix_32b *a32 = mat_matrix_alloc_32b(2, 65, 30);
+	struct mat_matrix_32b *c32 = mat_matrix_alloc_32b(2, 16, 25);
+	struct mat_matrix_32b *c32_ref = mat_matrix_alloc_32b(2, 16, 25);
+	struct mat_band_16b *band;
+
+	(void)state;
+
+	srand(3);
+	fill_filterbank_16b(fb);
+	band = mat_band_alloc_16b(fb);
+	assert_non_null(band);
+	assert_true(band->length < 65 * 16);
+
+	fill_random_16b(a16);
+	assert_int_equal(mat_multiply_band_16b(a16, band, c16), 0);
+	ref_multiply_16b(a16, fb, c16_ref);
+	assert_memory_equal(c16->data, c16_ref->data, sizeof(int16_t) * 2 * 16);
+
+	fill_random_32b(a32);
+	assert_int_equal(mat_multiply_band_32x16b(a32, band, c32), 0);
+	ref_multiply_32x16b(a32, fb, c32_ref);
+	assert_memory_equal(c32->data, c32_ref->data, sizeof(int32_t) * 2 * 16);
+
+	free(fb);
+	free(band);
+	free(a16);
+	free(c16);
+	free(c16_ref);
+	free(a32);
+	free(c32);
+	free(c32_ref);
+}
+
+/* Not a pass criteria, reports the kernel run times for a Mel filterbank and DCT sized case */
+static void test_matrix_benchmark(void **state)
+{
+	struct mat_matrix_32b *spectra = mat_matrix_alloc_32b(1, 257, 30);
+	struct mat_matrix_16b *fb = mat_matrix_alloc_16b(257, 40, 15);
+	struct mat_matrix_32b *mel = mat_matrix_alloc_32b(1, 40, 25);
+	struct mat_matrix_16b *mel16 = mat_matrix_alloc_16b(1, 40, 7);
+	struct mat_matrix_16b *dct = mat_matrix_alloc_16b(40, 13, 15);
+	struct mat_matrix_16b *ceps = mat_matrix_alloc_16b(1, 13, 7);
+	struct mat_band_16b *band;
+	const int loops = 2000;
+	clock_t t0, t1, t2, t3, t4, t5;
+	int i;
+
+	(void)state;
+
+	srand(4);
+	fill_random_32b(spectra);
+	fill_filterbank_16b(fb);
+	fill_random_16b(mel16);
+	fill_random_16b(dct);
+	band = mat_band_alloc_16b(fb);
+	assert_non_null(band);
+
+	t0 = clock();
+	for (i = 0; i < loops; i++)
+		ref_multiply_32x16b(spectra, fb, mel);
+	t1 = clock();
+	for (i = 0; i < loops; i++)
+		mat_multiply_32x16b(spectra, fb, mel);
+	t2 = clock();
+	for (i = 0; i < loops; i++)
+		mat_multiply_band_32x16b(spectra, band, mel);
+	t3 = clock();
+	for (i = 0; i < loops; i++)
+		ref_multiply_16b(mel16, dct, ceps);
+	t4 = clock();
+	for (i = 0; i < loops; i++)
+		mat_multiply(mel16, dct, ceps);
+	t5 = clock();
+
+	printf("Filterbank 1x257x40: reference %ld, blocked %ld, band %ld clocks\n",
+	       (long)(t1 - t0), (long)(t2 - t1), (long)(t3 - t2));
+	printf("DCT 1x40x13: reference %ld, blocked %ld clocks\n",
+	       (long)(t4 - t3), (long)(t5 - t4));
+
+	free(spectra);
+	free(fb);
+	free(mel);
+	free(mel16);
+	free(dct);
+	free(ceps);
+	free(band);
+}
+
 int main(void)
 {
 	const struct CMUnitTest tests[] = {
@@ -168,6 +397,10 @@ int main(void)
 		cmocka_unit_test(test_matrix_mult_16_test2),
 		cmocka_unit_test(test_matrix_mult_16_test3),
 		cmocka_unit_test(test_matrix_mult_16_test4),
+		cmocka_unit_test(test_matrix_mult_16_blocked),
+		cmocka_unit_test(test_matrix_mult_32x16),
+		cmocka_unit_test(test_matrix_mult_band),
+		cmocka_unit_test(test_matrix_benchmark),
 	};
 
 	cmocka_set_message_output(CM_OUTPUT_TAP);
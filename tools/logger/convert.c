@@ -14,6 +14,9 @@
 #include <errno.h>
 #include <unistd.h>
 #include <math.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sof/lib/uuid.h>
 #include <time.h>
 #include <user/abi_dbg.h>
@@ -43,30 +46,130 @@ struct ldc_entry_header {
 	uint32_t text_len;
 };
 
-/** Dictionary entry + unformatted parameters */
+/** How a log parameter is passed to printf */
+enum ldc_param_type {
+	LDC_PARAM_RAW,		/* value passed unmodified */
+	LDC_PARAM_STRING,	/* %s, only the address can be printed */
+	LDC_PARAM_UUID,		/* %pUx, uuid entry address printed as uuid string */
+	LDC_PARAM_ENTRY,	/* %pQ, log entry address printed as entry text */
+};
+
+/** Dictionary entry, parsed once from the mapped .ldc file and cached.
+ * The format string is pre-processed so printing an entry only needs
+ * its parameters substituted.
+ */
 struct ldc_entry {
 	struct ldc_entry_header header;
-	char *file_name;
-	char *text;
-	uint32_t *params;
+	uint32_t address;
+	char *file_name;	/* source file name */
+	const char *location;	/* file name shortened for output, in location_buf */
+	char location_buf[TRACE_MAX_FILENAME_LEN + 1];
+	char *text;		/* unmodified text, printed by %pQ */
+	char *fmt;		/* text with %pU and %pQ replaced by %s */
+	uint8_t param_type[TRACE_MAX_PARAMS_COUNT];
+	bool uuid_be[TRACE_MAX_PARAMS_COUNT];
+	bool uuid_upper[TRACE_MAX_PARAMS_COUNT];
 };
 
-/** Dictionary entry + formatted parameters */
-struct proc_ldc_entry {
-	int subst_mask;
-	struct ldc_entry_header header;
-	char *file_name;
-	char *text;
-	uintptr_t params[TRACE_MAX_PARAMS_COUNT];
+/** Mapped .ldc file and the address keyed cache of parsed entries */
+struct ldc_dict {
+	const uint8_t *map;
+	size_t size;
+	pthread_mutex_t lock;		/* protects the cache against decoding jobs */
+	struct ldc_entry **slots;	/* open addressing, linear probing */
+	uint32_t slot_count;		/* power of two */
+	uint32_t entry_count;
+};
+
+/** Decoding state carried from one log statement to the next */
+struct logger_state {
+	FILE *out_fd;			/* NULL to only advance the state */
+	uint64_t last_timestamp;
+	uint64_t timestamp_origin;
+	int entry_number;
+	bool ldc_address_OK;
+	unsigned int skipped_dwords;
+	/* mapped input file, NULL when reading from a stream */
+	const uint8_t *map;
+	size_t pos;
+	size_t size;
+};
+
+/** One chunk of a mapped input file decoded by its own thread */
+struct logger_job {
+	pthread_t thread;
+	bool started;
+	struct logger_state st;
+	size_t stop;
+	char *out;
+	size_t out_size;
+	int ret;
+};
+
+/*
+ * Indexed binary output (-b): a logger_idx_header, then blocks of valid
+ * statements in the trace format, each behind a logger_idx_block with its
+ * timestamp range and component and level masks. A copy of all block
+ * headers and a logger_idx_trailer end the file, so queries can skip the
+ * blocks that do not match without decoding them. A file cut before the
+ * trailer can still be walked block by block.
+ */
+#define LOGGER_IDX_SIG		"LIdx"
+#define LOGGER_IDX_SIG_SIZE	4
+#define LOGGER_IDX_VERSION	1
+#define LOGGER_IDX_BLOCK_SIZE	(64 * 1024)
+
+struct logger_idx_header {
+	char sig[LOGGER_IDX_SIG_SIZE];	/* "LIdx" */
+	uint32_t version;
+	uint32_t src_hash;		/* of the .ldc file needed to decode */
+	uint32_t reserved;
+};
+
+struct logger_idx_block {
+	uint64_t offset;	/* of the first statement in the file */
+	uint32_t size;		/* bytes of statements */
+	uint32_t count;		/* number of statements */
+	uint64_t ts_min;	/* timestamp range, in DSP ticks */
+	uint64_t ts_max;
+	uint64_t uid_mask;	/* one bit per hashed component uid */
+	uint32_t level_mask;	/* BIT(level) of every statement */
+	uint32_t reserved;
+};
+
+struct logger_idx_trailer {
+	uint64_t index_offset;	/* of block_count logger_idx_block copies */
+	uint32_t block_count;
+	char sig[LOGGER_IDX_SIG_SIZE];	/* "LIdx" */
+};
+
+/** Indexed binary output being written */
+struct logger_idx_writer {
+	uint64_t offset;		/* bytes written to the file */
+	struct logger_idx_block block;	/* block being filled */
+	uint8_t data[LOGGER_IDX_BLOCK_SIZE];
+	struct logger_idx_block *index;
+	uint32_t block_count;
+	uint32_t index_slots;
 };
 
 #define BAD_PTR_STR "<bad uid ptr 0x%.8x>"
 #define UUID_LOWER "%s%s%s<%08x-%04x-%04x-%02x%02x-%02x%02x%02x%02x%02x%02x>%s%s%s"
 #define UUID_UPPER "%s%s%s<%08X-%04X-%04X-%02X%02X-%02X%02X%02X%02X%02X%02X>%s%s%s"
 
+#define LDC_CACHE_MIN_SLOTS	256
+#define LOGGER_JOB_CHUNK_SIZE	(4 * 1024 * 1024)
+
 static const char *missing = "<missing>";
 
-static int read_entry_from_ldc_file(struct ldc_entry *entry, uint32_t log_entry_address);
+static struct ldc_dict ldc = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static struct logger_idx_writer *idx_writer;
+static uint64_t query_uid_mask;
+
+static struct ldc_entry *ldc_entry_get(uint32_t address, int *err);
 
 char *format_uid_raw(const struct sof_uuid_entry *uid_entry, int use_colors, int name_first,
 		     bool be, bool upper)
@@ -142,82 +245,52 @@ static const char *format_uid(uint32_t uid_ptr, int use_colors, bool be, bool up
 	return str;
 }
 
-/* fmt should point '%pUx`, return pointer to UUID string or zero */
-static const char *asprintf_uuid(const char *fmt, uint32_t uuid_key, bool use_colors, int *fmt_len)
+/* fmt should point '%pUx`, return length of the specifier and its 'x' flags */
+static int uuid_fmt_len(const char *fmt, bool *be, bool *upper)
 {
 	const char *fmt_end = fmt + strlen(fmt);
-	int be, upper;
 	int len = 4; /* assure full formating, with x */
 
-	if (fmt + 2 >= fmt_end || fmt[1] != 'p' || fmt[2] != 'U') {
-		*fmt_len = 0;
-		return NULL;
-	}
 	/* check 'x' value */
 	switch (fmt + 3 < fmt_end ? fmt[3] : 0) {
 	case 'b':
-		be = 1;
-		upper = 0;
+		*be = true;
+		*upper = false;
 		break;
 	case 'B':
-		be = 1;
-		upper = 1;
+		*be = true;
+		*upper = true;
 		break;
 	case 'l':
-		be = 0;
-		upper = 0;
+		*be = false;
+		*upper = false;
 		break;
 	case 'L':
-		be = 0;
-		upper = 1;
+		*be = false;
+		*upper = true;
 		break;
 	default:
-		be = 0;
-		upper = 0;
+		*be = false;
+		*upper = false;
 		--len;
 		break;
 	}
-	*fmt_len = len;
-	return format_uid(uuid_key, use_colors, be, upper);
-}
-
-static const char *asprintf_entry_text(uint32_t entry_address)
-{
-	struct ldc_entry entry;
-	int ret;
-
-	ret = read_entry_from_ldc_file(&entry, entry_address);
-	if (ret)
-		return NULL;
-
-	free(entry.file_name);
-
-	return entry.text;
+	return len;
 }
 
-/** printf-like formatting from the binary ldc_entry input to the
- *  formatted proc_lpc_entry output. Also copies the unmodified
- *  ldc_entry_header from input to output.
+/** printf-like pre-processing of the dictionary entry text, done once
+ *  per entry. Records how each parameter has to be substituted and
+ *  rewrites the %pU and %pQ specifiers to %s in e->fmt.
  *
- * @param[out] pe copy of the header + formatted output
- * @param[in] e copy of the dictionary entry where unformatted,
-    uint32_t params have been inserted.
-   @param[in] use_colors whether to use ANSI terminal codes
-*/
-static void process_params(struct proc_ldc_entry *pe,
-			   const struct ldc_entry *e,
-			   int use_colors)
+ * @param[in,out] e dictionary entry, e->fmt is a copy of e->text
+ */
+static void ldc_entry_tokenize(struct ldc_entry *e)
 {
-	char *p = e->text;
-	const char *t_end = p + strlen(e->text);
-	int uuid_fmt_len;
+	char *p = e->fmt;
+	const char *t_end = p + strlen(e->fmt);
+	int uuid_fmt;
 	int i = 0;
 
-	pe->subst_mask = 0;
-	pe->header =  e->header;
-	pe->file_name = e->file_name;
-	pe->text = e->text;
-
 	/*
 	 * Scan the text for possible replacements. We follow the Linux kernel
 	 * that uses %pUx formats for UUID / GUID printing, where 'x' is
@@ -225,15 +298,12 @@ static void process_params(struct proc_ldc_entry *pe,
 	 * For decoding log entry text from pointer %pQ is used.
 	 */
 	while ((p = strchr(p, '%'))) {
-		uint32_t raw_param;
-
-		if (i >= e->header.params_num) {
-			/* Don't read e->params[] out of bounds. */
+		if (i >= e->header.params_num || i >= TRACE_MAX_PARAMS_COUNT) {
+			/* Don't read params[] out of bounds. */
 			log_err("Too many %% conversion specifiers in '%s'\n",
-				e->text);
+				e->fmt);
 			break;
 		}
-		raw_param = e->params[i];
 
 		/* % can't be the last char */
 		if (p + 1 >= t_end) {
@@ -249,37 +319,22 @@ static void process_params(struct proc_ldc_entry *pe,
 			/* %s format specifier */
 			/* check for string printing, because it leads to logger crash */
 			log_err("String printing is not supported\n");
-			pe->params[i] = (uintptr_t)log_asprintf("<String @ 0x%08x>", raw_param);
-			if (!pe->params[i])
-				abort();
-			pe->subst_mask |= 1 << i;
-			++i;
+			e->param_type[i++] = LDC_PARAM_STRING;
 			p += 2;
 		} else if (p + 2 < t_end && p[1] == 'p' && p[2] == 'U') {
 			/* %pUx format specifier */
-			/* substitute UUID entry address with formatted string pointer from heap */
-			pe->params[i] = (uintptr_t)asprintf_uuid(p, raw_param, use_colors,
-								 &uuid_fmt_len);
-			if (!pe->params[i])
-				abort();
-			pe->subst_mask |= 1 << i;
-			++i;
+			/* substitute UUID entry address with formatted string */
+			uuid_fmt = uuid_fmt_len(p, &e->uuid_be[i], &e->uuid_upper[i]);
+			e->param_type[i++] = LDC_PARAM_UUID;
 			/* replace uuid formatter with %s */
 			p[1] = 's';
-			memmove(&p[2], &p[uuid_fmt_len], (int)(t_end - &p[uuid_fmt_len]) + 1);
-			p += uuid_fmt_len - 2;
-			t_end -= uuid_fmt_len - 2;
+			memmove(&p[2], &p[uuid_fmt], (int)(t_end - &p[uuid_fmt]) + 1);
+			p += uuid_fmt - 2;
+			t_end -= uuid_fmt - 2;
 		} else if (p + 2 < t_end && p[1] == 'p' && p[2] == 'Q') {
 			/* %pQ format specifier */
 			/* substitute log entry address with formatted entry text */
-			pe->params[i] = (uintptr_t)asprintf_entry_text(raw_param);
-
-			if (pe->params[i])
-				pe->subst_mask |= 1 << i;
-			else
-				pe->params[i] = (uintptr_t)missing;
-
-			++i;
+			e->param_type[i++] = LDC_PARAM_ENTRY;
 
 			/* replace entry formatter with %s */
 			p[1] = 's';
@@ -290,24 +345,12 @@ static void process_params(struct proc_ldc_entry *pe,
 			/* arguments different from %pU and %pQ should be passed without
 			 * modification
 			 */
-			pe->params[i] = raw_param;
-			++i;
+			e->param_type[i++] = LDC_PARAM_RAW;
 			p += 2;
 		}
 	}
 	if (i < e->header.params_num)
-		log_err("Too few %% conversion specifiers in '%s'\n", e->text);
-}
-
-static void free_proc_ldc_entry(struct proc_ldc_entry *pe)
-{
-	int i;
-
-	for (i = 0; i < TRACE_MAX_PARAMS_COUNT; i++) {
-		if (pe->subst_mask & (1 << i))
-			free((void *)pe->params[i]);
-		pe->params[i] = 0;
-	}
+		log_err("Too few %% conversion specifiers in '%s'\n", e->fmt);
 }
 
 static double to_usecs(uint64_t time)
@@ -453,26 +496,27 @@ static char *format_file_name(char *file_name_raw, int full_name)
 	return name;
 }
 
-static int entry_number = 1;
 /** Formats and outputs one entry from the trace + the corresponding
- * ldc_entry from the dictionary passed as arguments. Expects the log
- * variables to have already been copied into the ldc_entry.
+ * ldc_entry from the dictionary passed as arguments. With a NULL
+ * st->out_fd only the timestamp state is updated.
  */
-static void print_entry_params(const struct log_entry_header *dma_log,
-			       const struct ldc_entry *entry, uint64_t last_timestamp)
+static void print_entry_params(struct logger_state *st, const struct log_entry_header *dma_log,
+			       const struct ldc_entry *entry, const uint32_t *params)
 {
-	static uint64_t timestamp_origin;
-
-	FILE *out_fd = global_config->out_fd;
+	FILE *out_fd = st->out_fd;
 	int use_colors = global_config->use_colors;
 	int raw_output = global_config->raw_output;
 	int hide_location = global_config->hide_location;
 	int time_precision = global_config->time_precision;
+	uint64_t last_timestamp = st->last_timestamp;
 
 	char ids[TRACE_MAX_IDS_STR];
 	float dt = to_usecs(dma_log->timestamp - last_timestamp);
-	struct proc_ldc_entry proc_entry;
+	uintptr_t args[TRACE_MAX_PARAMS_COUNT] = { 0 };
+	const struct ldc_entry *ref;
+	int subst_mask = 0;
 	int ret;
+	int i;
 
 	if (raw_output)
 		use_colors = 0;
@@ -482,28 +526,32 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 		dt = NAN;
 
 	if (dma_log->timestamp < last_timestamp) {
-		fprintf(out_fd,
-			"\n\t\t --- negative DELTA = %.3f us: wrap, IPC_TRACE, other? ---\n\n",
-			-to_usecs(last_timestamp - dma_log->timestamp));
-		entry_number = 1;
+		if (out_fd)
+			fprintf(out_fd,
+				"\n\t\t --- negative DELTA = %.3f us: wrap, IPC_TRACE, other? ---\n\n",
+				-to_usecs(last_timestamp - dma_log->timestamp));
+		st->entry_number = 1;
 	}
 
 	/* The first entry:
 	 *  - is never shown with a relative TIMESTAMP (to itself!?)
 	 *  - shows a zero DELTA
 	 */
-	if (entry_number == 1) {
-		entry_number++;
+	if (st->entry_number == 1) {
+		st->entry_number++;
 		/* Display absolute (and random) timestamps */
-		timestamp_origin = 0;
+		st->timestamp_origin = 0;
 		dt = 0;
-	} else if (entry_number == 2) {
-		entry_number++;
+	} else if (st->entry_number == 2) {
+		st->entry_number++;
 		if (global_config->relative_timestamps == 1)
 			/* Switch to relative timestamps from now on. */
-			timestamp_origin = last_timestamp;
+			st->timestamp_origin = last_timestamp;
 	} /* We don't need the exact entry_number after 3 */
 
+	if (!out_fd)
+		return;
+
 	if (dma_log->id_0 != INVALID_TRACE_ID &&
 	    dma_log->id_1 != INVALID_TRACE_ID)
 		sprintf(ids, "%d.%d", (dma_log->id_0 & TRACE_IDS_MASK),
@@ -523,13 +571,11 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 
 		if (time_precision >= 0)
 			fprintf(out_fd, "%.*f %.*f ",
-				time_precision, to_usecs(dma_log->timestamp - timestamp_origin),
+				time_precision, to_usecs(dma_log->timestamp - st->timestamp_origin),
 				time_precision, dt);
 
 		if (!hide_location)
-			fprintf(out_fd, "(%s:%u) ",
-				format_file_name(entry->file_name, raw_output),
-				entry->header.line_idx);
+			fprintf(out_fd, "(%s:%u) ", entry->location, entry->header.line_idx);
 	} else {
 		if (time_precision >= 0) {
 			const uint8_t ts_width = timestamp_width(time_precision);
@@ -537,7 +583,7 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 			fprintf(out_fd, "%s[%*.*f] (%*.*f)%s ",
 				use_colors ? KGRN : "",
 				ts_width, time_precision,
-				to_usecs(dma_log->timestamp - timestamp_origin),
+				to_usecs(dma_log->timestamp - st->timestamp_origin),
 				ts_width, time_precision, dt,
 				use_colors ? KNRM : "");
 		}
@@ -554,9 +600,7 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 
 		/* location */
 		if (!hide_location)
-			fprintf(out_fd, "%24s:%-4u ",
-				format_file_name(entry->file_name, raw_output),
-				entry->header.line_idx);
+			fprintf(out_fd, "%24s:%-4u ", entry->location, entry->header.line_idx);
 
 		/* level name */
 		fprintf(out_fd, "%s%s",
@@ -564,126 +608,432 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 			get_level_name(entry->header.level));
 	}
 
-	/* Minimal, printf-like formatting */
-	process_params(&proc_entry, entry, use_colors);
+	/* Substitute the parameters as found by ldc_entry_tokenize() */
+	for (i = 0; i < entry->header.params_num; i++) {
+		switch (entry->param_type[i]) {
+		case LDC_PARAM_STRING:
+			args[i] = (uintptr_t)log_asprintf("<String @ 0x%08x>", params[i]);
+			if (!args[i])
+				abort();
+			subst_mask |= 1 << i;
+			break;
+		case LDC_PARAM_UUID:
+			/* substitute UUID entry address with formatted string pointer from heap */
+			args[i] = (uintptr_t)format_uid(params[i], use_colors, entry->uuid_be[i],
+							entry->uuid_upper[i]);
+			if (!args[i])
+				abort();
+			subst_mask |= 1 << i;
+			break;
+		case LDC_PARAM_ENTRY:
+			/* substitute log entry address with the cached entry text */
+			ref = ldc_entry_get(params[i], &ret);
+			args[i] = (uintptr_t)(ref ? ref->text : missing);
+			break;
+		default:
+			args[i] = params[i];
+			break;
+		}
+	}
 
-	switch (proc_entry.header.params_num) {
+	switch (entry->header.params_num) {
 	case 0:
-		ret = fprintf(out_fd, "%s", proc_entry.text);
+		ret = fprintf(out_fd, "%s", entry->fmt);
 		break;
 	case 1:
-		ret = fprintf(out_fd, proc_entry.text, proc_entry.params[0]);
+		ret = fprintf(out_fd, entry->fmt, args[0]);
 		break;
 	case 2:
-		ret = fprintf(out_fd, proc_entry.text, proc_entry.params[0], proc_entry.params[1]);
+		ret = fprintf(out_fd, entry->fmt, args[0], args[1]);
 		break;
 	case 3:
-		ret = fprintf(out_fd, proc_entry.text, proc_entry.params[0], proc_entry.params[1],
-			      proc_entry.params[2]);
+		ret = fprintf(out_fd, entry->fmt, args[0], args[1], args[2]);
 		break;
 	case 4:
-		ret = fprintf(out_fd, proc_entry.text, proc_entry.params[0], proc_entry.params[1],
-			      proc_entry.params[2], proc_entry.params[3]);
+		ret = fprintf(out_fd, entry->fmt, args[0], args[1], args[2], args[3]);
 		break;
 	default:
-		log_err("Unsupported number of arguments for '%s'", proc_entry.text);
+		log_err("Unsupported number of arguments for '%s'", entry->fmt);
 		ret = 0; /* don't log ferror */
 		break;
 	}
-	free_proc_ldc_entry(&proc_entry);
+	for (i = 0; i < TRACE_MAX_PARAMS_COUNT; i++)
+		if (subst_mask & (1 << i))
+			free((void *)args[i]);
 	/* log format text comes from ldc file (may be invalid), so error check is needed here */
 	if (ret < 0)
 		log_err("trace fprintf failed for '%s', %d '%s'",
-			proc_entry.text, ferror(out_fd), strerror(ferror(out_fd)));
+			entry->fmt, ferror(out_fd), strerror(ferror(out_fd)));
 	fprintf(out_fd, "%s\n", use_colors ? KNRM : "");
-	fflush(out_fd);
+	/* a mapped input file is not followed live, leave buffering to stdio */
+	if (!st->map)
+		fflush(out_fd);
+}
+
+/* find slot of the entry at address, or the empty slot where it belongs */
+static uint32_t ldc_cache_slot(struct ldc_entry **slots, uint32_t slot_count, uint32_t address)
+{
+	uint32_t mask = slot_count - 1;
+	uint32_t i = ((address >> 2) * 2654435761u) & mask;
+
+	while (slots[i] && slots[i]->address != address)
+		i = (i + 1) & mask;
+
+	return i;
+}
+
+static int ldc_cache_grow(void)
+{
+	uint32_t slot_count = ldc.slot_count ? ldc.slot_count * 2 : LDC_CACHE_MIN_SLOTS;
+	struct ldc_entry **slots;
+	uint32_t i;
+
+	slots = calloc(slot_count, sizeof(*slots));
+	if (!slots) {
+		log_err("can't allocate %u dictionary cache slots\n", slot_count);
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < ldc.slot_count; i++)
+		if (ldc.slots[i])
+			slots[ldc_cache_slot(slots, slot_count, ldc.slots[i]->address)] =
+				ldc.slots[i];
+
+	free(ldc.slots);
+	ldc.slots = slots;
+	ldc.slot_count = slot_count;
+
+	return 0;
+}
+
+static void ldc_entry_free(struct ldc_entry *entry)
+{
+	free(entry->file_name);
+	free(entry->text);
+	free(entry->fmt);
+	free(entry);
+}
+
+static char *ldc_strdup(const uint8_t *src, uint32_t len)
+{
+	char *str = malloc(len + 1);
+
+	if (str) {
+		memcpy(str, src, len);
+		str[len] = '\0';
+	}
+
+	return str;
 }
 
-static int read_entry_from_ldc_file(struct ldc_entry *entry, uint32_t log_entry_address)
+/** Parses the dictionary entry at log_entry_address from the mapped .ldc file */
+static struct ldc_entry *ldc_entry_parse(uint32_t log_entry_address, int *err)
 {
 	uint32_t base_address = global_config->logs_header->base_address;
 	uint32_t data_offset = global_config->logs_header->data_offset;
-
-	int ret;
+	struct ldc_entry *entry;
+	const uint8_t *src;
 
 	/* evaluate entry offset in input file */
-	uint32_t entry_offset = (log_entry_address - base_address) + data_offset;
+	size_t entry_offset = (size_t)(log_entry_address - base_address) + data_offset;
 
-	entry->file_name = NULL;
-	entry->text = NULL;
-	entry->params = NULL;
-
-	/* set file position to beginning of processed entry */
-	ret = fseek(global_config->ldc_fd, entry_offset, SEEK_SET);
-	if (ret) {
-		log_err("Failed to seek to entry header for offset 0x%x in dictionary.\n",
+	if (entry_offset + sizeof(entry->header) > ldc.size) {
+		log_err("Failed to read entry header for offset 0x%zx in dictionary.\n",
 			entry_offset);
-		ret = -errno;
-		goto out;
+		*err = -EINVAL;
+		return NULL;
 	}
 
-	/* fetching elf header params */
-	ret = fread(&entry->header, sizeof(entry->header), 1, global_config->ldc_fd);
-	if (ret != 1) {
-		log_err("Failed to read entry header for offset 0x%x in dictionary.\n",
-			entry_offset);
-		ret = -1;
-		goto out;
+	entry = calloc(1, sizeof(*entry));
+	if (!entry) {
+		log_err("can't allocate dictionary entry\n");
+		*err = -ENOMEM;
+		return NULL;
 	}
+
+	/* fetching elf header params */
+	src = ldc.map + entry_offset;
+	memcpy(&entry->header, src, sizeof(entry->header));
+	entry->address = log_entry_address;
+	src += sizeof(entry->header);
+
 	if (entry->header.file_name_len > TRACE_MAX_FILENAME_LEN) {
 		log_err("Invalid filename length %d or ldc file does not match firmware\n",
 			entry->header.file_name_len);
-		ret = -EINVAL;
-		goto out;
+		*err = -EINVAL;
+		goto err;
 	}
-	entry->file_name = (char *)malloc(entry->header.file_name_len + 1);
 
-	if (!entry->file_name) {
-		log_err("can't allocate %d byte for entry.file_name\n",
-			entry->header.file_name_len);
-		ret = -ENOMEM;
-		goto out;
+	/* fetching text */
+	if (entry->header.text_len > TRACE_MAX_TEXT_LEN) {
+		log_err("Invalid text length.\n");
+		*err = -EINVAL;
+		goto err;
 	}
 
-	ret = fread(entry->file_name, sizeof(char), entry->header.file_name_len,
-		    global_config->ldc_fd);
-	entry->file_name[entry->header.file_name_len] = '\0';
-
-	if (ret != entry->header.file_name_len) {
-		log_err("Failed to read source filename for offset 0x%x in dictionary.\n",
+	if (src + entry->header.file_name_len + entry->header.text_len > ldc.map + ldc.size) {
+		log_err("Failed to read log message at offset 0x%zx from dictionary.\n",
 			entry_offset);
-		ret = -1;
-		goto out;
+		*err = -EINVAL;
+		goto err;
 	}
 
-	/* fetching text */
-	if (entry->header.text_len > TRACE_MAX_TEXT_LEN) {
-		log_err("Invalid text length.\n");
-		ret = -EINVAL;
-		goto out;
+	entry->file_name = ldc_strdup(src, entry->header.file_name_len);
+	src += entry->header.file_name_len;
+	entry->text = ldc_strdup(src, entry->header.text_len);
+	entry->fmt = ldc_strdup(src, entry->header.text_len);
+	if (!entry->file_name || !entry->text || !entry->fmt) {
+		log_err("can't allocate strings of dictionary entry 0x%x\n", log_entry_address);
+		*err = -ENOMEM;
+		goto err;
 	}
-	entry->text = (char *)malloc(entry->header.text_len + 1);
-	if (!entry->text) {
-		log_err("can't allocate %d byte for entry.text\n", entry->header.text_len);
-		ret = -ENOMEM;
-		goto out;
+
+	memcpy(entry->location_buf, entry->file_name, entry->header.file_name_len + 1);
+	entry->location = format_file_name(entry->location_buf, global_config->raw_output);
+	ldc_entry_tokenize(entry);
+
+	return entry;
+
+err:
+	ldc_entry_free(entry);
+	return NULL;
+}
+
+/** Returns the cached dictionary entry at log_entry_address, parsing it
+ * from the mapped .ldc file on first use.
+ */
+static struct ldc_entry *ldc_entry_get(uint32_t log_entry_address, int *err)
+{
+	struct ldc_entry *entry;
+	uint32_t slot;
+
+	pthread_mutex_lock(&ldc.lock);
+
+	if (ldc.slot_count) {
+		slot = ldc_cache_slot(ldc.slots, ldc.slot_count, log_entry_address);
+		entry = ldc.slots[slot];
+		if (entry)
+			goto out;
 	}
-	ret = fread(entry->text, sizeof(char), entry->header.text_len, global_config->ldc_fd);
-	if (ret != entry->header.text_len) {
-		log_err("Failed to read log message at offset 0x%x from dictionary.\n",
-			entry_offset);
-		ret = -1;
+
+	entry = ldc_entry_parse(log_entry_address, err);
+	if (!entry)
 		goto out;
+
+	/* keep the load factor under a half */
+	if (2 * (ldc.entry_count + 1) > ldc.slot_count) {
+		*err = ldc_cache_grow();
+		if (*err) {
+			ldc_entry_free(entry);
+			entry = NULL;
+			goto out;
+		}
+	}
+
+	ldc.slots[ldc_cache_slot(ldc.slots, ldc.slot_count, log_entry_address)] = entry;
+	ldc.entry_count++;
+out:
+	pthread_mutex_unlock(&ldc.lock);
+
+	return entry;
+}
+
+static void ldc_cache_free(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < ldc.slot_count; i++)
+		if (ldc.slots[i])
+			ldc_entry_free(ldc.slots[i]);
+
+	free(ldc.slots);
+	ldc.slots = NULL;
+	ldc.slot_count = 0;
+	ldc.entry_count = 0;
+}
+
+static uint64_t logger_idx_uid_bit(uint32_t uid)
+{
+	return 1ULL << ((uint32_t)((uid >> 2) * 2654435761u) >> 26);
+}
+
+/** Statement filter from the -w, -C and -V options */
+static bool logger_query_match(const struct log_entry_header *dma_log,
+			       const struct ldc_entry *entry)
+{
+	double ts;
+
+	if (global_config->query_level && entry->header.level > global_config->query_level)
+		return false;
+
+	if (global_config->query_comp &&
+	    strcmp(get_component_name(entry->header.component_class, dma_log->uid),
+		   global_config->query_comp))
+		return false;
+
+	ts = to_usecs(dma_log->timestamp);
+
+	return ts >= global_config->query_begin && ts <= global_config->query_end;
+}
+
+/** Block filter, true if the block may have statements matching the query */
+static bool logger_query_block(const struct logger_idx_block *block)
+{
+	if (global_config->query_level &&
+	    !(block->level_mask & ((2 << global_config->query_level) - 1)))
+		return false;
+
+	if (global_config->query_comp && !(block->uid_mask & query_uid_mask))
+		return false;
+
+	return to_usecs(block->ts_max) >= global_config->query_begin &&
+	       to_usecs(block->ts_min) <= global_config->query_end;
+}
+
+/* mask of the uids having the -C component name, to test against blocks */
+static void logger_query_init(void)
+{
+	const struct snd_sof_uids_header *uids_dict = global_config->uids_dict;
+	const struct sof_uuid_entry *uid_entry;
+	uint32_t count = uids_dict->data_length / sizeof(*uid_entry);
+	uint32_t i;
+
+	if (!global_config->query_comp)
+		return;
+
+	/* uid 0 is shown as "unknown", see get_component_name() */
+	if (!strcmp(global_config->query_comp, "unknown"))
+		query_uid_mask |= logger_idx_uid_bit(0);
+
+	uid_entry = (const struct sof_uuid_entry *)
+		    ((const uint8_t *)uids_dict + uids_dict->data_offset);
+	for (i = 0; i < count; i++)
+		if (!strncmp(uid_entry[i].name, global_config->query_comp, UUID_NAME_MAX_LEN))
+			query_uid_mask |= logger_idx_uid_bit(get_uuid_key(&uid_entry[i]));
+}
+
+static int logger_idx_write(const void *data, size_t size)
+{
+	if (fwrite(data, size, 1, global_config->index_fd) != 1) {
+		log_err("failed to write %s: %s\n", global_config->index_file,
+			strerror(errno));
+		return -EIO;
+	}
+
+	idx_writer->offset += size;
+	return 0;
+}
+
+/* write out the block being filled and add it to the index */
+static int logger_idx_flush(void)
+{
+	struct logger_idx_writer *w = idx_writer;
+	struct logger_idx_block *index;
+	int ret;
+
+	if (!w->block.count)
+		return 0;
+
+	if (w->block_count == w->index_slots) {
+		w->index_slots = w->index_slots ? w->index_slots * 2 : 64;
+		index = realloc(w->index, w->index_slots * sizeof(*index));
+		if (!index) {
+			log_err("can't allocate index of %u blocks\n", w->index_slots);
+			return -ENOMEM;
+		}
+		w->index = index;
+	}
+
+	w->block.offset = w->offset + sizeof(w->block);
+	ret = logger_idx_write(&w->block, sizeof(w->block));
+	if (ret)
+		return ret;
+
+	ret = logger_idx_write(w->data, w->block.size);
+	if (ret)
+		return ret;
+
+	/* a live trace is followed by the reader block by block */
+	if (global_config->trace)
+		fflush(global_config->index_fd);
+
+	w->index[w->block_count++] = w->block;
+	memset(&w->block, 0, sizeof(w->block));
+
+	return 0;
+}
+
+/** Appends one statement with its parameters to the indexed binary output */
+static int logger_idx_add(const struct log_entry_header *dma_log,
+			  const struct ldc_entry *entry, const uint32_t *params)
+{
+	struct logger_idx_writer *w = idx_writer;
+	size_t params_size = sizeof(uint32_t) * entry->header.params_num;
+	struct logger_idx_block *block = &w->block;
+	int ret;
+
+	if (block->size + sizeof(*dma_log) + params_size > sizeof(w->data)) {
+		ret = logger_idx_flush();
+		if (ret)
+			return ret;
 	}
-	entry->text[entry->header.text_len] = '\0';
+
+	if (!block->count || dma_log->timestamp < block->ts_min)
+		block->ts_min = dma_log->timestamp;
+	if (!block->count || dma_log->timestamp > block->ts_max)
+		block->ts_max = dma_log->timestamp;
+	block->uid_mask |= logger_idx_uid_bit(dma_log->uid);
+	block->level_mask |= 1 << (entry->header.level & 31);
+	block->count++;
+
+	memcpy(w->data + block->size, dma_log, sizeof(*dma_log));
+	block->size += sizeof(*dma_log);
+	memcpy(w->data + block->size, params, params_size);
+	block->size += params_size;
 
 	return 0;
+}
+
+static int logger_idx_open(void)
+{
+	struct logger_idx_header header = {
+		.version = LOGGER_IDX_VERSION,
+		.src_hash = global_config->logs_header->version.src_hash,
+	};
+
+	memcpy(header.sig, LOGGER_IDX_SIG, LOGGER_IDX_SIG_SIZE);
+	idx_writer = calloc(1, sizeof(*idx_writer));
+	if (!idx_writer) {
+		log_err("can't allocate index writer\n");
+		return -ENOMEM;
+	}
+
+	return logger_idx_write(&header, sizeof(header));
+}
+
+/* write the last block, the index and the trailer */
+static int logger_idx_close(void)
+{
+	struct logger_idx_writer *w = idx_writer;
+	struct logger_idx_trailer trailer;
+	int ret;
+
+	memcpy(trailer.sig, LOGGER_IDX_SIG, LOGGER_IDX_SIG_SIZE);
+	ret = logger_idx_flush();
+	if (ret)
+		goto out;
+
+	trailer.index_offset = w->offset;
+	trailer.block_count = w->block_count;
+	ret = logger_idx_write(w->index, w->block_count * sizeof(*w->index));
+	if (ret)
+		goto out;
 
+	ret = logger_idx_write(&trailer, sizeof(trailer));
 out:
-	free(entry->text);
-	entry->text = NULL;
-	free(entry->file_name);
-	entry->file_name = NULL;
+	free(w->index);
+	free(w);
+	idx_writer = NULL;
 
 	return ret;
 }
@@ -693,68 +1043,77 @@ out:
  * and passes everything to print_entry_params() to finish processing
  * this log entry. So not just "fetch" but everything else after it too.
  *
+ * @param[in,out] st decoding state, last_timestamp is updated
  * @param[in] dma_log protocol header from any trace (not just from the
  * "DMA" trace)
- * @param[in,out] last_timestamp timestamp found for this entry
  */
-static int fetch_entry(const struct log_entry_header *dma_log, uint64_t *last_timestamp)
+static int fetch_entry(struct logger_state *st, const struct log_entry_header *dma_log)
 {
-	struct ldc_entry entry;
+	uint32_t params[TRACE_MAX_PARAMS_COUNT];
+	struct ldc_entry *entry;
+	size_t size;
 	int ret;
 
-	ret = read_entry_from_ldc_file(&entry, dma_log->log_entry_address);
-	if (ret < 0) {
-		log_err("read_entry_from_ldc_file(0x%x) returned %d\n",
+	entry = ldc_entry_get(dma_log->log_entry_address, &ret);
+	if (!entry) {
+		log_err("ldc_entry_get(0x%x) returned %d\n",
 			dma_log->log_entry_address, ret);
-		goto out;
+		return ret;
 	}
 
 	/* fetching entry params from dma dump */
-	if (entry.header.params_num > TRACE_MAX_PARAMS_COUNT) {
+	if (entry->header.params_num > TRACE_MAX_PARAMS_COUNT) {
 		log_err("Invalid number of parameters.\n");
-		ret = -EINVAL;
-		goto out;
-	}
-	entry.params = (uint32_t *)malloc(sizeof(uint32_t) * entry.header.params_num);
-	if (!entry.params) {
-		log_err("can't allocate %d byte for entry.params\n",
-			(int)(sizeof(uint32_t) * entry.header.params_num));
-		ret = -ENOMEM;
-		goto out;
+		return -EINVAL;
 	}
-
-	if (global_config->serial_fd < 0) {
-		ret = fread(entry.params, sizeof(uint32_t), entry.header.params_num,
+	size = sizeof(uint32_t) * entry->header.params_num;
+
+	if (st->map) {
+		if (size > st->size - st->pos) {
+			if (st->out_fd) {
+				fprintf(st->out_fd,
+					"warn: failed to fread() %d params from the log for %s:%d\n",
+					entry->header.params_num,
+					entry->file_name, entry->header.line_idx);
+				fprintf(st->out_fd,
+					"warn: log's End Of File. Device suspend?\n");
+			}
+			st->pos = st->size;
+			return 0;
+		}
+		memcpy(params, st->map + st->pos, size);
+		st->pos += size;
+	} else if (global_config->serial_fd < 0) {
+		ret = fread(params, sizeof(uint32_t), entry->header.params_num,
 			    global_config->in_fd);
-		if (ret != entry.header.params_num) {
-			fprintf(global_config->out_fd,
+		if (ret != entry->header.params_num) {
+			fprintf(st->out_fd,
 				"warn: failed to fread() %d params from the log for %s:%d\n",
-				entry.header.params_num,
-				entry.file_name, entry.header.line_idx);
+				entry->header.params_num,
+				entry->file_name, entry->header.line_idx);
 
 			ret = ferror(global_config->in_fd) ? -1 : 0;
 
 			if (feof(global_config->in_fd))
-				fprintf(global_config->out_fd,
+				fprintf(st->out_fd,
 					"warn: log's End Of File. Device suspend?\n");
 
-			goto out;
+			return ret;
 		}
 	} else { /* serial */
-		size_t size = sizeof(uint32_t) * entry.header.params_num;
 		uint8_t *n;
 
 		/* Repeatedly read() how much we still miss until we got
 		 * enough for the number of params needed by this
 		 * particular statement.
 		 */
-		for (n = (uint8_t *)entry.params; size; n += ret, size -= ret) {
+		for (n = (uint8_t *)params; size; n += ret, size -= ret) {
 			ret = read(global_config->serial_fd, n, size);
 			if (ret < 0) {
 				ret = -errno;
 				log_err("Failed to fread %d params from serial: %s\n",
-					entry.header.params_num, strerror(errno));
-				goto out;
+					entry->header.params_num, strerror(errno));
+				return ret;
 			}
 			if (ret != size)
 				log_err("Partial read of %u bytes of %zu, reading more\n",
@@ -762,24 +1121,23 @@ static int fetch_entry(const struct log_entry_header *dma_log, uint64_t *last_ti
 		}
 	} /* serial */
 
-	/* printing entry content */
-	print_entry_params(dma_log, &entry, *last_timestamp);
-	*last_timestamp = dma_log->timestamp;
+	if (!logger_query_match(dma_log, entry))
+		return 0;
 
-	/* set f_ldc file position to the beginning */
-	rewind(global_config->ldc_fd);
-
-	ret = 0;
-out:
-	/* free alocated memory */
-	free(entry.params);
-	free(entry.text);
-	free(entry.file_name);
+	if (idx_writer) {
+		ret = logger_idx_add(dma_log, entry, params);
+		if (ret)
+			return ret;
+	} else {
+		/* printing entry content */
+		print_entry_params(st, dma_log, entry, params);
+	}
+	st->last_timestamp = dma_log->timestamp;
 
-	return ret;
+	return 0;
 }
 
-static int serial_read(uint64_t *last_timestamp)
+static int serial_read(struct logger_state *st)
 {
 	struct log_entry_header dma_log;
 	size_t len;
@@ -829,30 +1187,272 @@ static int serial_read(uint64_t *last_timestamp)
 	/* fetching entry from elf dump and complete processing this log
 	 * line
 	 */
-	return fetch_entry(&dma_log, last_timestamp);
+	return fetch_entry(st, &dma_log);
+}
+
+/** Decodes the log statements of a mapped input file from st->pos on,
+ * up to the first statement starting at or after stop.
+ */
+static int logger_read_map(struct logger_state *st, size_t stop)
+{
+	const struct snd_sof_logs_header *logs_header = global_config->logs_header;
+	struct log_entry_header dma_log;
+	int ret;
+
+	while (st->pos < stop) {
+		/* EOF, the rest is too short for an entry */
+		if (st->size - st->pos < sizeof(dma_log)) {
+			st->pos = st->size;
+			break;
+		}
+		memcpy(&dma_log, st->map + st->pos, sizeof(dma_log));
+
+		/* same resynchronization as in logger_read() */
+		if (dma_log.log_entry_address < logs_header->base_address ||
+		    dma_log.log_entry_address > logs_header->base_address +
+		    logs_header->data_length) {
+			st->ldc_address_OK = false;
+			st->pos += sizeof(uint32_t);
+			st->skipped_dwords++;
+			continue;
+		} else if (!st->ldc_address_OK) {
+			if (st->skipped_dwords != 0 && st->out_fd) {
+				fprintf(st->out_fd,
+					"\nFound valid LDC address after skipping %zu bytes (one line uses %zu + 0 to 16 bytes)\n",
+				       sizeof(uint32_t) * st->skipped_dwords, sizeof(dma_log));
+			}
+
+			st->ldc_address_OK = true;
+			st->skipped_dwords = 0;
+		}
+		st->pos += sizeof(dma_log);
+
+		ret = fetch_entry(st, &dma_log);
+		if (ret) {
+			log_err("fetch_entry() failed with: %d, aborting\n", ret);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+/* decode the statements of one block that passed logger_query_block() */
+static int logger_read_block(struct logger_state *st, const struct logger_idx_block *block)
+{
+	if (block->offset > st->size || block->size > st->size - block->offset) {
+		log_err("block at 0x%llx is beyond the end of %s\n",
+			(unsigned long long)block->offset, global_config->in_file);
+		return -EINVAL;
+	}
+
+	if (!logger_query_block(block))
+		return 0;
+
+	st->pos = block->offset;
+	return logger_read_map(st, block->offset + block->size);
+}
+
+/** Decodes a mapped indexed binary file, only the blocks whose index
+ * entry matches the query are read.
+ */
+static int logger_read_index(struct logger_state *st)
+{
+	const struct logger_idx_header *header = (const struct logger_idx_header *)st->map;
+	struct logger_idx_trailer trailer;
+	struct logger_idx_block block;
+	size_t end = st->size;
+	uint64_t offset;
+	uint32_t i;
+	int ret;
+
+	if (header->version != LOGGER_IDX_VERSION) {
+		log_err("unsupported version %u of %s\n", header->version,
+			global_config->in_file);
+		return -EINVAL;
+	}
+
+	if (header->src_hash != global_config->logs_header->version.src_hash) {
+		log_err("%s was written for an ldc file with src hash 0x%x, not 0x%x.\n",
+			global_config->in_file, header->src_hash,
+			global_config->logs_header->version.src_hash);
+		return -EINVAL;
+	}
+
+	memcpy(&trailer, st->map + st->size - sizeof(trailer), sizeof(trailer));
+	if (!strncmp(trailer.sig, LOGGER_IDX_SIG, LOGGER_IDX_SIG_SIZE) &&
+	    trailer.index_offset <= st->size - sizeof(trailer) &&
+	    trailer.block_count <= (st->size - sizeof(trailer) - trailer.index_offset) /
+	    sizeof(block)) {
+		for (i = 0; i < trailer.block_count; i++) {
+			memcpy(&block, st->map + trailer.index_offset + i * sizeof(block),
+			       sizeof(block));
+			ret = logger_read_block(st, &block);
+			if (ret)
+				return ret;
+		}
+		st->pos = st->size;
+		return 0;
+	}
+
+	/* no trailer, the writer did not finish: walk the block headers */
+	fprintf(st->out_fd, "warn: no index in %s, reading all block headers\n",
+		global_config->in_file);
+	offset = sizeof(*header);
+	while (end - offset >= sizeof(block)) {
+		memcpy(&block, st->map + offset, sizeof(block));
+		if (block.offset != offset + sizeof(block) ||
+		    block.size > end - block.offset)
+			break;
+
+		ret = logger_read_block(st, &block);
+		if (ret)
+			return ret;
+		offset = block.offset + block.size;
+	}
+	st->pos = st->size;
+
+	return 0;
+}
+
+static void *logger_job_run(void *data)
+{
+	struct logger_job *job = data;
+
+	job->st.out_fd = open_memstream(&job->out, &job->out_size);
+	if (!job->st.out_fd) {
+		job->ret = -errno;
+		return NULL;
+	}
+
+	job->ret = logger_read_map(&job->st, job->stop);
+	fclose(job->st.out_fd);
+
+	return NULL;
+}
+
+/** Decodes a mapped input file in chunks of LOGGER_JOB_CHUNK_SIZE bytes,
+ * global_config->jobs chunks at a time. A dry run that only tracks the
+ * decoding state finds where each chunk starts, the chunks are then
+ * formatted in parallel and written out in order.
+ */
+static int logger_read_jobs(struct logger_state *st)
+{
+	int jobs = global_config->jobs;
+	struct logger_job *job;
+	int ret = 0;
+	int n, i;
+
+	job = calloc(jobs, sizeof(*job));
+	if (!job) {
+		log_err("can't allocate %d decoding jobs\n", jobs);
+		return -ENOMEM;
+	}
+
+	while (!ret && st->pos < st->size) {
+		for (n = 0; n < jobs && st->pos < st->size; n++) {
+			job[n].st = *st;
+			job[n].stop = st->size - st->pos > LOGGER_JOB_CHUNK_SIZE ?
+				      st->pos + LOGGER_JOB_CHUNK_SIZE : st->size;
+			job[n].out = NULL;
+			job[n].out_size = 0;
+
+			st->out_fd = NULL;
+			ret = logger_read_map(st, job[n].stop);
+			st->out_fd = global_config->out_fd;
+			if (ret) {
+				/* let the job print its output up to the failure */
+				n++;
+				break;
+			}
+		}
+
+		for (i = 0; i < n; i++) {
+			job[i].ret = pthread_create(&job[i].thread, NULL, logger_job_run, &job[i]);
+			job[i].started = !job[i].ret;
+			if (!job[i].started) {
+				log_err("can't create decoding thread: %s\n", strerror(job[i].ret));
+				logger_job_run(&job[i]);
+			}
+		}
+
+		for (i = 0; i < n; i++) {
+			if (job[i].started)
+				pthread_join(job[i].thread, NULL);
+			if (job[i].out)
+				fwrite(job[i].out, 1, job[i].out_size, st->out_fd);
+			free(job[i].out);
+			if (job[i].ret && !ret)
+				ret = job[i].ret;
+		}
+	}
+
+	fflush(st->out_fd);
+	free(job);
+
+	return ret;
+}
+
+/** Maps the input file when it is a regular file, it is then decoded
+ * without any read() or seek.
+ */
+static void logger_map_input(struct logger_state *st)
+{
+	struct stat in_stat;
+	void *map;
+
+	if (global_config->trace || global_config->input_std || !global_config->in_fd)
+		return;
+
+	if (fstat(fileno(global_config->in_fd), &in_stat) || !S_ISREG(in_stat.st_mode) ||
+	    !in_stat.st_size)
+		return;
+
+	map = mmap(NULL, in_stat.st_size, PROT_READ, MAP_PRIVATE,
+		   fileno(global_config->in_fd), 0);
+	if (map == MAP_FAILED)
+		return;
+
+	st->map = map;
+	st->size = in_stat.st_size;
+	st->pos = 0;
 }
 
 /** Main logger loop */
 static int logger_read(void)
 {
+	struct logger_state st = {
+		.out_fd = global_config->out_fd,
+		.entry_number = 1,
+	};
 	struct log_entry_header dma_log;
 	int ret = 0;
-	uint64_t last_timestamp = 0;
-
-	bool ldc_address_OK = false;
-	unsigned int skipped_dwords = 0;
 
-	if (!global_config->raw_output)
+	if (!global_config->raw_output && !idx_writer)
 		print_table_header();
 
 	if (global_config->serial_fd >= 0)
 		/* Wait for CTRL-C */
 		for (;;) {
-			ret = serial_read(&last_timestamp);
+			ret = serial_read(&st);
 			if (ret < 0)
 				return ret;
 		}
 
+	logger_map_input(&st);
+	if (st.map) {
+		if (st.size >= sizeof(struct logger_idx_header) +
+			       sizeof(struct logger_idx_trailer) &&
+		    !strncmp((const char *)st.map, LOGGER_IDX_SIG, LOGGER_IDX_SIG_SIZE))
+			ret = logger_read_index(&st);
+		else if (global_config->jobs > 1 && !idx_writer)
+			ret = logger_read_jobs(&st);
+		else
+			ret = logger_read_map(&st, st.size);
+		munmap((void *)st.map, st.size);
+		goto out;
+	}
+
 	/* One iteration per log statement */
 	while (!ferror(global_config->in_fd)) {
 		/* getting entry parameters from dma dump */
@@ -876,7 +1476,7 @@ static int logger_read(void)
 					"Re-opening trace input file",
 					"device suspend?");
 				if (freopen(NULL, "rb", global_config->in_fd)) {
-					entry_number = 1;
+					st.entry_number = 1;
 					continue;
 				} else {
 					log_err("in %s(), freopen(..., %s) failed: %s(%d)\n",
@@ -904,13 +1504,13 @@ static int logger_read(void)
 			 * mailbox ring buffer is routine. Take note in both cases but
 			 * report errors only for the DMA trace.
 			 */
-			if (global_config->trace && ldc_address_OK) {
+			if (global_config->trace && st.ldc_address_OK) {
 				log_err("log_entry_address %#10x is not in dictionary range!\n",
 					dma_log.log_entry_address);
 				fprintf(global_config->out_fd,
 					"warn: Seeking forward 4 bytes at a time until re-synchronize.\n");
 			}
-			ldc_address_OK = false;
+			st.ldc_address_OK = false;
 			/* When the address is not correct, move forward by one DWORD (not
 			 * entire struct dma_log)
 			 */
@@ -921,44 +1521,45 @@ static int logger_read(void)
 				ret = -errno;
 				break;
 			}
-			skipped_dwords++;
+			st.skipped_dwords++;
 			continue;
 
-		} else if (!ldc_address_OK) {
+		} else if (!st.ldc_address_OK) {
 			 /* Just found a valid address (again) */
 
 			/* At this point, skipped_dwords can be == 0
 			 * only when we just started to run.
 			 */
-			if (skipped_dwords != 0) {
+			if (st.skipped_dwords != 0) {
 				fprintf(global_config->out_fd,
 					"\nFound valid LDC address after skipping %zu bytes (one line uses %zu + 0 to 16 bytes)\n",
-				       sizeof(uint32_t) * skipped_dwords, sizeof(dma_log));
+				       sizeof(uint32_t) * st.skipped_dwords, sizeof(dma_log));
 			}
 
-			ldc_address_OK = true;
-			skipped_dwords = 0;
+			st.ldc_address_OK = true;
+			st.skipped_dwords = 0;
 		}
 
 		/* fetching entry from dictionary, read the number of
 		 * arguments needed and finish the entire processing of
 		 * this log line.
 		 */
-		ret = fetch_entry(&dma_log, &last_timestamp);
+		ret = fetch_entry(&st, &dma_log);
 		if (ret) {
 			log_err("fetch_entry() failed with: %d, aborting\n", ret);
 			break;
 		}
 	} /* next log entry */
 
+out:
 	/* End of (etrace) file */
 	fprintf(global_config->out_fd,
 		"Skipped %zu bytes after the last statement",
-		sizeof(uint32_t) * skipped_dwords);
+		sizeof(uint32_t) * st.skipped_dwords);
 
 	if (!global_config->trace &&
 	    /* maximum 4 arguments supported */
-	    skipped_dwords < sizeof(dma_log) + 4 * sizeof(uint32_t))
+	    st.skipped_dwords < sizeof(dma_log) + 4 * sizeof(uint32_t))
 		fprintf(global_config->out_fd,
 			". Potential mailbox wrap, check the start of the output for later logs");
 
@@ -1052,6 +1653,34 @@ static int dump_ldc_info(void)
 	return 0;
 }
 
+/** Maps the whole .ldc file, entries are then parsed straight from memory */
+static int ldc_map_file(void)
+{
+	struct stat ldc_stat;
+	void *map;
+	int ret;
+
+	if (fstat(fileno(global_config->ldc_fd), &ldc_stat)) {
+		ret = -errno;
+		log_err("Error while reading size of %s.\n", global_config->ldc_file);
+		return ret;
+	}
+
+	map = mmap(NULL, ldc_stat.st_size, PROT_READ, MAP_PRIVATE,
+		   fileno(global_config->ldc_fd), 0);
+	if (map == MAP_FAILED) {
+		ret = -errno;
+		log_err("Error while mapping %s: %s\n", global_config->ldc_file,
+			strerror(-ret));
+		return ret;
+	}
+
+	ldc.map = map;
+	ldc.size = ldc_stat.st_size;
+
+	return 0;
+}
+
 int convert(void)
 {
 	struct snd_sof_logs_header * const logs_hdr = malloc(sizeof(*logs_hdr));
@@ -1148,7 +1777,28 @@ int convert(void)
 		}
 	}
 
+	ret = ldc_map_file();
+	if (ret)
+		goto out;
+
+	logger_query_init();
+
+	if (config->index_fd) {
+		ret = logger_idx_open();
+		if (ret)
+			goto unmap;
+	}
+
 	ret = logger_read();
+
+	if (idx_writer) {
+		count = logger_idx_close();
+		if (!ret)
+			ret = count;
+	}
+unmap:
+	ldc_cache_free();
+	munmap((void *)ldc.map, ldc.size);
 out:
 	free(config->uids_dict);
 	return ret;
@@ -42,6 +42,13 @@ struct convert_config {
 	int hide_location;
 	int relative_timestamps;
 	int8_t time_precision;
+	int jobs;
+	const char *index_file;	/* indexed binary output, see logger_idx_header */
+	FILE *index_fd;
+	double query_begin;	/* statements shown, timestamps in us */
+	double query_end;
+	const char *query_comp;	/* component name or NULL for all */
+	int query_level;	/* highest level shown, 0 for all */
 	struct snd_sof_uids_header *uids_dict;
 	struct snd_sof_logs_header *logs_header;
 };
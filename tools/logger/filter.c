@@ -75,7 +75,7 @@ static struct sof_uuid_entry *get_uuid_by_name(const char *name)
  * @param value_start pointer to the begin of range to search
  * @return enum value for given log level, or -1 for invalid value
  */
-static int filter_parse_log_level(const char *value_start)
+int filter_parse_log_level(const char *value_start)
 {
 	int i;
 
@@ -12,4 +12,7 @@
 
 int filter_update_firmware(void);
 
+/* log level value for a name like "info" or "i", -1 when unknown */
+int filter_parse_log_level(const char *value_start);
+
 #endif /* __LOGGER_FILTER_H__ */
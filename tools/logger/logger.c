@@ -16,6 +16,7 @@
 #include <fcntl.h>
 #include <stdbool.h>
 #include <termios.h>
+#include <math.h>
 
 #include <sys/types.h>
 #include <dirent.h>
@@ -29,6 +30,7 @@
 #endif
 
 #include "convert.h"
+#include "filter.h"
 #include "misc.h"
 
 #define APP_NAME "sof-logger"
@@ -86,6 +88,18 @@ static void usage(void)
 	fprintf(stdout, "%s:\t -F filter\t\tUpdate trace filter, format: "
 		"<level>=<comp1>[, <comp2>]\n",
 		APP_NAME);
+	fprintf(stdout, "%s:\t -j jobs\t\tDecode a regular input file with jobs threads\n",
+		APP_NAME);
+	fprintf(stdout, "%s:\t -b binfile\t\tWrite indexed binary instead of text, decode\n",
+		APP_NAME);
+	fprintf(stdout, "%s:\t\t\t\tit later with -i binfile and the same ldc file\n",
+		APP_NAME);
+	fprintf(stdout, "%s:\t -w begin,end\t\tOnly entries with timestamps in the window, in us\n",
+		APP_NAME);
+	fprintf(stdout, "%s:\t -C component\t\tOnly entries of the named component\n",
+		APP_NAME);
+	fprintf(stdout, "%s:\t -V level\t\tOnly entries up to level, names as in -F\n",
+		APP_NAME);
 	exit(0);
 }
 
@@ -297,7 +311,7 @@ struct convert_config * const global_config = &_global_config;
 
 int main(int argc, char *argv[])
 {
-	static const char optstring[] = "ho:i:l:ps:c:u:tv:rd:Le:f:gF:n";
+	static const char optstring[] = "ho:i:l:ps:c:u:tv:rd:Le:f:gF:nj:b:w:C:V:";
 	struct convert_config config;
 	unsigned int baud = 0;
 	const char *snapshot_file = 0;
@@ -324,6 +338,13 @@ int main(int argc, char *argv[])
 	config.time_precision = 6;
 	config.relative_timestamps = INT_MAX; /* unspecified */
 	config.filter_config = NULL;
+	config.jobs = 1;
+	config.index_file = NULL;
+	config.index_fd = NULL;
+	config.query_begin = 0;
+	config.query_end = HUGE_VAL;
+	config.query_comp = NULL;
+	config.query_level = 0;
 
 	while ((opt = getopt(argc, argv, optstring)) != -1) {
 		switch (opt) {
@@ -404,6 +425,40 @@ int main(int argc, char *argv[])
 			if (ret < 0)
 				return ret;
 			break;
+		case 'j':
+			config.jobs = atoi(optarg);
+			if (config.jobs < 1) {
+				fprintf(stderr, "%s: invalid option: -j %s\n",
+					APP_NAME, optarg);
+				ret = -EINVAL;
+				goto out;
+			}
+			break;
+		case 'b':
+			config.index_file = optarg;
+			break;
+		case 'w':
+			if (sscanf(optarg, "%lf,%lf", &config.query_begin,
+				   &config.query_end) != 2 ||
+			    config.query_begin > config.query_end) {
+				fprintf(stderr, "%s: invalid option: -w %s\n",
+					APP_NAME, optarg);
+				ret = -EINVAL;
+				goto out;
+			}
+			break;
+		case 'C':
+			config.query_comp = optarg;
+			break;
+		case 'V':
+			config.query_level = filter_parse_log_level(optarg);
+			if (config.query_level < 0) {
+				fprintf(stderr, "%s: invalid option: -V %s\n",
+					APP_NAME, optarg);
+				ret = -EINVAL;
+				goto out;
+			}
+			break;
 		case 'h':
 		default: /* '?' */
 			usage();
@@ -503,6 +558,16 @@ int main(int argc, char *argv[])
 	if (isatty(fileno(config.out_fd)) != 1)
 		config.use_colors = 0;
 
+	if (config.index_file) {
+		config.index_fd = fopen(config.index_file, "wb");
+		if (!config.index_fd) {
+			ret = errno;
+			fprintf(stderr, "error: Unable to open binary file %s: %s\n",
+				config.index_file, strerror(ret));
+			goto out;
+		}
+	}
+
 	if (config.version_fw) {
 		config.version_fd = fopen(config.version_file, "rb");
 		if (!config.version_fd && !config.dump_ldc) {
@@ -532,6 +597,9 @@ out:
 	if (config.ldc_fd)
 		fclose(config.ldc_fd);
 
+	if (config.index_fd)
+		fclose(config.index_fd);
+
 	if (config.version_fd)
 		fclose(config.version_fd);
 
@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <sys/poll.h>
 #include <string.h>
+#include <strings.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/un.h>
@@ -46,6 +47,11 @@ typedef struct snd_sof_pcm {
 
 	struct plug_shm_desc shm_pcm;
 
+	/* mixed into the endpoint of a PCM already running for another client */
+	int mix_client;
+	int mix_slot;
+	struct plug_shm_desc shm_host;
+
 	int frame_us;
 } snd_sof_pcm_t;
 
@@ -122,6 +128,12 @@ static int plug_pcm_start(snd_pcm_ioplug_t *io)
 	struct plug_shm_endpoint *ctx = pcm->shm_pcm.addr;
 	int err;
 
+	/* the pipelines belong to the first client, just get mixed from now */
+	if (pcm->mix_client) {
+		ctx->state = SOF_PLUGIN_STATE_STREAM_RUNNING;
+		return 0;
+	}
+
 	switch (ctx->state) {
 	case SOF_PLUGIN_STATE_READY:
 		err = plug_pipelines_set_state(plug, SOF_IPC4_PIPELINE_STATE_RUNNING);
@@ -129,39 +141,7 @@ static int plug_pcm_start(snd_pcm_ioplug_t *io)
 			return err;
 		break;
 	case SOF_PLUGIN_STATE_STREAM_RUNNING:
-	{
-		struct tplg_pipeline_list *pipeline_list;
-		int i, delay;
-
-		if (!pcm->capture)
-			break;
-
-		pipeline_list = &plug->pcm_info->capture_pipeline_list;
-
-		/* start the first period copy for capture */
-		for (i = pipeline_list->count - 1; i >= 0; i--) {
-			sem_post(pcm->ready[i].sem);
-
-			/* wait for sof-pipe reader to consume data or timeout */
-			err = clock_gettime(CLOCK_REALTIME, &pcm->wait_timeout);
-			if (err == -1) {
-				SNDERR("write: cant get time: %s", strerror(errno));
-				return -EPIPE;
-			}
-
-			/* work out delay TODO: fix ALSA reader */
-			delay = pcm->frame_us * io->period_size / 500;
-			plug_timespec_add_ms(&pcm->wait_timeout, delay);
-
-			/* wait for sof-pipe writer to produce data or timeout */
-			err = sem_timedwait(pcm->done[i].sem, &pcm->wait_timeout);
-			if (err == -1) {
-				SNDERR("read: waited %d ms for %ld frames fatal timeout: %s",
-				       delay, io->period_size, strerror(errno));
-				return -errno;
-			}
-		}
-	}
+		/* pipelines are free running, capture has already started */
 		break;
 	case SOF_PLUGIN_STATE_INIT:
 	case SOF_PLUGIN_STATE_STREAM_ERROR:
@@ -183,6 +163,16 @@ static int plug_pcm_stop(snd_pcm_ioplug_t *io)
 	int err;
 
 	printf("%s %d state %ld\n", __func__, __LINE__, ctx->state);
+
+	if (pcm->mix_client) {
+		ctx->state = SOF_PLUGIN_STATE_READY;
+		return 0;
+	}
+
+	/* other clients are still mixed in, keep the pipelines running */
+	if (ctx->mix && atomic_load(&ctx->clients))
+		return 0;
+
 	switch (ctx->state) {
 	case SOF_PLUGIN_STATE_STREAM_ERROR:
 	case SOF_PLUGIN_STATE_STREAM_RUNNING:
@@ -275,6 +265,47 @@ static int plug_pcm_delay(snd_pcm_ioplug_t *io, snd_pcm_sframes_t *delayp)
 	}
 }
 
+/*
+ * The ring is full for playback or empty for capture: sleep until sof-pipe
+ * has moved data. The wait flag tells sof-pipe to post done and it is set
+ * before the ring is checked again so that a wakeup in between is not lost.
+ */
+static int plug_pcm_wait(snd_pcm_ioplug_t *io)
+{
+	snd_sof_plug_t *plug = io->private_data;
+	snd_sof_pcm_t *pcm = plug->module_prv;
+	struct plug_shm_endpoint *ctx = pcm->shm_pcm.addr;
+	int err, delay;
+
+	atomic_store(&ctx->plug_wait, 1);
+	if (pcm->capture ? plug_ep_get_avail(ctx) : plug_ep_get_free(ctx)) {
+		atomic_store(&ctx->plug_wait, 0);
+		return 0;
+	}
+
+	err = clock_gettime(CLOCK_REALTIME, &pcm->wait_timeout);
+	if (err == -1) {
+		SNDERR("wait: cant get time: %s", strerror(errno));
+		atomic_store(&ctx->plug_wait, 0);
+		return -EPIPE;
+	}
+
+	/* allow for two periods */
+	delay = pcm->frame_us * io->period_size / 500;
+	plug_timespec_add_ms(&pcm->wait_timeout, delay);
+
+	err = sem_timedwait(pcm->mix_client ? &ctx->wake : pcm->done[0].sem,
+			    &pcm->wait_timeout);
+	atomic_store(&ctx->plug_wait, 0);
+	if (err == -1) {
+		SNDERR("wait: waited %d ms for sof-pipe, fatal timeout: %s",
+		       delay, strerror(errno));
+		return -errno;
+	}
+
+	return 0;
+}
+
 /* return frames written */
 static snd_pcm_sframes_t plug_pcm_write(snd_pcm_ioplug_t *io, const snd_pcm_channel_area_t *areas,
 					snd_pcm_uframes_t offset, snd_pcm_uframes_t size)
@@ -282,19 +313,22 @@ static snd_pcm_sframes_t plug_pcm_write(snd_pcm_ioplug_t *io, const snd_pcm_chan
 	snd_sof_plug_t *plug = io->private_data;
 	snd_sof_pcm_t *pcm = plug->module_prv;
 	struct plug_shm_endpoint *ctx = pcm->shm_pcm.addr;
-	struct tplg_pipeline_list *pipeline_list;
 	snd_pcm_sframes_t frames = 0;
-	int i;
 	ssize_t bytes;
 	const char *buf;
-	int err, delay;
-
-	pipeline_list = &plug->pcm_info->playback_pipeline_list;
+	int err;
 
 	/* calculate the buffer position and size from application */
 	buf = (char *)areas->addr + (areas->first + areas->step * offset) / 8;
 	bytes = size * pcm->frame_size;
 
+	/* only block when the pipe has no room at all */
+	if (!plug_ep_get_free(ctx) && !io->nonblock) {
+		err = plug_pcm_wait(io);
+		if (err < 0)
+			return err;
+	}
+
 	/* now check what the pipe has free */
 	bytes = MIN(plug_ep_get_free(ctx), bytes);
 
@@ -304,35 +338,10 @@ static snd_pcm_sframes_t plug_pcm_write(snd_pcm_ioplug_t *io, const snd_pcm_chan
 		return frames;
 
 	/* write audio data to the pipe */
-	memcpy(plug_ep_wptr(ctx), buf, bytes);
-
-	plug_ep_produce(ctx, bytes);
-
-	/* tell the pipelines data is ready starting at the source pipeline */
-	for (i = 0; i < pipeline_list->count; i++) {
-		struct tplg_pipeline_info *pipe_info = pipeline_list->pipelines[i];
+	plug_ep_write(ctx, buf, frames * pcm->frame_size);
 
-		sem_post(pcm->ready[i].sem);
-
-		/* wait for sof-pipe reader to consume data or timeout */
-		err = clock_gettime(CLOCK_REALTIME, &pcm->wait_timeout);
-		if (err == -1) {
-			SNDERR("write: cant get time: %s", strerror(errno));
-			return -EPIPE;
-		}
-
-		/* work out delay */
-		delay = pcm->frame_us * frames / 500;
-		plug_timespec_add_ms(&pcm->wait_timeout, delay);
-
-		/* now block caller on pipeline IO to PCM device */
-		err = sem_timedwait(pcm->done[i].sem, &pcm->wait_timeout);
-		if (err == -1) {
-			SNDERR("write: waited %d ms for %ld frames, fatal timeout: %s",
-			       delay, frames, strerror(errno));
-			return -errno;
-		}
-	}
+	/* the source pipeline runs at its own period, only wake it if it starved */
+	plug_ep_wake(&ctx->pipe_wait, pcm->ready[0].sem);
 
 	return frames;
 }
@@ -345,17 +354,21 @@ static snd_pcm_sframes_t plug_pcm_read(snd_pcm_ioplug_t *io, const snd_pcm_chann
 	snd_sof_pcm_t *pcm = plug->module_prv;
 	snd_pcm_sframes_t frames;
 	struct plug_shm_endpoint *ctx = pcm->shm_pcm.addr;
-	struct tplg_pipeline_list *pipeline_list;
 	ssize_t bytes;
 	char *buf;
-	int err, delay, i;
-
-	pipeline_list = &plug->pcm_info->capture_pipeline_list;
+	int err;
 
 	/* calculate the buffer position and size */
 	buf = (char *)areas->addr + (areas->first + areas->step * offset) / 8;
 	bytes = size * pcm->frame_size;
 
+	/* only block when the pipe has nothing at all */
+	if (!plug_ep_get_avail(ctx) && !io->nonblock) {
+		err = plug_pcm_wait(io);
+		if (err < 0)
+			return err;
+	}
+
 	/* check what the pipe has avail */
 	bytes = MIN(plug_ep_get_avail(ctx), bytes);
 	frames = bytes / pcm->frame_size;
@@ -363,33 +376,11 @@ static snd_pcm_sframes_t plug_pcm_read(snd_pcm_ioplug_t *io, const snd_pcm_chann
 	if (!frames)
 		return 0;
 
-	/* tell the pipe ready we are ready for next period */
-	for (i = pipeline_list->count - 1; i >= 0; i--) {
-		sem_post(pcm->ready[i].sem);
-
-		/* wait for sof-pipe reader to consume data or timeout */
-		err = clock_gettime(CLOCK_REALTIME, &pcm->wait_timeout);
-		if (err == -1) {
-			SNDERR("write: cant get time: %s", strerror(errno));
-			return -EPIPE;
-		}
-
-		/* work out delay TODO: fix ALSA reader */
-		delay = pcm->frame_us * frames / 500;
-		plug_timespec_add_ms(&pcm->wait_timeout, delay);
-
-		/* wait for sof-pipe writer to produce data or timeout */
-		err = sem_timedwait(pcm->done[i].sem, &pcm->wait_timeout);
-		if (err == -1) {
-			SNDERR("read: waited %d ms for %ld frames fatal timeout: %s",
-			       delay, frames, strerror(errno));
-			return -errno;
-		}
-	}
-
 	/* copy audio data from pipe */
-	memcpy(buf, plug_ep_rptr(ctx), bytes);
-	plug_ep_consume(ctx, bytes);
+	plug_ep_read(ctx, buf, frames * pcm->frame_size);
+
+	/* the sink pipeline runs at its own period, only wake it if it starved */
+	plug_ep_wake(&ctx->pipe_wait, pcm->ready[0].sem);
 
 	return frames;
 }
@@ -404,9 +395,9 @@ static int plug_pcm_prepare(snd_pcm_ioplug_t *io)
 	ctx->wtotal = 0;
 	ctx->rtotal = 0;
 	ctx->rpos = 0;
-	ctx->rwrap = 0;
 	ctx->wpos = 0;
-	ctx->wwrap = 0;
+	ctx->plug_wait = 0;
+	ctx->pipe_wait = 0;
 
 	/* start the pipeline threads
 	 *
@@ -447,6 +438,164 @@ static int plug_pcm_prepare(snd_pcm_ioplug_t *io)
 
 static int plug_init_shm_ctx(snd_sof_plug_t *plug, snd_pcm_hw_params_t *params);
 
+/*
+ * With sof-pipe in mix mode, a playback client opening a PCM that is already
+ * running for another client gets a ring of its own in a new SHM, and sof-pipe
+ * mixes it into the running pipelines. Returns -ENOENT when there is no such
+ * PCM to join and the pipelines have to be set up as usual.
+ */
+static int plug_pcm_mix_join(snd_pcm_ioplug_t *io)
+{
+	snd_sof_plug_t *plug = io->private_data;
+	snd_sof_pcm_t *pcm = plug->module_prv;
+	struct plug_shm_endpoint *host;
+	struct plug_shm_endpoint *ctx;
+	struct tplg_pcm_info *pcm_info;
+	struct list_item *item;
+	unsigned int slots;
+	int slot, err;
+
+	err = plug_shm_init(&pcm->shm_host, plug->tplg_file, "pcm", plug->pcm_id);
+	if (err < 0)
+		return err;
+
+	if (plug_shm_open(&pcm->shm_host) < 0)
+		return -ENOENT;
+
+	host = pcm->shm_host.addr;
+	if (!host->mix || host->state == SOF_PLUGIN_STATE_INIT) {
+		err = -ENOENT;
+		goto host_err;
+	}
+
+	if (host->frame_size != (int)pcm->frame_size) {
+		SNDERR("mix: frame size %zu differs from running PCM %d\n",
+		       pcm->frame_size, host->frame_size);
+		err = -EINVAL;
+		goto host_err;
+	}
+
+	/* reserve a slot, sof-pipe only looks at it once published in clients */
+	slots = atomic_load(&host->slots);
+	do {
+		slot = ffs(~slots) - 1;
+		if (slot < 0 || slot >= PLUG_MIX_MAX_CLIENTS) {
+			SNDERR("mix: no free client slot on PCM %d\n", plug->pcm_id);
+			err = -EBUSY;
+			goto host_err;
+		}
+	} while (!atomic_compare_exchange_weak(&host->slots, &slots, slots | (1U << slot)));
+	pcm->mix_slot = slot;
+
+	err = plug_shm_mix_init(&pcm->shm_pcm, plug->tplg_file, host->comp_id, slot);
+	if (err < 0)
+		goto slot_err;
+
+	pcm->shm_pcm.size = sizeof(*ctx) + io->buffer_size * pcm->frame_size;
+	err = plug_shm_create(&pcm->shm_pcm);
+	if (err < 0)
+		goto slot_err;
+
+	ctx = pcm->shm_pcm.addr;
+	memset(ctx, 0, sizeof(*ctx));
+	ctx->frame_size = pcm->frame_size;
+	ctx->buffer_size = io->buffer_size * pcm->frame_size;
+	ctx->state = SOF_PLUGIN_STATE_READY;
+	sem_init(&ctx->wake, 1, 0);
+
+	/* the ready lock of the host pipeline wakes sof-pipe when it starved */
+	list_for_item(item, &plug->pcm_list) {
+		pcm_info = container_of(item, struct tplg_pcm_info, item);
+		if (pcm_info->id == plug->pcm_id)
+			plug->pcm_info = pcm_info;
+	}
+
+	if (!plug->pcm_info || !plug->pcm_info->playback_pipeline_list.count) {
+		err = -EINVAL;
+		goto shm_err;
+	}
+
+	err = plug_lock_init(&pcm->ready[0], plug->tplg_file, "ready",
+			     plug->pcm_info->playback_pipeline_list.pipelines[0]->instance_id);
+	if (err < 0)
+		goto shm_err;
+
+	err = plug_lock_open(&pcm->ready[0]);
+	if (err < 0)
+		goto shm_err;
+
+	/* publish the client, sof-pipe picks up the slot on its generation change */
+	pcm->mix_client = 1;
+	atomic_fetch_or(&host->clients, 1U << slot);
+	atomic_fetch_add(&host->mix_gen[slot], 1);
+
+	fprintf(stdout, "PCM %d joined as mix client %d\n", plug->pcm_id, slot);
+
+	return 0;
+
+shm_err:
+	sem_destroy(&ctx->wake);
+	munmap(pcm->shm_pcm.addr, pcm->shm_pcm.size);
+	plug_shm_free(&pcm->shm_pcm);
+slot_err:
+	atomic_fetch_and(&host->slots, ~(1U << slot));
+host_err:
+	munmap(pcm->shm_host.addr, pcm->shm_host.size);
+	close(pcm->shm_host.fd);
+	return err;
+}
+
+/*
+ * sof-pipe may be mixing from the client ring while it leaves, so the slot is
+ * only torn down once sof-pipe has acked the detach or is clearly not running.
+ */
+static void plug_pcm_mix_leave(snd_pcm_ioplug_t *io)
+{
+	snd_sof_plug_t *plug = io->private_data;
+	snd_sof_pcm_t *pcm = plug->module_prv;
+	struct plug_shm_endpoint *host = pcm->shm_host.addr;
+	struct plug_shm_endpoint *ctx = pcm->shm_pcm.addr;
+	struct timespec timeout;
+	unsigned int gen;
+	int delay;
+	int err;
+
+	atomic_fetch_and(&host->clients, ~(1U << pcm->mix_slot));
+	gen = atomic_fetch_add(&host->mix_gen[pcm->mix_slot], 1) + 1;
+
+	/* wake sof-pipe in case it starved, it drops its mapping on the next copy */
+	plug_ep_wake(&ctx->pipe_wait, pcm->ready[0].sem);
+
+	err = clock_gettime(CLOCK_REALTIME, &timeout);
+	if (err == -1) {
+		SNDERR("mix leave: cant get time: %s", strerror(errno));
+	} else {
+		/* allow for four periods */
+		delay = pcm->frame_us * io->period_size / 250;
+		plug_timespec_add_ms(&timeout, delay);
+
+		while ((int)(atomic_load(&host->mix_ack[pcm->mix_slot]) - gen) < 0) {
+			err = sem_timedwait(&ctx->wake, &timeout);
+			if (err == -1 && errno == ETIMEDOUT) {
+				SNDERR("mix leave: no detach ack from sof-pipe in %d ms\n", delay);
+				break;
+			}
+		}
+	}
+
+	/* the slot can only be reused once sof-pipe is done with it */
+	atomic_fetch_and(&host->slots, ~(1U << pcm->mix_slot));
+
+	sem_destroy(&ctx->wake);
+	munmap(pcm->shm_pcm.addr, pcm->shm_pcm.size);
+	plug_shm_free(&pcm->shm_pcm);
+	munmap(pcm->shm_host.addr, pcm->shm_host.size);
+	close(pcm->shm_host.fd);
+	sem_close(pcm->ready[0].sem);
+
+	pcm->mix_client = 0;
+}
+
 static int plug_pcm_hw_params(snd_pcm_ioplug_t *io, snd_pcm_hw_params_t *params)
 {
 	snd_sof_plug_t *plug = io->private_data;
@@ -462,6 +611,12 @@ static int plug_pcm_hw_params(snd_pcm_ioplug_t *io, snd_pcm_hw_params_t *params)
 	/* used for wait timeouts */
 	pcm->frame_us = ceil(1000000.0 / io->rate);
 
+	if (!pcm->capture) {
+		err = plug_pcm_mix_join(io);
+		if (err != -ENOENT)
+			return err;
+	}
+
 	/* now send IPCs to set up widgets */
 	err = plug_set_up_pipelines(plug, pcm->capture, params);
 	if (err < 0) {
@@ -550,6 +705,13 @@ static int plug_pcm_hw_params(snd_pcm_ioplug_t *io, snd_pcm_hw_params_t *params)
 		return -EINVAL;
 	}
 
+	/* the ring lives in the SHM after the endpoint context */
+	if (ctx->buffer_size > pcm->shm_pcm.size - sizeof(*ctx)) {
+		SNDERR("buffer_size %ld does not fit in %d bytes of SHM\n",
+		       ctx->buffer_size, pcm->shm_pcm.size);
+		return -EINVAL;
+	}
+
 	fprintf(stdout, "PCM hw_params done\n");
 
 	return 0;
@@ -622,6 +784,13 @@ static int plug_pcm_hw_free(snd_pcm_ioplug_t *io)
 	snd_sof_pcm_t *pcm = plug->module_prv;
 	int ret, i;
 
+	if (pcm->mix_client) {
+		plug_pcm_mix_leave(io);
+		close(plug->glb_ctx.fd);
+		close(plug->ipc.socket_fd);
+		return 0;
+	}
+
 	/* reset all pipelines */
 	ret = plug_pipelines_set_state(plug, SOF_IPC4_PIPELINE_STATE_RESET);
 	if (ret < 0) {
@@ -677,7 +846,8 @@ static const snd_pcm_ioplug_callback_t sof_capture_callback = {
 };
 
 static const snd_pcm_access_t access_list[] = {
-	SND_PCM_ACCESS_RW_INTERLEAVED
+	SND_PCM_ACCESS_RW_INTERLEAVED,
+	SND_PCM_ACCESS_MMAP_INTERLEAVED,
 };
 
 static const unsigned int formats[] = {
@@ -149,6 +149,22 @@ int plug_shm_init(struct plug_shm_desc *shm, const char *tplg, const char *type,
 	return 0;
 }
 
+/*
+ * Name the SHM of a client mixed into the endpoint of component comp_id.
+ */
+int plug_shm_mix_init(struct plug_shm_desc *shm, const char *tplg, uint32_t comp_id, int slot)
+{
+	const char *name = suffix_name(tplg);
+
+	if (!name)
+		return -EINVAL;
+
+	snprintf(shm->name, NAME_SIZE, "/shm-%s-mix-%x-%d", name, comp_id, slot);
+	shm->size = SHM_SIZE;
+
+	return 0;
+}
+
 /*
  * Open an existing shared memory region using the SHM object.
  */
@@ -166,6 +182,8 @@ int plug_shm_open(struct plug_shm_desc *shm)
 	}
 
 	fstat(shm->fd, &status);
+	shm->size = status.st_size;
+
 	/* map it locally for context readback */
 	shm->addr = mmap(NULL, status.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, shm->fd, 0);
 	if (!shm->addr) {
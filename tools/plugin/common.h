@@ -9,6 +9,7 @@
 #define __SOF_PLUGIN_COMMON_H__
 
 #include <stdint.h>
+#include <string.h>
 #include <semaphore.h>
 #include <alsa/asoundlib.h>
 #include <ipc/control.h>
@@ -20,6 +21,8 @@
 #endif
 
 #include <alsa/sound/uapi/asoc.h>
+/* last, its atomic_init() macro would break the rtos/atomic.h definition */
+#include <stdatomic.h>
 
 #define IPC3_MAX_MSG_SIZE	384
 #define NAME_SIZE	256
@@ -40,6 +43,9 @@
 
 #define MAX_IPC_CLIENTS	5
 
+/* playback clients that can be mixed into one endpoint in sof-pipe mix mode */
+#define PLUG_MIX_MAX_CLIENTS	8
+
 /*
  * Run with valgrind
  * valgrind --trace-children=yes aplay -v -Dsof:blah.tplg,1,hw:1,2  -f dat /dev/zero
@@ -133,14 +139,20 @@ struct plug_shm_endpoint {
 	uint32_t pipeline_id;
 	uint32_t comp_id;
 	uint32_t idx;
-	unsigned long rpos;	/* current position in ring buffer */
-	unsigned long rwrap;
-	unsigned long wpos;	/* current position in ring buffer */
-	unsigned long wwrap;
+	unsigned long rpos;	/* current position in ring buffer, reader only */
+	unsigned long wpos;	/* current position in ring buffer, writer only */
 	unsigned long buffer_size;		/* buffer size */
-	unsigned long wtotal;		/* total frames copied */
-	unsigned long rtotal;		/* total frames copied */
+	atomic_ulong wtotal;		/* total bytes written */
+	atomic_ulong rtotal;		/* total bytes read */
+	atomic_uint plug_wait;		/* plugin sleeps until sof-pipe posts done */
+	atomic_uint pipe_wait;		/* sof-pipe sleeps until plugin posts ready */
 	int frame_size;
+	uint32_t mix;			/* sof-pipe mixes extra clients into this endpoint */
+	atomic_uint slots;		/* mask of mix client slots in use */
+	atomic_uint clients;		/* mask of mix clients with their SHM ready */
+	atomic_uint mix_gen[PLUG_MIX_MAX_CLIENTS];	/* bumped on each join and leave */
+	atomic_uint mix_ack[PLUG_MIX_MAX_CLIENTS];	/* last generation sof-pipe applied */
+	sem_t wake;			/* mix client sleeps here until sof-pipe posts */
 	char data[0];		// TODO: align this on SIMD/cache
 };
 
@@ -198,63 +210,91 @@ static inline int plug_ep_wrap_wsize(struct plug_shm_endpoint *ep)
 	return ep->buffer_size - ep->wpos;
 }
 
-static inline int plug_ep_get_free(struct plug_shm_endpoint *ep)
+/*
+ * The ring is single producer, single consumer. Each side owns its own
+ * position and publishes it through its total with release semantics, the
+ * peer reads the total with acquire semantics. No lock is needed.
+ */
+static inline int plug_ep_get_avail(struct plug_shm_endpoint *ep)
 {
-	if (ep->rwrap == ep->wwrap) {
-		/* calculate available bytes */
-		if (ep->rpos < ep->wpos)
-			return ep->buffer_size - (ep->wpos - ep->rpos);
-		else
-			return ep->buffer_size;
-	} else {
-		return ep->rpos - ep->wpos;
-	}
+	return atomic_load_explicit(&ep->wtotal, memory_order_acquire) -
+	       atomic_load_explicit(&ep->rtotal, memory_order_acquire);
 }
 
-static inline int plug_ep_get_avail(struct plug_shm_endpoint *ep)
+static inline int plug_ep_get_free(struct plug_shm_endpoint *ep)
 {
-	if (ep->rwrap == ep->wwrap) {
-		/* calculate available bytes */
-		if (ep->rpos < ep->wpos)
-			return ep->wpos - ep->rpos;
-		else
-			return 0;
-	} else {
-		return (ep->buffer_size - ep->rpos) + ep->wpos;
-	}
+	return ep->buffer_size - plug_ep_get_avail(ep);
 }
 
 static inline void *plug_ep_consume(struct plug_shm_endpoint *ep, unsigned int bytes)
 {
-	ep->rtotal += bytes;
-	ep->rpos += bytes;
+	unsigned long total = atomic_load_explicit(&ep->rtotal, memory_order_relaxed);
 
-	if (ep->rpos >= ep->buffer_size) {
+	ep->rpos += bytes;
+	if (ep->rpos >= ep->buffer_size)
 		ep->rpos -= ep->buffer_size;
-		ep->rwrap++;
-	}
+
+	atomic_store_explicit(&ep->rtotal, total + bytes, memory_order_release);
 
 	return ep->data + ep->rpos;
 }
 
 static inline void *plug_ep_produce(struct plug_shm_endpoint *ep, unsigned int bytes)
 {
-	ep->wtotal += bytes;
-	ep->wpos += bytes;
+	unsigned long total = atomic_load_explicit(&ep->wtotal, memory_order_relaxed);
 
-	if (ep->wpos >= ep->buffer_size) {
+	ep->wpos += bytes;
+	if (ep->wpos >= ep->buffer_size)
 		ep->wpos -= ep->buffer_size;
-		ep->wwrap++;
-	}
+
+	atomic_store_explicit(&ep->wtotal, total + bytes, memory_order_release);
 
 	return ep->data + ep->wpos;
 }
 
+/*
+ * A side that starves sets its wait flag and sleeps on its semaphore, the
+ * peer only posts the semaphore when it finds the flag set.
+ */
+static inline void plug_ep_wake(atomic_uint *wait, sem_t *sem)
+{
+	if (atomic_exchange(wait, 0))
+		sem_post(sem);
+}
+
+/* copy bytes into the ring at wpos, wrapping at the end of the ring */
+static inline void plug_ep_write(struct plug_shm_endpoint *ep, const void *src, unsigned int bytes)
+{
+	unsigned int head = plug_ep_wrap_wsize(ep);
+
+	if (head > bytes)
+		head = bytes;
+
+	memcpy(plug_ep_wptr(ep), src, head);
+	memcpy(ep->data, (const char *)src + head, bytes - head);
+	plug_ep_produce(ep, bytes);
+}
+
+/* copy bytes from the ring at rpos, wrapping at the end of the ring */
+static inline void plug_ep_read(struct plug_shm_endpoint *ep, void *dest, unsigned int bytes)
+{
+	unsigned int head = plug_ep_wrap_rsize(ep);
+
+	if (head > bytes)
+		head = bytes;
+
+	memcpy(dest, plug_ep_rptr(ep), head);
+	memcpy((char *)dest + head, ep->data, bytes - head);
+	plug_ep_consume(ep, bytes);
+}
+
 /*
  * SHM
  */
 int plug_shm_init(struct plug_shm_desc *shm, const char *tplg, const char *type, int index);
 
+int plug_shm_mix_init(struct plug_shm_desc *shm, const char *tplg, uint32_t comp_id, int slot);
+
 int plug_shm_create(struct plug_shm_desc *shm);
 
 int plug_shm_open(struct plug_shm_desc *shm);
@@ -14,6 +14,7 @@
 #include <sys/stat.h>
 #include <sys/mman.h>
 #include <fcntl.h>
+#include <unistd.h>
 #include <semaphore.h>
 
 #include <rtos/sof.h>
@@ -46,8 +47,158 @@ struct shm_comp_data {
 #if CONFIG_IPC_MAJOR_4
 	struct ipc4_base_module_cfg base_cfg;
 #endif
+
+	/* pipeline buffer using the SHM endpoint ring as its data, no copy needed */
+	struct comp_buffer *ring_buffer;
+	void *local_addr;		/* buffer data restored when the ring is unmapped */
+	uint32_t local_size;
+	uint32_t avail;			/* buffer avail bytes at last sync */
+	unsigned long rtotal;		/* endpoint totals at last sync */
+	unsigned long wtotal;
+
+	/* mix mode, playback clients attached next to the endpoint's own client */
+	struct plug_shm_desc mix_shm[PLUG_MIX_MAX_CLIENTS];
+	uint32_t mix_mapped;		/* clients with their SHM mapped here */
+	uint32_t mix_gen[PLUG_MIX_MAX_CLIENTS];	/* slot generations applied here */
 };
 
+/* point a stream at new data memory, keeping its format and alignment */
+static void shm_stream_rebase(struct audio_stream *stream, void *addr, uint32_t size)
+{
+	stream->addr = addr;
+	stream->end_addr = (char *)addr + size;
+	stream->size = size;
+	audio_stream_reset(stream);
+}
+
+/*
+ * Let the pipeline buffer next to the component use the endpoint ring as its
+ * data, so the plugin and the pipeline work on the same samples. Only possible
+ * when both sides agree on the frame size and the ring fits in the SHM.
+ */
+static void shm_ring_map(struct comp_dev *dev, struct comp_buffer *buffer)
+{
+	struct shm_comp_data *cd = comp_get_drvdata(dev);
+	struct plug_shm_endpoint *ctx = cd->ctx;
+	struct audio_stream *stream = &buffer->stream;
+
+	if (cd->ring_buffer)
+		return;
+
+	if (!ctx->buffer_size || ctx->buffer_size > cd->pcm.size - sizeof(*ctx) ||
+	    ctx->frame_size != (int)audio_stream_frame_bytes(stream) ||
+	    ctx->buffer_size % ctx->frame_size) {
+		comp_info(dev, "endpoint ring not mapped, samples are copied");
+		return;
+	}
+
+	cd->local_addr = audio_stream_get_addr(stream);
+	cd->local_size = audio_stream_get_size(stream);
+	shm_stream_rebase(stream, ctx->data, ctx->buffer_size);
+
+	cd->ring_buffer = buffer;
+	cd->avail = 0;
+	cd->rtotal = ctx->rtotal;
+	cd->wtotal = ctx->wtotal;
+	comp_info(dev, "endpoint ring of %lu bytes mapped as pipeline buffer", ctx->buffer_size);
+}
+
+static void shm_ring_unmap(struct shm_comp_data *cd)
+{
+	struct comp_buffer *buffer = cd->ring_buffer;
+
+	if (!buffer)
+		return;
+
+	shm_stream_rebase(&buffer->stream, cd->local_addr, cd->local_size);
+	cd->ring_buffer = NULL;
+}
+
+static void shm_mix_detach_all(struct shm_comp_data *cd)
+{
+	int i;
+
+	for (i = 0; i < PLUG_MIX_MAX_CLIENTS; i++) {
+		if (cd->mix_mapped & BIT(i)) {
+			munmap(cd->mix_shm[i].addr, cd->mix_shm[i].size);
+			close(cd->mix_shm[i].fd);
+		}
+	}
+
+	cd->mix_mapped = 0;
+}
+
+/*
+ * Wake the plugin if it sleeps on the ring, and tell the pipeline thread to
+ * sleep until the plugin posts ready when the ring has no data (playback) or
+ * no room (capture) left.
+ */
+static void shm_ep_update(struct comp_dev *dev)
+{
+	struct shm_comp_data *cd = comp_get_drvdata(dev);
+	struct plug_shm_endpoint *ctx = cd->ctx;
+	struct pipethread_data *pd = &_sp->pipeline_ctx[dev->pipeline->pipeline_id];
+	bool playback = dev->direction == SOF_IPC_STREAM_PLAYBACK;
+
+	plug_ep_wake(&ctx->plug_wait, pd->done.sem);
+
+	if (playback ? plug_ep_get_avail(ctx) : plug_ep_get_free(ctx))
+		return;
+
+	/* set the flag first and check again, the plugin may have just moved data */
+	atomic_store(&ctx->pipe_wait, 1);
+	if (playback ? plug_ep_get_avail(ctx) : plug_ep_get_free(ctx))
+		atomic_store(&ctx->pipe_wait, 0);
+	else
+		pd->starved = true;
+}
+
+/*
+ * The pipeline and the plugin share the ring, only positions are exchanged:
+ * data consumed by one side since the last sync is released to the other one.
+ */
+static int shm_ring_sync(struct comp_dev *dev)
+{
+	struct shm_comp_data *cd = comp_get_drvdata(dev);
+	struct plug_shm_endpoint *ctx = cd->ctx;
+	struct comp_buffer *buffer = cd->ring_buffer;
+	struct audio_stream *stream = &buffer->stream;
+	uint32_t avail;
+	uint32_t done;
+
+	/* the plugin has reset the endpoint, start over with an empty ring */
+	if (ctx->rtotal < cd->rtotal || ctx->wtotal < cd->wtotal) {
+		audio_stream_reset(stream);
+		cd->avail = 0;
+	}
+
+	avail = audio_stream_get_avail(stream);
+
+	if (dev->direction == SOF_IPC_STREAM_PLAYBACK) {
+		/* release to the plugin what the pipeline has read */
+		plug_ep_consume(ctx, cd->avail - avail);
+
+		/* and hand the plugin's new samples to the pipeline */
+		comp_update_buffer_produce(buffer, plug_ep_get_avail(ctx) - avail);
+	} else {
+		done = cd->avail - plug_ep_get_avail(ctx);
+
+		/* hand the pipeline's new samples to the plugin */
+		plug_ep_produce(ctx, avail - cd->avail);
+
+		/* and release to the pipeline what the plugin has read */
+		comp_update_buffer_consume(buffer, done);
+	}
+
+	cd->avail = audio_stream_get_avail(stream);
+	cd->rtotal = ctx->rtotal;
+	cd->wtotal = ctx->wtotal;
+
+	shm_ep_update(dev);
+
+	return 0;
+}
+
 static int shm_process_new(struct comp_dev *dev,
 			   const struct comp_ipc_config *config,
 			   const void *spec)
@@ -77,6 +228,7 @@ static int shm_process_new(struct comp_dev *dev,
 	memset(ctx, 0, sizeof(*ctx));
 	ctx->comp_id = config->id;
 	ctx->pipeline_id = config->pipeline_id;
+	ctx->mix = _sp->mix_clients && dev->direction == SOF_IPC_STREAM_PLAYBACK;
 	ctx->state = SOF_PLUGIN_STATE_INIT;
 	dev->state = COMP_STATE_READY;
 
@@ -87,6 +239,8 @@ static void shm_free(struct comp_dev *dev)
 {
 	struct shm_comp_data *cd = comp_get_drvdata(dev);
 
+	shm_ring_unmap(cd);
+	shm_mix_detach_all(cd);
 	cd->ctx = NULL;
 
 	plug_shm_free(&cd->pcm);
@@ -231,6 +385,198 @@ static int shm_cmd(struct comp_dev *dev, int cmd, void *data, int max_data_size)
 	return 0;
 }
 
+/*
+ * Map the SHM of newly attached mix clients and unmap the detached ones. A slot
+ * is only looked at when its generation changed, so a client leaving and a new
+ * one joining the same slot between two copies still replaces the mapping.
+ */
+static void shm_mix_attach(struct comp_dev *dev)
+{
+	struct shm_comp_data *cd = comp_get_drvdata(dev);
+	struct plug_shm_endpoint *ctx = cd->ctx;
+	struct plug_shm_endpoint *client;
+	struct plug_shm_desc *shm;
+	uint32_t gen;
+	int i;
+
+	for (i = 0; i < PLUG_MIX_MAX_CLIENTS; i++) {
+		gen = atomic_load(&ctx->mix_gen[i]);
+		if (gen == cd->mix_gen[i])
+			continue;
+
+		cd->mix_gen[i] = gen;
+		shm = &cd->mix_shm[i];
+
+		if (cd->mix_mapped & BIT(i)) {
+			/*
+			 * The client owns and unlinks its SHM, only drop our mapping.
+			 * A leaving client waits for the ack before tearing down.
+			 */
+			client = shm->addr;
+			atomic_store(&ctx->mix_ack[i], gen);
+			sem_post(&client->wake);
+			munmap(shm->addr, shm->size);
+			close(shm->fd);
+			cd->mix_mapped &= ~BIT(i);
+			comp_info(dev, "mix client %d detached", i);
+		}
+
+		if (!(atomic_load(&ctx->clients) & BIT(i))) {
+			atomic_store(&ctx->mix_ack[i], gen);
+			continue;
+		}
+
+		if (plug_shm_mix_init(shm, _sp->topology_name, dev->ipc_config.id, i) < 0 ||
+		    plug_shm_open(shm) < 0) {
+			comp_err(dev, "mix client %d: can't open %s", i, shm->name);
+			atomic_store(&ctx->mix_ack[i], gen);
+			continue;
+		}
+
+		cd->mix_mapped |= BIT(i);
+		atomic_store(&ctx->mix_ack[i], gen);
+		comp_info(dev, "mix client %d attached", i);
+	}
+}
+
+/* add bytes of the client ring to the samples at the sink write pointer */
+static void shm_mix_add(struct audio_stream *sink, struct plug_shm_endpoint *ep,
+			uint32_t bytes)
+{
+	void *dst = audio_stream_get_wptr(sink);
+	uint32_t copy_bytes;
+	uint32_t i;
+
+	while (bytes) {
+		copy_bytes = MIN(bytes, plug_ep_wrap_rsize(ep));
+		copy_bytes = MIN(copy_bytes, audio_stream_bytes_without_wrap(sink, dst));
+
+		switch (audio_stream_get_frm_fmt(sink)) {
+		case SOF_IPC_FRAME_S16_LE:
+		{
+			int16_t *d = dst;
+			int16_t *src = plug_ep_rptr(ep);
+
+			for (i = 0; i < copy_bytes / sizeof(*d); i++)
+				d[i] = sat_int16((int32_t)d[i] + src[i]);
+			break;
+		}
+		case SOF_IPC_FRAME_S24_4LE:
+		{
+			int32_t *d = dst;
+			int32_t *src = plug_ep_rptr(ep);
+
+			for (i = 0; i < copy_bytes / sizeof(*d); i++)
+				d[i] = sat_int24(sign_extend_s24(d[i]) + sign_extend_s24(src[i]));
+			break;
+		}
+		case SOF_IPC_FRAME_S32_LE:
+		{
+			int32_t *d = dst;
+			int32_t *src = plug_ep_rptr(ep);
+
+			for (i = 0; i < copy_bytes / sizeof(*d); i++)
+				d[i] = sat_int32((int64_t)d[i] + src[i]);
+			break;
+		}
+		case SOF_IPC_FRAME_FLOAT:
+		{
+			float *d = dst;
+			float *src = plug_ep_rptr(ep);
+
+			for (i = 0; i < copy_bytes / sizeof(*d); i++)
+				d[i] += src[i];
+			break;
+		}
+		default:
+			break;
+		}
+
+		dst = audio_stream_wrap(sink, (char *)dst + copy_bytes);
+		plug_ep_consume(ep, copy_bytes);
+		bytes -= copy_bytes;
+	}
+}
+
+/*
+ * Mix mode playback: the endpoint's own client and every running attached
+ * client are summed into the sink buffer in one pass. A pass moves at most a
+ * period so that clients that are ahead don't leave gaps for the others.
+ */
+static int shm_mix_copy(struct comp_dev *dev)
+{
+	struct shm_comp_data *cd = comp_get_drvdata(dev);
+	struct pipethread_data *pd = &_sp->pipeline_ctx[dev->pipeline->pipeline_id];
+	struct plug_shm_endpoint *ep[PLUG_MIX_MAX_CLIENTS + 1];
+	struct plug_shm_endpoint *client;
+	struct comp_buffer *buffer;
+	struct audio_stream *sink;
+	uint32_t frame_bytes;
+	uint32_t period_bytes;
+	uint32_t bytes = 0;
+	int count = 0;
+	int i;
+
+	buffer = comp_dev_get_first_data_consumer(dev);
+	sink = &buffer->stream;
+	frame_bytes = audio_stream_frame_bytes(sink);
+
+	shm_mix_attach(dev);
+
+	ep[count++] = cd->ctx;
+	for (i = 0; i < PLUG_MIX_MAX_CLIENTS; i++) {
+		if (!(cd->mix_mapped & BIT(i)))
+			continue;
+
+		client = cd->mix_shm[i].addr;
+		if (client->state == SOF_PLUGIN_STATE_STREAM_RUNNING &&
+		    client->frame_size == (int)frame_bytes)
+			ep[count++] = client;
+	}
+
+	for (i = 0; i < count; i++)
+		bytes = MAX(bytes, (uint32_t)plug_ep_get_avail(ep[i]));
+
+	period_bytes = (uint64_t)audio_stream_get_rate(sink) * dev->pipeline->period /
+		       1000000 * frame_bytes;
+	if (period_bytes)
+		bytes = MIN(bytes, period_bytes);
+	bytes = MIN(bytes, audio_stream_get_free_bytes(sink));
+
+	if (bytes) {
+		audio_stream_set_zero(sink, bytes);
+		for (i = 0; i < count; i++)
+			shm_mix_add(sink, ep[i], MIN(bytes, (uint32_t)plug_ep_get_avail(ep[i])));
+		comp_update_buffer_produce(buffer, bytes);
+	}
+
+	/* the own client is woken through the pipeline semaphores */
+	shm_ep_update(dev);
+	for (i = 1; i < count; i++) {
+		if (atomic_exchange(&ep[i]->plug_wait, 0))
+			sem_post(&ep[i]->wake);
+	}
+
+	/*
+	 * Only sleep when no client has data left. Any attached client may be
+	 * the next one to write, so all of them get the wait flag before their
+	 * rings are checked again.
+	 */
+	if (bytes)
+		pd->starved = false;
+	for (i = 0; i < PLUG_MIX_MAX_CLIENTS && pd->starved; i++) {
+		if (!(cd->mix_mapped & BIT(i)))
+			continue;
+
+		client = cd->mix_shm[i].addr;
+		atomic_store(&client->pipe_wait, 1);
+		if (plug_ep_get_avail(client))
+			pd->starved = false;
+	}
+
+	return 0;
+}
+
 /*
  * copy from local SOF buffer to remote SHM buffer
  */
@@ -246,6 +592,9 @@ static int shmread_copy(struct comp_dev *dev)
 	void *rptr;
 	void *dest;
 
+	if (cd->ring_buffer)
+		return shm_ring_sync(dev);
+
 	/* local SOF source buffer */
 	buffer = comp_dev_get_first_data_producer(dev);
 	source = &buffer->stream;
@@ -286,6 +635,8 @@ static int shmread_copy(struct comp_dev *dev)
 	comp_update_buffer_consume(buffer, total);
 	comp_dbg(dev, "wrote %d bytes", total);
 
+	shm_ep_update(dev);
+
 	return 0;
 }
 
@@ -304,6 +655,12 @@ static int shmwrite_copy(struct comp_dev *dev)
 	void *wptr;
 	void *src;
 
+	if (cd->ring_buffer)
+		return shm_ring_sync(dev);
+
+	if (ctx->mix)
+		return shm_mix_copy(dev);
+
 	/* local SOF sink buffer */
 	buffer = comp_dev_get_first_data_consumer(dev);
 	sink = &buffer->stream;
@@ -344,6 +701,8 @@ static int shmwrite_copy(struct comp_dev *dev)
 	comp_update_buffer_produce(buffer, total);
 	comp_dbg(dev, "read %d bytes", total);
 
+	shm_ep_update(dev);
+
 	return 0;
 }
 
@@ -351,6 +710,7 @@ static int shm_prepare(struct comp_dev *dev)
 {
 	struct shm_comp_data *cd = comp_get_drvdata(dev);
 	struct plug_shm_endpoint *ctx = cd->ctx;
+	struct comp_buffer *buffer;
 	int ret = 0;
 
 	comp_dbg(dev, "shm prepare_copy()");
@@ -364,6 +724,14 @@ static int shm_prepare(struct comp_dev *dev)
 	if (ret == COMP_STATUS_STATE_ALREADY_SET)
 		return PPL_STATUS_PATH_STOP;
 
+	/* the plugin has set the ring size and frame size in hw_params */
+	if (dev->direction == SOF_IPC_STREAM_PLAYBACK)
+		buffer = comp_dev_get_first_data_consumer(dev);
+	else
+		buffer = comp_dev_get_first_data_producer(dev);
+	if (buffer && !ctx->mix)
+		shm_ring_map(dev, buffer);
+
 	return ret;
 }
 
@@ -373,6 +741,7 @@ static int shm_reset(struct comp_dev *dev)
 	struct plug_shm_endpoint *ctx = cd->ctx;
 
 	comp_set_state(dev, COMP_TRIGGER_RESET);
+	shm_ring_unmap(cd);
 	ctx->state = SOF_PLUGIN_STATE_INIT;
 
 	return 0;
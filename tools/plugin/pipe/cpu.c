@@ -105,6 +105,35 @@ int pipe_set_affinity(struct sof_pipe *sp)
 	return 0;
 }
 
+/*
+ * Pin the calling LL domain thread to the host CPU matching its DSP core, so
+ * that a domain keeps its caches warm and domains don't compete for a CPU.
+ * With an E or P core selected all threads already inherit that single CPU.
+ */
+int pipe_set_core_affinity(struct sof_pipe *sp, int core)
+{
+	cpu_set_t cpuset;
+	long core_count = sysconf(_SC_NPROCESSORS_ONLN);
+	int cpu;
+	int err;
+
+	if (sp->use_E_core || sp->use_P_core || core_count <= 0)
+		return 0;
+
+	cpu = core % core_count;
+	CPU_ZERO(&cpuset);
+	CPU_SET(cpu, &cpuset);
+
+	err = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+	if (err != 0) {
+		fprintf(sp->log, "error: failed to pin core %d LL thread to CPU %d: %s\n",
+			core, cpu, strerror(err));
+		return -err;
+	}
+
+	return 0;
+}
+
 /* set ipc thread to low priority */
 int pipe_set_ipc_lowpri(struct sof_pipe *sp)
 {
@@ -177,6 +206,14 @@ int pipe_set_rt(struct sof_pipe *sp)
 				err, strerror(errno));
 			return err;
 		}
+
+		/* and apply it to the calling thread */
+		err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+		if (err) {
+			fprintf(sp->log, "error: can't set thread RT priority %d %s\n",
+				err, strerror(err));
+			return -err;
+		}
 	} else {
 		fprintf(sp->log, "error: no elevated privileges for RT. uid %d euid %d\n",
 			uid, euid);
@@ -387,13 +387,33 @@ int pipe_ipc_process(struct sof_pipe *sp, struct plug_socket_desc *ipc_socket)
 	/* let main() know we are ready */
 	fprintf(sp->log, "sof-pipe: IPC %s socket ready\n", ipc_socket->path);
 
-	/* main PCM IPC handling loop */
+	/* main PCM IPC handling loop, until a signal asks for shutdown */
 	while (1) {
+		struct pollfd fds[2] = {
+			{ .fd = ipc_socket->socket_fd, .events = POLLIN },
+			{ .fd = sp->shutdown_pipe[0], .events = POLLIN },
+		};
+		unsigned char sig;
 		int clientfd, i;
 
+		if (poll(fds, ARRAY_SIZE(fds), -1) < 0) {
+			if (errno == EINTR)
+				continue;
+			fprintf(sp->log, "IPC %s socket poll failed\n", ipc_socket->path);
+			return -errno;
+		}
+
+		if (fds[1].revents) {
+			if (read(sp->shutdown_pipe[0], &sig, sizeof(sig)) == sizeof(sig))
+				fprintf(sp->log, "Pipe caught signal %d - shutdown\n", sig);
+			break;
+		}
+
 		/* Accept a connection from a client */
 		clientfd = accept(ipc_socket->socket_fd, NULL, NULL);
 		if (clientfd == -1) {
+			if (errno == EINTR)
+				continue;
 			fprintf(sp->log, "IPC %s socket accept failed\n", ipc_socket->path);
 			return -errno;
 		}
@@ -47,11 +47,11 @@ static void shutdown(struct sof_pipe *sp)
 	shm_unlink(sp->shm_context.name);
 
 	/* cancel all threads, free locks and message queues */
+	pipe_ll_stop_all(sp);
 	for (i = 0; i < sp->pipe_thread_count; i++) {
 		struct pipethread_data *pd = &pipeline_ctx[i];
 
 		pthread_cancel(pd->ipc_thread);
-		pthread_cancel(pd->pcm_thread);
 		plug_lock_free(&pd->ready);
 		plug_lock_free(&pd->done);
 	}
@@ -60,31 +60,42 @@ static void shutdown(struct sof_pipe *sp)
 	plug_socket_free(&sp->ipc_socket);
 
 	pthread_mutex_destroy(&sp->ipc_lock);
+	pthread_mutex_destroy(&sp->copy_lock);
+
+	if (sp->shutdown_pipe[0]) {
+		close(sp->shutdown_pipe[0]);
+		close(sp->shutdown_pipe[1]);
+	}
 
 	fflush(sp->log);
 	fflush(stdout);
 	fflush(stderr);
 }
 
-/* signals from the ALSA PCM plugin or something has gone wrong */
+/*
+ * Signals from the ALSA PCM plugin or something has gone wrong. Only async
+ * signal safe calls here, the IPC loop in the main thread is woken up and
+ * shuts down.
+ */
 static void signal_handler(int sig)
 {
-	switch (sig) {
-	case SIGTERM:
-		fprintf(_sp->log, "Pipe caught SIGTERM - shutdown\n");
-		break;
-	case SIGINT:
-		fprintf(_sp->log, "Pipe caught SIGINT - shutdown\n");
-		break;
-	default:
-		fprintf(_sp->log, "Pipe caught signal %d, something went wrong\n", sig);
-		break;
+	static const char fault[] = "Pipe caught SIGSEGV, something went wrong\n";
+	unsigned char msg = sig;
+	int saved_errno = errno;
+	ssize_t ret;
+
+	if (sig == SIGSEGV) {
+		/* can't return to the fault, lingering files are cleaned up on next start */
+		ret = write(STDERR_FILENO, fault, sizeof(fault) - 1);
+		signal(sig, SIG_DFL);
+		raise(sig);
+		return;
 	}
-	fprintf(_sp->log, "Pipe shutdown signal\n");
 
-	/* try and clean up if we can */
-	shutdown(_sp);
-	exit(EXIT_FAILURE);
+	/* the pipe is non-blocking, if it is full a shutdown is pending anyway */
+	ret = write(_sp->shutdown_pipe[1], &msg, sizeof(msg));
+	(void)ret;
+	errno = saved_errno;
 }
 
 static int pipe_init_signals(struct sof_pipe *sp)
@@ -92,6 +103,13 @@ static int pipe_init_signals(struct sof_pipe *sp)
 	struct sigaction *action = &sp->action;
 	int err;
 
+	err = pipe2(sp->shutdown_pipe, O_NONBLOCK | O_CLOEXEC);
+	if (err < 0) {
+		fprintf(sp->log, "failed to create shutdown pipe: %s",
+			strerror(errno));
+		return err;
+	}
+
 	/*
 	 * signals - currently only check for SIGCHLD. TODO: handle more
 	 */
@@ -222,6 +240,7 @@ void plug_socket_free(struct plug_socket_desc *ipc)
  * -p Force run on P core
  * -e Force run on E core
  * -t topology name.
+ * -m mix playback clients joining a running PCM into its pipeline
  * -L log file (otherwise stdout)
  * -h help
  */
@@ -242,7 +261,7 @@ int main(int argc, char *argv[], char *env[])
 	_sp = &sp;
 
 	/* parse all args */
-	while ((option = getopt(argc, argv, "hD:RpeT:")) != -1) {
+	while ((option = getopt(argc, argv, "hD:RpeT:m")) != -1) {
 		switch (option) {
 		/* Alsa device  */
 		case 'D':
@@ -262,6 +281,9 @@ int main(int argc, char *argv[], char *env[])
 		case 'T':
 			snprintf(sp.topology_name, NAME_SIZE, "%s", optarg);
 			break;
+		case 'm':
+			sp.mix_clients = 1;
+			break;
 
 		/* print usage */
 		default:
@@ -286,6 +308,13 @@ int main(int argc, char *argv[], char *env[])
 		exit(EXIT_FAILURE);
 	}
 
+	/* pipeline copy serialisation mutex */
+	ret = pthread_mutex_init(&sp.copy_lock, NULL);
+	if (ret < 0) {
+		fprintf(sp.log, "error: cant create mutex %s\n",  strerror(errno));
+		exit(EXIT_FAILURE);
+	}
+
 	fprintf(sp.log, "sof-pipe-%s: using topology %s\n", VERSION, sp.topology_name);
 
 	/* set CPU affinity */
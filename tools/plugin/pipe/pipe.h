@@ -10,10 +10,12 @@
 
 #include <stdatomic.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <pthread.h>
 #include <signal.h>
 
 #include <alsa/asoundlib.h>
+#include <sof/list.h>
 #include <tplg_parser/topology.h>
 #include <tplg_parser/tokens.h>
 #include "common.h"
@@ -24,8 +26,11 @@ struct sof_pipe;
 #define MAX_PIPE_THREADS	128
 #define MAX_PIPELINES	32
 
+#define PIPE_LL_MAX_CORES	8
+#define PIPE_LL_TICK_US		1000
+#define PIPE_LL_STOP_TIMEOUT_MS	100	/* max wait for the LL threads at shutdown */
+
 struct pipethread_data {
-	pthread_t pcm_thread;
 	pthread_t ipc_thread;
 	struct sof_pipe *sp;
 	struct pipeline *pcm_pipeline;
@@ -33,6 +38,20 @@ struct pipethread_data {
 	struct plug_sem_desc ready;
 	struct plug_sem_desc done;
 	atomic_int pipe_users;
+	bool starved;		/* endpoint has no data or room, wait for ready */
+
+	/* LL domain scheduling */
+	struct list_item list;	/* in the pipelines of the core domain */
+	uint32_t period_ticks;	/* run every period_ticks domain ticks */
+	uint32_t ticks;		/* ticks left until the next run */
+};
+
+/* timer driven LL domain running the active pipelines of one core */
+struct pipe_ll_domain {
+	pthread_t thread;
+	struct list_item pipelines;	/* in schedule order */
+	bool running;
+	int core;
 };
 
 struct sof_pipe_module {
@@ -49,9 +68,11 @@ struct sof_pipe {
 	int use_E_core;
 	int capture;
 	int file_mode;
+	int mix_clients;	/* playback clients can join a running PCM */
 	int pipe_thread_count;
 
 	struct sigaction action;
+	int shutdown_pipe[2];	/* signal handler wakes up the IPC loop to shut down */
 
 	/* SHM for stream context sync */
 	struct plug_shm_desc shm_context;
@@ -59,6 +80,13 @@ struct sof_pipe {
 
 	FILE *log;
 	pthread_mutex_t ipc_lock;
+	/*
+	 * Pipelines share buffers, copy one at a time. This is global, not per
+	 * core: the posix spinlocks of the SOF code run here are no-ops, so
+	 * cross-core buffers, notifiers and heaps rely on it.
+	 */
+	pthread_mutex_t copy_lock;
+	struct pipe_ll_domain ll_domain[PIPE_LL_MAX_CORES];	/* protected by copy_lock */
 	struct tplg_context tplg;
 	struct tplg_comp_info *comp_list;
 	struct list_item widget_list; /* list of widgets */
@@ -89,11 +117,12 @@ int pipe_thread_new(struct sof_pipe *sp, struct pipeline *p);
 int pipe_thread_free(struct sof_pipe *sp, int pipeline_id);
 int pipe_thread_start(struct sof_pipe *sp, struct pipeline *p);
 int pipe_thread_stop(struct sof_pipe *sp, struct pipeline *p);
+void pipe_ll_stop_all(struct sof_pipe *sp);
 int pipe_sof_setup(struct sof *sof);
 int pipe_kcontrol_cb_new(struct snd_soc_tplg_ctl_hdr *tplg_ctl,
 			 void *comp, void *arg);
 
-/* set pipeline to realtime priority */
+/* set the calling pipeline thread to realtime priority */
 int pipe_set_rt(struct sof_pipe *sp);
 
 /* set ipc thread to low priority */
@@ -106,6 +135,9 @@ void pipe_ipc_free(struct sof_pipe *sp);
 
 int pipe_set_affinity(struct sof_pipe *sp);
 
+/* pin the calling LL domain thread to the host CPU of its DSP core */
+int pipe_set_core_affinity(struct sof_pipe *sp, int core);
+
 int pipe_ipc_message(struct sof_pipe *sp, void *mailbox, size_t bytes);
 
 int pipe_ipc_do(struct sof_pipe *sp, void *mailbox, size_t bytes);
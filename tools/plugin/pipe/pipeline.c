@@ -8,6 +8,7 @@
  * SOF pipeline in userspace.
  */
 
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <sys/poll.h>
 #include <string.h>
@@ -80,85 +81,224 @@ int pipe_sof_setup(struct sof *sof)
 	return 0;
 }
 
-static inline int pipe_copy_ready(struct pipethread_data *pd)
+/*
+ * LL domain
+ *
+ * Like the LL scheduler in firmware, each core has one thread that wakes up
+ * every PIPE_LL_TICK_US and runs the active pipelines of that core in
+ * priority order. Pipelines with a longer period run every few ticks.
+ */
+
+/* wait for the next tick, do not try to catch up when more than a tick late */
+static int pipe_ll_wait(struct timespec *next)
 {
-	struct timespec delay;
+	struct timespec now;
 	int err;
 
-	/* get the current time for source delay */
-	err = clock_gettime(CLOCK_REALTIME, &delay);
-	if (err == -1) {
-		fprintf(_sp->log, "shm: cant get time: %s", strerror(errno));
-		return -errno;
+	next->tv_nsec += PIPE_LL_TICK_US * 1000L;
+	while (next->tv_nsec >= 1000000000L) {
+		next->tv_nsec -= 1000000000L;
+		next->tv_sec++;
 	}
 
-	// TODO get from rate
-	plug_timespec_add_ms(&delay, 2000);
-
-	/* wait for data from source */
-	err = sem_timedwait(pd->ready.sem, &delay);
-	if (err == -1) {
-		fprintf(_sp->log, "%s %d: fatal timeout: %s on %s\n", __FILE__, __LINE__,
-			strerror(errno), pd->ready.name);
-		return -errno;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	if (plug_timespec_delta_ns(next, &now) > PIPE_LL_TICK_US * 1000L) {
+		*next = now;
+		return 0;
 	}
 
+	err = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, next, NULL);
+	if (err && err != EINTR)
+		return -err;
+
 	return 0;
 }
 
-static inline void pipe_copy_done(struct pipethread_data *pd)
+/* run one pipeline, called with the copy lock held */
+static void pipe_ll_run(struct pipethread_data *pd)
 {
-	/* tell peer we are done */
-	sem_post(pd->done.sem);
+	int err;
+
+	if (pd->pcm_pipeline->status != COMP_STATE_ACTIVE)
+		return;
+
+	/* a starved pipeline is skipped until its client posts ready */
+	if (pd->starved && sem_trywait(pd->ready.sem) < 0)
+		return;
+
+	pd->starved = false;
+	err = pipeline_copy(pd->pcm_pipeline);
+	if (!err)
+		return;
+
+	if (err < 0)
+		fprintf(_sp->log, "pipeline %d copy error %d\n",
+			pd->pcm_pipeline->pipeline_id, err);
+	else
+		fprintf(_sp->log, "pipeline %d complete %d\n",
+			pd->pcm_pipeline->pipeline_id, err);
+
+	/* stop scheduling it, same as the pipeline thread exiting used to */
+	list_item_del(&pd->list);
+	list_init(&pd->list);
 }
 
-static void *pipe_process_thread(void *arg)
+static void *pipe_ll_thread(void *arg)
 {
-	struct pipethread_data *pd = arg;
+	struct pipe_ll_domain *domain = arg;
+	struct sof_pipe *sp = _sp;
+	struct pipethread_data *pd;
+	struct list_item *item, *tmp;
+	struct timespec next;
 	int err;
 
-	fprintf(_sp->log, "pipe thread started for pipeline %d\n",
-		pd->pcm_pipeline->pipeline_id);
+	fprintf(sp->log, "LL domain thread started for core %d\n", domain->core);
+
+	pipe_set_core_affinity(sp, domain->core);
+
+	if (sp->realtime)
+		pipe_set_rt(sp);
+
+	clock_gettime(CLOCK_MONOTONIC, &next);
 
 	do {
-		if (pd->pcm_pipeline->status != COMP_STATE_ACTIVE) {
-			fprintf(_sp->log, "pipe state non active %d\n",
-				pd->pcm_pipeline->status);
-			break;
+		/* dont cancel while holding the copy lock */
+		pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
+		pthread_mutex_lock(&sp->copy_lock);
+
+		list_for_item_safe(item, tmp, &domain->pipelines) {
+			pd = container_of(item, struct pipethread_data, list);
+
+			if (--pd->ticks)
+				continue;
+
+			pd->ticks = pd->period_ticks;
+			pipe_ll_run(pd);
 		}
 
-		if (pd->pipe_users <= 0) {
-			fprintf(_sp->log, "pipe no users.\n");
-			break;
+		pthread_mutex_unlock(&sp->copy_lock);
+		pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
+
+		err = pipe_ll_wait(&next);
+	} while (!err);
+
+	fprintf(sp->log, "LL domain thread for core %d wait error %d\n", domain->core, err);
+	return NULL;
+}
+
+/* add the pipeline in priority order, same priority served first come first */
+static void pipe_ll_insert(struct pipe_ll_domain *domain, struct pipethread_data *pd)
+{
+	struct pipethread_data *iter;
+	struct list_item *item;
+
+	list_for_item(item, &domain->pipelines) {
+		iter = container_of(item, struct pipethread_data, list);
+		if (pd->pcm_pipeline->priority < iter->pcm_pipeline->priority) {
+			list_item_append(&pd->list, &iter->list);
+			return;
 		}
+	}
 
-		/* wait for pipe to be ready */
-		err = pipe_copy_ready(pd);
-		if (err < 0) {
-			fprintf(_sp->log, "pipe ready timeout on pipeline %d state %d users %d\n",
-				pd->pcm_pipeline->pipeline_id, pd->pcm_pipeline->status,
-				pd->pipe_users);
-			break;
+	list_item_append(&pd->list, &domain->pipelines);
+}
+
+static int pipe_ll_add(struct sof_pipe *sp, struct pipethread_data *pd)
+{
+	struct pipeline *p = pd->pcm_pipeline;
+	struct pipe_ll_domain *domain;
+	bool start;
+	int ret;
+
+	if (p->core >= PIPE_LL_MAX_CORES) {
+		fprintf(sp->log, "error: pipeline ID %d core %d out of range\n",
+			p->pipeline_id, p->core);
+		return -EINVAL;
+	}
+	domain = &sp->ll_domain[p->core];
+
+	pd->period_ticks = MAX(p->period / PIPE_LL_TICK_US, 1);
+	pd->ticks = 1;
+	pd->starved = false;
+
+	pthread_mutex_lock(&sp->copy_lock);
+	if (!domain->running)
+		list_init(&domain->pipelines);
+	pipe_ll_insert(domain, pd);
+	start = !domain->running;
+	domain->running = true;
+	domain->core = p->core;
+
+	/*
+	 * First pipeline on this core so start its LL domain thread. The thread
+	 * handle is only written and read under the lock, the thread itself
+	 * waits for the lock before its first tick.
+	 */
+	if (start) {
+		ret = pthread_create(&domain->thread, NULL, pipe_ll_thread, domain);
+		if (ret) {
+			fprintf(sp->log, "failed to create LL thread: %s\n", strerror(ret));
+			list_item_del(&pd->list);
+			domain->running = false;
+			pthread_mutex_unlock(&sp->copy_lock);
+			return -ret;
 		}
+	}
+	pthread_mutex_unlock(&sp->copy_lock);
 
-		/* sink has read data so now generate more it */
-		err = pipeline_copy(pd->pcm_pipeline);
+	return 0;
+}
 
-		pipe_copy_done(pd);
+static void pipe_ll_remove(struct sof_pipe *sp, struct pipethread_data *pd)
+{
+	struct pipe_ll_domain *domain = &sp->ll_domain[pd->pcm_pipeline->core];
+	pthread_t thread;
+	bool stop;
+
+	pthread_mutex_lock(&sp->copy_lock);
+	list_item_del(&pd->list);
+	list_init(&pd->list);
+	stop = domain->running && list_is_empty(&domain->pipelines);
+	if (stop) {
+		domain->running = false;
+		thread = domain->thread;
+	}
+	pthread_mutex_unlock(&sp->copy_lock);
+
+	/* last pipeline on this core, the thread only stops while sleeping */
+	if (stop) {
+		pthread_cancel(thread);
+		pthread_join(thread, NULL);
+		fprintf(sp->log, "LL domain thread for core %d stopped\n", domain->core);
+	}
+}
 
-		if (err < 0) {
-			fprintf(_sp->log, "pipe thread error %d\n", err);
-			break;
-		} else if (err > 0) {
-			fprintf(_sp->log, "pipe thread complete %d\n", err);
-			break;
+void pipe_ll_stop_all(struct sof_pipe *sp)
+{
+	pthread_t threads[PIPE_LL_MAX_CORES];
+	struct timespec timeout;
+	int count = 0;
+	int i;
+
+	pthread_mutex_lock(&sp->copy_lock);
+	for (i = 0; i < PIPE_LL_MAX_CORES; i++) {
+		if (sp->ll_domain[i].running) {
+			threads[count++] = sp->ll_domain[i].thread;
+			sp->ll_domain[i].running = false;
 		}
+	}
+	pthread_mutex_unlock(&sp->copy_lock);
 
-	} while (1);
+	for (i = 0; i < count; i++)
+		pthread_cancel(threads[i]);
 
-	fprintf(_sp->log, "pipe complete for pipeline %d\n",
-		pd->pcm_pipeline->pipeline_id);
-	return 0;
+	/* don't let a stuck thread hang the shutdown */
+	clock_gettime(CLOCK_REALTIME, &timeout);
+	plug_timespec_add_ms(&timeout, PIPE_LL_STOP_TIMEOUT_MS);
+	for (i = 0; i < count; i++) {
+		if (pthread_timedjoin_np(threads[i], NULL, &timeout))
+			fprintf(sp->log, "error: LL domain thread did not stop\n");
+	}
 }
 
 static void *pipe_ipc_process_thread(void *arg)
@@ -203,22 +343,21 @@ int pipe_thread_start(struct sof_pipe *sp, struct pipeline *p)
 	}
 	pd = &pipeline_ctx[pipeline_id];
 
-	/* only create thread if not active */
+	/* only schedule if not active */
 	pipe_users = atomic_fetch_add(&pd->pipe_users, 1);
 	if (pipe_users > 0) {
-		fprintf(_sp->log, "pipeline ID %d thread already running %d users\n",
+		fprintf(_sp->log, "pipeline ID %d already scheduled %d users\n",
 			pipeline_id, pipe_users);
 		return 0;
 	}
 
-	fprintf(_sp->log, "pipeline ID %d thread not running so starting...\n", pipeline_id);
+	fprintf(_sp->log, "pipeline ID %d not scheduled so adding to LL domain...\n",
+		pipeline_id);
 
-	/* first user so start the PCM pipeline thread */
-	ret = pthread_create(&pd->pcm_thread, NULL, pipe_process_thread, pd);
-	if (ret < 0) {
-		fprintf(_sp->log, "failed to create PCM thread: %s\n", strerror(errno));
-		return -errno;
-	}
+	/* first user so run the pipeline in the LL domain of its core */
+	ret = pipe_ll_add(sp, pd);
+	if (ret < 0)
+		atomic_fetch_sub(&pd->pipe_users, 1);
 
 	return ret;
 }
@@ -228,7 +367,7 @@ int pipe_thread_stop(struct sof_pipe *sp, struct pipeline *p)
 	struct pipethread_data *pipeline_ctx = sp->pipeline_ctx;
 	struct pipethread_data *pd;
 	int pipeline_id;
-	int ret, pipe_users;
+	int pipe_users;
 
 	pipeline_id = p->pipeline_id;
 
@@ -247,23 +386,19 @@ int pipe_thread_stop(struct sof_pipe *sp, struct pipeline *p)
 	}
 	pd = &pipeline_ctx[pipeline_id];
 
-	/* only join thread if not active */
+	/* only remove if not active */
 	pipe_users = atomic_fetch_sub(&pd->pipe_users, 1);
 	if (pipe_users != 1) {
-		fprintf(_sp->log, "pipeline ID %d thread has multiple %d users\n",
+		fprintf(_sp->log, "pipeline ID %d has multiple %d users\n",
 			pipeline_id, pipe_users);
 		return 0;
 	}
 
-	fprintf(_sp->log, "pipeline ID %d thread can be stopped...\n", pipeline_id);
+	fprintf(_sp->log, "pipeline ID %d can be removed from LL domain...\n", pipeline_id);
 
-	ret = pthread_cancel(pd->pcm_thread);
-	if (ret < 0) {
-		fprintf(_sp->log, "failed to cancel PCM thread: %s\n", strerror(errno));
-		return -errno;
-	}
+	pipe_ll_remove(sp, pd);
 
-	return ret;
+	return 0;
 }
 
 int pipe_thread_new(struct sof_pipe *sp, struct pipeline *p)
@@ -289,6 +424,7 @@ int pipe_thread_new(struct sof_pipe *sp, struct pipeline *p)
 	pd = &pipeline_ctx[p->pipeline_id];
 	pd->sp = _sp;
 	pd->pcm_pipeline = p;
+	list_init(&pd->list);
 
 	/* init names of shared resources */
 	ret = plug_lock_init(&pd->ready, _sp->topology_name, "ready", p->pipeline_id);
@@ -15,6 +15,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <sys/stat.h>
 
 #include <ipc/probe_dma_frame.h>
 
@@ -23,12 +24,16 @@
 #define APP_NAME "sof-probes"
 
 #define PACKET_MAX_SIZE	4096	/**< Size limit for probe data packet */
-#define DATA_READ_LIMIT 4096	/**< Data limit for file read */
+#define DATA_READ_LIMIT (64 * 1024)	/**< Data limit for file read */
 #define FILES_LIMIT	32	/**< Maximum num of probe output files */
 #define FILE_PATH_LIMIT 128	/**< Path limit for probe output files */
+#define FILE_BUFFER_SIZE (1024 * 1024)	/**< stdio buffer of each output file */
+#define STREAM_SIZE_UNKNOWN UINT32_MAX	/**< WAV sizes for a live stream */
 
 struct wave_files {
 	FILE *fd;
+	char *buffer;		/* stdio buffer of a regular output file */
+	bool stream;		/* stdout or FIFO, flushed per packet, no seek */
 	uint32_t buffer_id;
 	uint32_t fmt;
 	uint32_t size;
@@ -43,9 +48,13 @@ enum p_state {
 
 struct dma_frame_parser {
 	bool log_to_stdout;
+	bool stream_to_stdout;			/* audio of stream_buffer_id to stdout */
+	uint32_t stream_buffer_id;
 	enum p_state state;
 	struct probe_data_packet *packet;
 	size_t packet_size;
+	uint8_t *unpacked;			/* Data of a delta packed packet */
+	size_t unpacked_size;
 	uint8_t *w_ptr;				/* Write pointer to copy data to */
 	uint32_t total_data_to_copy;		/* Total bytes left to copy */
 	int start;				/* Start of unfilled data */
@@ -81,6 +90,13 @@ int get_buffer_file_free(struct wave_files *files)
 	return -1;
 }
 
+static bool is_regular_file(FILE *fd)
+{
+	struct stat st;
+
+	return !fstat(fileno(fd), &st) && S_ISREG(st.st_mode);
+}
+
 bool is_audio_format(uint32_t format)
 {
 	return (format & PROBE_MASK_FMT_TYPE) != 0 && (format & PROBE_MASK_AUDIO_FMT) == 0;
@@ -89,6 +105,7 @@ bool is_audio_format(uint32_t format)
 int init_wave(struct dma_frame_parser *p, uint32_t buffer_id, uint32_t format)
 {
 	bool audio = is_audio_format(format);
+	uint32_t decimation = ((format & PROBE_MASK_DECIMATION) >> PROBE_SHIFT_DECIMATION) + 1;
 	char path[FILE_PATH_LIMIT];
 	int i;
 
@@ -102,15 +119,26 @@ int init_wave(struct dma_frame_parser *p, uint32_t buffer_id, uint32_t format)
 
 	fprintf(stderr, "%s:\t Creating file %s\n", APP_NAME, path);
 
-	if (!audio && p->log_to_stdout) {
+	if ((!audio && p->log_to_stdout) ||
+	    (audio && p->stream_to_stdout && buffer_id == p->stream_buffer_id)) {
 		p->files[i].fd = stdout;
+		p->files[i].stream = true;
 	} else {
+		/* opening a FIFO blocks until its reader is there */
 		p->files[i].fd = fopen(path, "wb");
 		if (!p->files[i].fd) {
 			fprintf(stderr, "error: unable to create file %s, error %d\n",
 				path, errno);
 			exit(0);
 		}
+		p->files[i].stream = !is_regular_file(p->files[i].fd);
+	}
+
+	/* a large buffer per file, packets of all probe points interleave */
+	if (!p->files[i].stream) {
+		p->files[i].buffer = malloc(FILE_BUFFER_SIZE);
+		if (p->files[i].buffer)
+			setvbuf(p->files[i].fd, p->files[i].buffer, _IOFBF, FILE_BUFFER_SIZE);
 	}
 
 	p->files[i].buffer_id = buffer_id;
@@ -125,7 +153,8 @@ int init_wave(struct dma_frame_parser *p, uint32_t buffer_id, uint32_t format)
 	p->files[i].header.fmt.subchunk_size = 16;
 	p->files[i].header.fmt.audio_format = 1;
 	p->files[i].header.fmt.num_channels = ((format & PROBE_MASK_NB_CHANNELS) >> PROBE_SHIFT_NB_CHANNELS) + 1;
-	p->files[i].header.fmt.sample_rate = sample_rate[(format & PROBE_MASK_SAMPLE_RATE) >> PROBE_SHIFT_SAMPLE_RATE];
+	p->files[i].header.fmt.sample_rate = sample_rate[(format & PROBE_MASK_SAMPLE_RATE) >> PROBE_SHIFT_SAMPLE_RATE] /
+					  decimation;
 	p->files[i].header.fmt.bits_per_sample = (((format & PROBE_MASK_CONTAINER_SIZE) >> PROBE_SHIFT_CONTAINER_SIZE) + 1) * 8;
 	p->files[i].header.fmt.byte_rate = p->files[i].header.fmt.sample_rate *
 					p->files[i].header.fmt.num_channels *
@@ -134,6 +163,12 @@ int init_wave(struct dma_frame_parser *p, uint32_t buffer_id, uint32_t format)
 					  p->files[i].header.fmt.bits_per_sample / 8;
 	p->files[i].header.data.subchunk_id = HEADER_DATA;
 
+	/* a stream can't be rewound to fill in the sizes */
+	if (p->files[i].stream) {
+		p->files[i].header.riff.chunk_size = STREAM_SIZE_UNKNOWN;
+		p->files[i].header.data.subchunk_size = STREAM_SIZE_UNKNOWN;
+	}
+
 	fwrite(&p->files[i].header, sizeof(struct wave), 1, p->files[i].fd);
 
 	return i;
@@ -148,10 +183,10 @@ void finalize_wave_files(struct dma_frame_parser *p)
 	/* and close all opened files */
 	/* check wave struct to understand the offsets */
 	for (i = 0; i < FILES_LIMIT; i++) {
-		if (!is_audio_format(files[i].fmt))
+		if (!files[i].fd)
 			continue;
 
-		if (files[i].fd) {
+		if (is_audio_format(files[i].fmt) && !files[i].stream) {
 			chunk_size = files[i].size + sizeof(struct wave) -
 				     offsetof(struct riff_chunk, format);
 
@@ -161,9 +196,15 @@ void finalize_wave_files(struct dma_frame_parser *p)
 			      offsetof(struct data_subchunk, subchunk_size),
 			      SEEK_SET);
 			fwrite(&files[i].size, sizeof(uint32_t), 1, files[i].fd);
+		}
 
+		if (files[i].fd == stdout)
+			fflush(stdout);
+		else
 			fclose(files[i].fd);
-		}
+		files[i].fd = NULL;
+		free(files[i].buffer);
+		files[i].buffer = NULL;
 	}
 }
 
@@ -190,6 +231,95 @@ int validate_data_packet(struct probe_data_packet *packet)
 	return 0;
 }
 
+/*
+ * Undo the delta packing of the packet data, see PROBE_MASK_PACKING.
+ * Returns the size of the samples in p->unpacked or a negative error
+ * for corrupted data.
+ */
+static int unpack_data(struct dma_frame_parser *p)
+{
+	uint32_t format = p->packet->format;
+	uint32_t channels = ((format & PROBE_MASK_NB_CHANNELS) >> PROBE_SHIFT_NB_CHANNELS) + 1;
+	uint32_t container = ((format & PROBE_MASK_CONTAINER_SIZE) >>
+			      PROBE_SHIFT_CONTAINER_SIZE) + 1;
+	const uint8_t *in = p->packet->data;
+	const uint8_t *end = in + p->packet->data_size_bytes;
+	size_t size = (size_t)p->packet->data_size_bytes * container;
+	uint32_t prev[32] = { 0 };
+	uint32_t zigzag;
+	uint32_t ch = 0;
+	uint8_t *temp;
+	uint8_t *out;
+	int shift;
+
+	/* a packed sample takes a byte at least */
+	if (size > p->unpacked_size) {
+		temp = realloc(p->unpacked, size);
+		if (!temp)
+			return -ENOMEM;
+
+		p->unpacked = temp;
+		p->unpacked_size = size;
+	}
+
+	out = p->unpacked;
+	while (in < end) {
+		zigzag = 0;
+		shift = 0;
+		do {
+			if (in == end || shift > 28)
+				return -EINVAL;
+			zigzag |= (uint32_t)(*in & 0x7f) << shift;
+			shift += 7;
+		} while (*in++ & 0x80);
+
+		prev[ch] += (zigzag >> 1) ^ -(zigzag & 1);
+		/* little endian, the low container bytes */
+		memcpy(out, &prev[ch], container);
+		out += container;
+		ch = (ch + 1) % channels;
+	}
+
+	return out - p->unpacked;
+}
+
+/* Write the audio or logging data of a valid packet to its file */
+static int write_packet(struct dma_frame_parser *p)
+{
+	const uint8_t *data = p->packet->data;
+	int size = p->packet->data_size_bytes;
+	int file = get_buffer_file(p->files, p->packet->buffer_id);
+
+	if (file < 0)
+		file = init_wave(p, p->packet->buffer_id, p->packet->format);
+
+	if (file < 0) {
+		fprintf(stderr, "unable to open file for %u\n", p->packet->buffer_id);
+		return -EIO;
+	}
+
+	if (is_audio_format(p->packet->format) &&
+	    (p->packet->format & PROBE_MASK_PACKING)) {
+		size = unpack_data(p);
+		if (size == -ENOMEM)
+			return size;
+		if (size < 0) {
+			fprintf(stderr, "Packed data error in packet of buffer %u\n",
+				p->packet->buffer_id);
+			return 0;
+		}
+		data = p->unpacked;
+	}
+
+	fwrite(data, 1, size, p->files[file].fd);
+	p->files[file].size += size;
+	/* keep a live consumer fed */
+	if (p->files[file].stream)
+		fflush(p->files[file].fd);
+
+	return 0;
+}
+
 int process_sync(struct dma_frame_parser *p)
 {
 	struct probe_data_packet *temp_packet;
@@ -238,6 +368,7 @@ struct dma_frame_parser *parser_init(void)
 
 void parser_free(struct dma_frame_parser *p)
 {
+	free(p->unpacked);
 	free(p->packet);
 	free(p);
 }
@@ -247,12 +378,46 @@ void parser_log_to_stdout(struct dma_frame_parser *p)
 	p->log_to_stdout = true;
 }
 
+void parser_stream_to_stdout(struct dma_frame_parser *p, uint32_t buffer_id)
+{
+	p->stream_to_stdout = true;
+	p->stream_buffer_id = buffer_id;
+}
+
 void parser_fetch_free_buffer(struct dma_frame_parser *p, uint8_t **d, size_t *len)
 {
 	*d = &p->data[p->start];
 	*len = sizeof(p->data) - p->start;
 }
 
+/*
+ * Index of the next sync word in data[i..len), or of the last bytes too
+ * short to hold one. Logging packets have any length, so the sync word
+ * may be at any byte offset: memchr() finds its first byte a word or more
+ * at a time and only those candidates are compared.
+ */
+static uint find_sync(const uint8_t *data, uint i, uint len)
+{
+	const uint32_t sync = PROBE_EXTRACT_SYNC_WORD;
+	const uint8_t *first = (const uint8_t *)&sync;
+	const uint8_t *d;
+	uint32_t word;
+
+	while (len - i >= sizeof(sync)) {
+		d = memchr(&data[i], *first, len - i - sizeof(sync) + 1);
+		if (!d)
+			return len - sizeof(sync) + 1;
+
+		memcpy(&word, d, sizeof(word));
+		if (word == sync)
+			return d - data;
+
+		i = d - data + 1;
+	}
+
+	return i;
+}
+
 int parser_parse_data(struct dma_frame_parser *p, size_t d_len)
 {
 	uint i = 0;
@@ -278,7 +443,7 @@ int parser_parse_data(struct dma_frame_parser *p, size_t d_len)
 					p->state = SYNC;
 					p->start = 0;
 				} else {
-					i++;
+					i = find_sync(p->data, i + 1, p->len);
 				}
 				break;
 			case SYNC:
@@ -293,25 +458,11 @@ int parser_parse_data(struct dma_frame_parser *p, size_t d_len)
 				/* CHECK -> READY */
 				/* find corresponding file and save data if valid */
 				if (validate_data_packet(p->packet) == 0) {
-					int file = get_buffer_file(p->files,
-								   p->packet->buffer_id);
-
-					if (file < 0)
-						file = init_wave(p, p->packet->buffer_id,
-								 p->packet->format);
-
-					if (file < 0) {
-						fprintf(stderr,
-							"unable to open file for %u\n",
-							p->packet->buffer_id);
-						return -EIO;
-					}
-
-					fwrite(p->packet->data, 1,
-					       p->packet->data_size_bytes,
-					       p->files[file].fd);
-					p->files[file].size += p->packet->data_size_bytes;
-					}
+					int ret = write_packet(p);
+
+					if (ret < 0)
+						return ret;
+				}
 				p->state = READY;
 				break;
 			}
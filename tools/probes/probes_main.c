@@ -11,6 +11,10 @@
  *
  * Usage to parse data and create wave files: ./sof-probes -p data.bin
  *
+ * Usage to play a probe point live: ./sof-probes -s 7 | aplay
+ * or, with an output FIFO: mkfifo buffer_7.wav; aplay buffer_7.wav &
+ * ./sof-probes
+ *
  */
 
 #include <errno.h>
@@ -30,17 +34,19 @@ static void usage(void)
 	fprintf(stdout, "Usage %s <option(s)> <buffer_id/file>\n\n", APP_NAME);
 	fprintf(stdout, "%s:\t -p file\tParse extracted file\n\n", APP_NAME);
 	fprintf(stdout, "%s:\t -l \t\tLog to stdout\n\n", APP_NAME);
+	fprintf(stdout, "%s:\t -s buffer_id\tStream audio of buffer_id to stdout\n\n",
+		APP_NAME);
 	fprintf(stdout, "%s:\t -h \t\tHelp, usage info\n", APP_NAME);
 	exit(0);
 }
 
-void parse_data(const char *file_in, bool log_to_stdout)
+void parse_data(const char *file_in, bool log_to_stdout, int stream_buffer_id)
 {
 	struct dma_frame_parser *p = parser_init();
 	FILE *fd_in;
 	uint8_t *data;
+	ssize_t bytes;
 	size_t len;
-	int ret;
 
 	if (!p) {
 		fprintf(stderr, "parser_init() failed\n");
@@ -50,6 +56,9 @@ void parse_data(const char *file_in, bool log_to_stdout)
 	if (log_to_stdout)
 		parser_log_to_stdout(p);
 
+	if (stream_buffer_id >= 0)
+		parser_stream_to_stdout(p, stream_buffer_id);
+
 	if (file_in) {
 		fd_in = fopen(file_in, "rb");
 		if (!fd_in) {
@@ -61,14 +70,23 @@ void parse_data(const char *file_in, bool log_to_stdout)
 		fd_in = stdin;
 	}
 
-	do {
+	/* read() returns what a live stream has, fread() would wait for len */
+	for (;;) {
 		parser_fetch_free_buffer(p, &data, &len);
-		len = fread(data, 1, len, fd_in);
-		ret = parser_parse_data(p, len);
-	} while (!ret && !feof(fd_in));
+		bytes = read(fileno(fd_in), data, len);
+		if (bytes < 0) {
+			if (errno == EINTR)
+				continue;
+			fprintf(stderr, "error: read failed, error %d\n", errno);
+			break;
+		}
+
+		/* stop at the end of the input or on a parse error */
+		if (!bytes || parser_parse_data(p, bytes))
+			break;
+	}
 
-	if (!log_to_stdout)
-		finalize_wave_files(p);
+	finalize_wave_files(p);
 
 }
 
@@ -76,9 +94,10 @@ int main(int argc, char *argv[])
 {
 	const char *fname = NULL;
 	bool log_to_stdout = false;
+	int stream_buffer_id = -1;
 	int opt;
 
-	while ((opt = getopt(argc, argv, "lhp:")) != -1) {
+	while ((opt = getopt(argc, argv, "lhp:s:")) != -1) {
 		switch (opt) {
 		case 'p':
 			fname = optarg;
@@ -86,13 +105,21 @@ int main(int argc, char *argv[])
 		case 'l':
 			log_to_stdout = true;
 			break;
+		case 's':
+			stream_buffer_id = atoi(optarg);
+			break;
 		case 'h':
 		default:
 			usage();
 			return 0;
 		}
 	}
-	parse_data(fname, log_to_stdout);
+	if (log_to_stdout && stream_buffer_id >= 0) {
+		fprintf(stderr, "error: -l and -s both write to stdout\n");
+		return 1;
+	}
+
+	parse_data(fname, log_to_stdout, stream_buffer_id);
 
 	return 0;
 }
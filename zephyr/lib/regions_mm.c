@@ -9,6 +9,7 @@
 
 #if defined(CONFIG_MM_DRV)
 #include <sof/lib/regions_mm.h>
+#include <sof/llext_manager.h>
 
 
 /** @struct vmh_heap
@@ -341,14 +342,21 @@ static int vmh_map_region(const struct sys_mm_drv_region *virtual_region,
 		if (!vmh_get_map_region_boundaries(region, ptr, size, &begin, &size))
 			return 0;
 	}
-	ret = sys_mm_drv_map_region_safe(virtual_region, UINT_TO_POINTER(begin), 0, size,
-					 SYS_MM_MEM_PERM_RW);
+	for (;;) {
+		ret = sys_mm_drv_map_region_safe(virtual_region, UINT_TO_POINTER(begin), 0, size,
+						 SYS_MM_MEM_PERM_RW);
+		if (!ret)
+			return 0;
 
-	/* In case of an error, the pages that were successfully mapped must be manually released */
-	if (ret)
+		/* In case of an error, the pages that were successfully mapped must be manually
+		 * released
+		 */
 		sys_mm_drv_unmap_region(UINT_TO_POINTER(begin), size);
 
-	return ret;
+		/* Out of physical pages, take them back from unused LLEXT modules */
+		if (!llext_manager_cache_reclaim())
+			return ret;
+	}
 }
 
 /**
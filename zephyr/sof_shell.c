@@ -8,6 +8,7 @@
 #include <rtos/sof.h> /* sof_get() */
 #include <sof/schedule/ll_schedule_domain.h>
 #include <sof/audio/module_adapter/module/generic.h>
+#include <sof/llext_manager.h>
 
 #include <zephyr/kernel.h>
 #include <zephyr/sys/printk.h>
@@ -68,6 +69,31 @@ static int cmd_sof_module_heap_usage(const struct shell *sh,
 	return 0;
 }
 
+#if CONFIG_LLEXT
+static void llext_stats_print(const struct shell *sh, const char *op,
+			      uint32_t count, uint64_t cycles)
+{
+	shell_print(sh, "%-6s%9u times%12llu cycles%9llu avg", op, count,
+		    (unsigned long long)cycles,
+		    (unsigned long long)(count ? cycles / count : 0));
+}
+
+static int cmd_sof_llext_stats(const struct shell *sh,
+			       size_t argc, char *argv[])
+{
+	struct llext_manager_stats stats;
+
+	llext_manager_get_stats(&stats);
+
+	llext_stats_print(sh, "link", stats.link_count, stats.link_cycles);
+	llext_stats_print(sh, "load", stats.load_count, stats.load_cycles);
+	llext_stats_print(sh, "unmap", stats.unmap_count, stats.unmap_cycles);
+	shell_print(sh, "cache %9u hits%9u evictions", stats.cache_hits, stats.evictions);
+
+	return 0;
+}
+#endif
+
 SHELL_STATIC_SUBCMD_SET_CREATE(sof_commands,
 	SHELL_CMD(test_inject_sched_gap, NULL,
 		  "Inject a gap to audio scheduling\n",
@@ -77,6 +103,10 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sof_commands,
 		  "Print heap memory usage of each module\n",
 		  cmd_sof_module_heap_usage),
 
+	SHELL_COND_CMD(CONFIG_LLEXT, llext_stats, NULL,
+		       "Print LLEXT module link, load and unmap costs\n",
+		       cmd_sof_llext_stats),
+
 	SHELL_SUBCMD_SET_END
 );
 
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/*
+ * Copyright(c) 2026 Intel Corporation. All rights reserved.
+ */
+
+#include <rtos/task.h>
+#include <sof/boot_test.h>
+#include <sof/lib/cpu.h>
+#include <sof/lib/uuid.h>
+#include <sof/schedule/ll_schedule.h>
+#include <sof/schedule/ll_schedule_domain.h>
+#include <sof/schedule/schedule.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/ztest.h>
+
+LOG_MODULE_DECLARE(sof_boot_test, CONFIG_SOF_LOG_LEVEL);
+
+SOF_DEFINE_REG_UUID(ll_sched_test);
+
+/* task period in LL ticks and number of ticks each round runs for */
+#define LL_TEST_PERIOD_TICKS	4
+#define LL_TEST_RUN_TICKS	40
+
+static atomic_t ll_test_runs;
+
+static enum task_state ll_test_run(void *data)
+{
+	atomic_inc(&ll_test_runs);
+
+	return SOF_TASK_STATE_RESCHEDULE;
+}
+
+/* Runs a 4 tick task alone on the scheduler and returns its run count */
+static int ll_test_round(struct task *task)
+{
+	int ret;
+
+	ret = schedule_task_init_ll(task, SOF_UUID(ll_sched_test_uuid), SOF_SCHEDULE_LL_TIMER,
+				    0, ll_test_run, NULL, cpu_get_id(), 0);
+	zassert_ok(ret, "LL task init failed");
+
+	atomic_set(&ll_test_runs, 0);
+
+	ret = schedule_task(task, 0, LL_TEST_PERIOD_TICKS * LL_TIMER_PERIOD_US);
+	zassert_ok(ret, "LL task schedule failed");
+
+	k_usleep(LL_TEST_RUN_TICKS * LL_TIMER_PERIOD_US);
+
+	schedule_task_cancel(task);
+	schedule_task_free(task);
+
+	return atomic_get(&ll_test_runs);
+}
+
+/*
+ * Once the last task is gone the LL thread is stopped. A task scheduled after
+ * that must still only run on its own period and not on every tick.
+ */
+ZTEST(sof_boot, ll_multi_rate_reschedule)
+{
+	struct task task = { 0 };
+	int max_runs = LL_TEST_RUN_TICKS / LL_TEST_PERIOD_TICKS + 2;
+	int runs;
+
+	runs = ll_test_round(&task);
+	zassert_true(runs > 0 && runs <= max_runs, "first round ran %d times", runs);
+
+	runs = ll_test_round(&task);
+	zassert_true(runs > 0 && runs <= max_runs, "second round ran %d times", runs);
+
+	TEST_CHECK_RET(0, "ll_multi_rate_reschedule");
+}